@@ -0,0 +1,149 @@
+#ifndef AGGREGATE_INDEX_HPP
+#define AGGREGATE_INDEX_HPP
+
+#include <iostream> // std
+#include <vector>   // vector
+#include <complex>  // complex numbers
+#include <cmath>    // sqrt
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* ACCUMULATOR TYPES FOR SUMS OF MEASUREMENTS
+* -----------------------------------------------------------------------*/
+
+// Sums are accumulated relative to a pivot value close to the data, which
+// keeps prefix sums of squares small enough for differences of two prefix
+// sums to stay accurate in floating point.
+template <typename T> struct AggregateTraits {
+    using SumType = T;
+    // pivot subtracted from every value before summing
+    static SumType getPivot(const T& firstValue) { return firstValue; }
+    // divide sums, as T would
+    static T divide(const SumType& a, const SumType& b) { return a / b; }
+};
+
+// integer sums are exact, so no pivot is needed, but they need a wider type
+template <> struct AggregateTraits<int> {
+    using SumType = long long;
+    static SumType getPivot(const int&) { return 0; }
+    // divide in the wide type, only the quotient fits an int; avoid
+    // crashing on projects with fewer than two measurements
+    static int divide(const SumType& a, const SumType& b) { return b == 0 ? 0 : static_cast<int>(a / b); }
+};
+
+/* ------------------------------------------------------------------------
+* AGGREGATE OF A WINDOW OF MEASUREMENTS
+* -----------------------------------------------------------------------*/
+
+template <typename T> struct Aggregate {
+    using SumType = typename AggregateTraits<T>::SumType;
+    std::size_t count;
+    SumType pivot;
+    // sum of (value - pivot) and sum of (value - pivot)^2
+    SumType sum;
+    SumType sumOfSquares;
+
+    // default constructor - empty aggregate
+    Aggregate() : count{}, pivot{}, sum{}, sumOfSquares{} {}
+
+    // parametrised constructor - empty aggregate with given pivot
+    Aggregate(const SumType& userPivot) : count{}, pivot(userPivot), sum{}, sumOfSquares{} {}
+
+    // add one value
+    void add(const T& value) {
+        SumType shifted = (SumType)value - this->pivot;
+        ++this->count;
+        this->sum += shifted;
+        this->sumOfSquares += shifted * shifted;
+    }
+
+    // add aggregate with the same pivot
+    Aggregate& operator+=(const Aggregate& otherAggregate) {
+        this->count += otherAggregate.count;
+        this->sum += otherAggregate.sum;
+        this->sumOfSquares += otherAggregate.sumOfSquares;
+        return *this;
+    }
+
+    // compute mean of data
+    T getMean() const {
+        // mean of shifted values is computed as T would, then shifted back
+        T shiftedMean = AggregateTraits<T>::divide(this->sum, (SumType)this->count);
+        return (T)(shiftedMean + this->pivot);
+    }
+
+    // compute standard deviation
+    T getStandardDeviation() const {
+        // sum of (value - mean)^2 from shifted sums, exact for integers
+        SumType delta = (SumType)this->getMean() - this->pivot;
+        SumType n = (SumType)this->count;
+        SumType sumOfDeviations = this->sumOfSquares - (SumType)2 * delta * this->sum + n * delta * delta;
+        T sumOverCount = AggregateTraits<T>::divide(sumOfDeviations, (SumType)(this->count - 1));
+        // cast to T, as returns double, but if T is int, then we want int!
+        T standardDeviation = (T)std::sqrt(sumOverCount);
+        return standardDeviation;
+    }
+
+    // compute error in mean
+    T getErrorInMean() const {
+        T measurementCount = this->count;
+        // cast to T, as returns double, but if T is int, then we want int!
+        T standardError = (T)(this->getStandardDeviation() / std::sqrt(measurementCount));
+        return standardError;
+    }
+};
+
+/* ------------------------------------------------------------------------
+* AGGREGATE INDEX CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// Prefix sums of the aggregates of consecutive parts of a time series, i.e.
+// its blocks. The aggregate of any run of blocks [first, last) is one
+// subtraction of prefix sums, so a time window only scans its two
+// boundary blocks.
+template <typename T> class AggregateIndex {
+private:
+    using SumType = typename AggregateTraits<T>::SumType;
+    SumType pivot;
+    // prefix sums, element i covers the first i blocks
+    std::vector<std::size_t> prefixCount;
+    std::vector<SumType> prefixSum;
+    std::vector<SumType> prefixSumOfSquares;
+
+public:
+    // default constructor - empty index, allocates nothing until built
+    AggregateIndex() : pivot{} {}
+
+    // build prefix sums over aggregates sharing one pivot
+    void build(const std::vector<Aggregate<T>>& aggregates, const SumType& userPivot) {
+        std::size_t size{aggregates.size()};
+        pivot = userPivot;
+        prefixCount.assign(size + 1, 0);
+        prefixSum.assign(size + 1, SumType{});
+        prefixSumOfSquares.assign(size + 1, SumType{});
+        for (std::size_t i{}; i < size; ++i) {
+            prefixCount[i + 1] = prefixCount[i] + aggregates[i].count;
+            prefixSum[i + 1] = prefixSum[i] + aggregates[i].sum;
+            prefixSumOfSquares[i + 1] = prefixSumOfSquares[i] + aggregates[i].sumOfSquares;
+        }
+    }
+
+    // aggregate of blocks [first, last)
+    Aggregate<T> getAggregate(const std::size_t& first, const std::size_t& last) const {
+        Aggregate<T> aggregate(pivot);
+        if (first >= last) return aggregate;
+        aggregate.count = prefixCount[last] - prefixCount[first];
+        aggregate.sum = prefixSum[last] - prefixSum[first];
+        aggregate.sumOfSquares = prefixSumOfSquares[last] - prefixSumOfSquares[first];
+        return aggregate;
+    }
+
+    // approximate heap memory held by the index in bytes
+    std::size_t getMemoryUsage() const {
+        return prefixCount.capacity() * sizeof(std::size_t)
+             + (prefixSum.capacity() + prefixSumOfSquares.capacity()) * sizeof(SumType);
+    }
+};
+
+#endif /* AGGREGATE_INDEX_HPP */
@@ -0,0 +1,90 @@
+#include <sstream> // stringstream
+#include <new>     // operator new
+
+#include "arena.hpp" // pooled memory of one dataset
+
+/* ------------------------------------------------------------------------
+* DEFINE ARENA CLASS
+* -----------------------------------------------------------------------*/
+
+// parametrised constructor
+Arena::Arena(const std::size_t& userChunkBytes)
+            : chunkBytes{userChunkBytes}, cursor{nullptr}, chunkEnd{nullptr},
+              noOfAllocations{}, noOfHeapAllocations{}, bytesInUse{}, largeBytesInUse{} {
+    DebugMsg::print("[ARENA] Parametrised constructor called\n");
+    for (std::size_t i{}; i < noOfSizeClasses; ++i) freeLists[i] = nullptr;
+}
+
+// destructor - one free per chunk, however many objects were allocated
+Arena::~Arena() {
+    DebugMsg::print("[ARENA] Destructor called\n");
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) ::operator delete(*it);
+}
+
+// index of the size class holding at least noOfBytes
+std::size_t Arena::getSizeClass(const std::size_t& noOfBytes) {
+    std::size_t sizeClass{};
+    std::size_t classBytes{smallestClassBytes};
+    while (classBytes < noOfBytes) {
+        classBytes <<= 1;
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+// return memory for noOfBytes
+void* Arena::allocate(const std::size_t& noOfBytes) {
+    ++noOfAllocations;
+    std::size_t sizeClass{getSizeClass(noOfBytes)};
+    if (sizeClass >= noOfSizeClasses) {
+        // too large to pool
+        ++noOfHeapAllocations;
+        largeBytesInUse += noOfBytes;
+        return ::operator new(noOfBytes);
+    }
+    std::size_t classBytes{smallestClassBytes << sizeClass};
+    bytesInUse += classBytes;
+    // reuse released memory of the same size class
+    if (freeLists[sizeClass]) {
+        void* pointer{freeLists[sizeClass]};
+        freeLists[sizeClass] = *static_cast<void**>(pointer);
+        return pointer;
+    }
+    // carve from the newest chunk, starting a new one when it is used up;
+    // the rest of the old chunk is left unused
+    if (cursor == nullptr || static_cast<std::size_t>(chunkEnd - cursor) < classBytes) {
+        ++noOfHeapAllocations;
+        cursor = static_cast<char*>(::operator new(chunkBytes));
+        chunkEnd = cursor + chunkBytes;
+        chunks.push_back(cursor);
+    }
+    void* pointer{cursor};
+    cursor += classBytes;
+    return pointer;
+}
+
+// release memory for reuse
+void Arena::deallocate(void* pointer, const std::size_t& noOfBytes) {
+    if (pointer == nullptr) return;
+    std::size_t sizeClass{getSizeClass(noOfBytes)};
+    if (sizeClass >= noOfSizeClasses) {
+        largeBytesInUse -= noOfBytes;
+        ::operator delete(pointer);
+        return;
+    }
+    bytesInUse -= smallestClassBytes << sizeClass;
+    *static_cast<void**>(pointer) = freeLists[sizeClass];
+    freeLists[sizeClass] = pointer;
+}
+
+// return arena statistics table
+std::string Arena::show() const {
+    std::ostringstream stringStream;
+    stringStream
+        << "Arena chunks: "      << this->getNoOfChunks()         << std::endl
+        << "Arena reserved: "    << this->getBytesReserved()      << " bytes" << std::endl
+        << "Arena in use: "      << this->getBytesInUse()         << " bytes" << std::endl
+        << "Arena allocations: " << this->getNoOfAllocations()
+        << " (" << this->getNoOfHeapAllocations() << " from heap)" << std::endl;
+    return stringStream.str();
+}
@@ -0,0 +1,125 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <iostream>    // std
+#include <vector>      // vector
+#include <memory>      // shared_ptr
+#include <string>      // string
+#include <cstddef>     // size_t
+#include <type_traits> // true_type
+
+#include "msg.hpp" // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* ARENA CLASS: POOLED MEMORY OF ONE DATASET
+* -----------------------------------------------------------------------*/
+
+// Hands out memory carved from large chunks. Released memory goes to a free
+// list of its power-of-two size class and is reused by the next request of
+// that class, so reading file after file into a DataManager reuses the same
+// memory instead of calling malloc for every measurement column and map
+// node. Requests larger than the biggest size class go straight to the
+// heap. All chunks are freed together when the arena is destroyed.
+// Not thread-safe: only the thread changing the dataset allocates.
+class Arena {
+private:
+    // size classes 16 bytes, 32 bytes, ..., 16 KB
+    static const std::size_t noOfSizeClasses = 11;
+    static const std::size_t smallestClassBytes = 16;
+    std::size_t chunkBytes;
+    std::vector<char*> chunks;
+    // unused end of the newest chunk
+    char* cursor;
+    char* chunkEnd;
+    // singly linked lists of released memory, one per size class
+    void* freeLists[noOfSizeClasses];
+    // statistics
+    std::size_t noOfAllocations;
+    std::size_t noOfHeapAllocations;
+    std::size_t bytesInUse;
+    std::size_t largeBytesInUse;
+
+    // index of the size class holding at least noOfBytes
+    static std::size_t getSizeClass(const std::size_t& noOfBytes);
+
+public:
+    // parametrised constructor
+    Arena(const std::size_t& userChunkBytes = 256 * 1024);
+    // arena owns its chunks, so it is neither copied nor moved
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    // destructor, frees all chunks
+    ~Arena();
+
+    // return memory for noOfBytes, aligned for any fundamental type
+    void* allocate(const std::size_t& noOfBytes);
+    // release memory returned by allocate with the same noOfBytes
+    void deallocate(void* pointer, const std::size_t& noOfBytes);
+
+    // access functions
+    std::size_t getNoOfChunks() const { return this->chunks.size(); }
+    std::size_t getNoOfAllocations() const { return this->noOfAllocations; }
+    std::size_t getNoOfHeapAllocations() const { return this->noOfHeapAllocations; }
+    std::size_t getBytesInUse() const { return this->bytesInUse + this->largeBytesInUse; }
+    std::size_t getBytesReserved() const { return this->chunks.size() * this->chunkBytes + this->largeBytesInUse; }
+
+    // return arena statistics table
+    std::string show() const;
+};
+
+/* ------------------------------------------------------------------------
+* ALLOCATOR FOR STANDARD CONTAINERS USING AN ARENA
+* -----------------------------------------------------------------------*/
+
+// Standard allocator taking memory from a shared arena, or from the heap
+// when it has none. Containers keep the arena alive, so data can safely
+// outlive the DataManager that created the arena.
+template <typename U> class ArenaAllocator {
+private:
+    std::shared_ptr<Arena> arena;
+
+public:
+    using value_type = U;
+    template <typename V> struct rebind { using other = ArenaAllocator<V>; };
+    // moved and swapped containers take their arena with them, so their
+    // memory is always released to the arena it came from
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // default constructor - heap allocator
+    ArenaAllocator() {}
+
+    // parametrised constructor
+    ArenaAllocator(const std::shared_ptr<Arena>& userArena) : arena{userArena} {}
+
+    // converting constructor used by containers for their nodes
+    template <typename V> ArenaAllocator(const ArenaAllocator<V>& otherAllocator)
+        : arena{otherAllocator.getArena()} {}
+
+    // access function
+    const std::shared_ptr<Arena>& getArena() const { return this->arena; }
+
+    U* allocate(std::size_t n) {
+        if (arena) return static_cast<U*>(arena->allocate(n * sizeof(U)));
+        return static_cast<U*>(::operator new(n * sizeof(U)));
+    }
+
+    void deallocate(U* pointer, std::size_t n) {
+        if (arena) arena->deallocate(pointer, n * sizeof(U));
+        else ::operator delete(pointer);
+    }
+
+    // allocators are equal if memory from one can be released by the other
+    template <typename V> bool operator==(const ArenaAllocator<V>& otherAllocator) const {
+        return this->arena == otherAllocator.getArena();
+    }
+    template <typename V> bool operator!=(const ArenaAllocator<V>& otherAllocator) const {
+        return !(*this == otherAllocator);
+    }
+};
+
+// vector whose memory comes from an arena, or from the heap by default
+template <typename U>
+using ArenaVector = std::vector<U, ArenaAllocator<U>>;
+
+#endif /* ARENA_HPP */
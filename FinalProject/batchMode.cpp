@@ -0,0 +1,491 @@
+#include <sstream>   // stringstream
+#include <algorithm> // transform
+#include <exception> // exceptions
+#include <stdexcept> // invalid_argument
+#include <memory>    // unique_ptr
+
+#include "batchMode.hpp" // running DataHero without prompts
+#include "trace.hpp"     // hot path tracing
+#include "metrics.hpp"   // operational metrics
+
+/* ------------------------------------------------------------------------
+* HELPER FUNCTIONS FOR PARSING COMMAND LINE
+* -----------------------------------------------------------------------*/
+
+// return copy of string in upper case letters
+std::string BatchMode::toUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+    return text;
+}
+
+// split text at every separator
+std::vector<std::string> BatchMode::split(const std::string& text, const char& separator) {
+    std::vector<std::string> parts;
+    std::istringstream stringStream(text);
+    std::string part;
+    while (std::getline(stringStream, part, separator)) parts.push_back(part);
+    // keep trailing empty part, e.g. "A:" has two parts
+    if (!text.empty() && text[text.size() - 1] == separator) parts.push_back("");
+    return parts;
+}
+
+// read unsigned timestamp from text
+unsigned BatchMode::toTimestamp(const std::string& text) {
+    std::istringstream stringStream(text);
+    unsigned timestamp{};
+    if (text.empty() || text[0] == '-' || !(stringStream >> timestamp) || !stringStream.eof()) {
+        throw std::invalid_argument("[BATCH] Timestamp '" + text + "' is not valid\n");
+    }
+    return timestamp;
+}
+
+// read STAFF:PROJECT selection, <all> alone selects everything
+void BatchMode::parseSelection(const std::string& text, BatchOperation& operation, bool allowAll) {
+    std::vector<std::string> parts{split(text, ':')};
+    if (parts.size() == 1 && toUpper(parts[0]) == "ALL" && allowAll) {
+        operation.staffName = "ALL";
+        operation.projectName = "ALL";
+        return;
+    }
+    if (parts.size() != 2 || parts[0].empty() || parts[1].empty()) {
+        throw std::invalid_argument("[BATCH] Selection '" + text + "' should be STAFF:PROJECT\n");
+    }
+    operation.staffName = toUpper(parts[0]);
+    operation.projectName = toUpper(parts[1]);
+    if (!allowAll && (operation.staffName == "ALL" || operation.projectName == "ALL")) {
+        throw std::invalid_argument("[BATCH] Selection '" + text + "' must name one project\n");
+    }
+}
+
+// read START:END timestamp range
+TimeRange BatchMode::parseRange(const std::string& text) {
+    std::vector<std::string> parts{split(text, ':')};
+    if (parts.size() != 2) {
+        throw std::invalid_argument("[BATCH] Range '" + text + "' should be START:END\n");
+    }
+    return TimeRange{toTimestamp(parts[0]), toTimestamp(parts[1])};
+}
+
+// read number of threads, 1 to EpochManager::maxReaders
+unsigned BatchMode::toThreadCount(const std::string& text) {
+    std::istringstream stringStream(text);
+    unsigned noOfThreads{};
+    if (text.empty() || text[0] == '-' || !(stringStream >> noOfThreads) || !stringStream.eof()
+        || noOfThreads < 1 || noOfThreads > EpochManager::maxReaders) {
+        throw std::invalid_argument("[BATCH] Number of threads '" + text + "' should be 1 to "
+                                    + std::to_string(EpochManager::maxReaders) + "\n");
+    }
+    return noOfThreads;
+}
+
+// read positive count of an option, e.g. number of files
+unsigned BatchMode::toCount(const std::string& text, const std::string& option) {
+    unsigned count{toNumber<unsigned>(text, option)};
+    if (count == 0) throw std::invalid_argument("[BATCH] " + option + " '" + text + "' should be positive\n");
+    return count;
+}
+
+// read real number of an option, which may be negative
+double BatchMode::toReal(const std::string& text, const std::string& option) {
+    std::istringstream stringStream(text);
+    double number{};
+    if (text.empty() || !(stringStream >> number) || !stringStream.eof()) {
+        throw std::invalid_argument("[BATCH] " + option + " '" + text + "' is not valid\n");
+    }
+    return number;
+}
+
+// return value following an option
+std::string BatchMode::getValue(int argc, char* argv[], int& i) {
+    if (i + 1 >= argc) {
+        throw std::invalid_argument("[BATCH] Option '" + std::string(argv[i]) + "' needs a value\n");
+    }
+    return argv[++i];
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE BATCH MODE CLASS
+* -----------------------------------------------------------------------*/
+
+// parse command line
+BatchOptions BatchMode::parseArguments(int argc, char* argv[]) {
+    BatchOptions options{"", "", false, false, false, 0, 0, std::vector<BatchOperation>{}, false, SimulationConfig(),
+                         false, "", "", 0, 0};
+    for (int i{1}; i < argc; ++i) {
+        std::string option{argv[i]};
+        BatchOperation operation;
+        if (option == "--help" || option == "-h") {
+            options.help = true;
+        } else if (option == "--debug") {
+            options.debug = true;
+        } else if (option == "--type") {
+            options.dataType = toUpper(getValue(argc, argv, i));
+            if (options.dataType != "DOUBLE" && options.dataType != "INT"
+                && options.dataType != "COMPLEXDOUBLE" && options.dataType != "AUTO") {
+                throw std::invalid_argument("[BATCH] Data type '" + options.dataType + "' not supported\n");
+            }
+        } else if (option == "--input") {
+            options.dataPath = getValue(argc, argv, i);
+        } else if (option == "--trace") {
+            options.traceFile = getValue(argc, argv, i);
+        } else if (option == "--metrics") {
+            options.metricsFile = getValue(argc, argv, i);
+        } else if (option == "--metrics-interval") {
+            options.metricsInterval = toCount(getValue(argc, argv, i), "Metrics interval");
+        } else if (option == "--metrics-port") {
+            options.metricsPort = toCount(getValue(argc, argv, i), "Metrics port");
+            if (options.metricsPort > 65535) throw std::invalid_argument("[BATCH] Metrics port should be below 65536\n");
+        } else if (option == "--compress") {
+            options.compress = true;
+        } else if (option == "--producers") {
+            options.producers = toThreadCount(getValue(argc, argv, i));
+        } else if (option == "--shards") {
+            options.noOfShards = toCount(getValue(argc, argv, i), "Number of shards");
+        } else if (option == "--generate") {
+            options.generate = true;
+            options.simulation.outputPath = getValue(argc, argv, i);
+        } else if (option == "--staff-count") {
+            options.simulation.noOfStaff = toCount(getValue(argc, argv, i), "Staff count");
+        } else if (option == "--project-count") {
+            options.simulation.noOfProjects = toCount(getValue(argc, argv, i), "Project count");
+        } else if (option == "--file-count") {
+            options.simulation.noOfFiles = toCount(getValue(argc, argv, i), "File count");
+        } else if (option == "--points") {
+            // N or MIN:MAX measurements per file
+            std::vector<std::string> parts{split(getValue(argc, argv, i), ':')};
+            if (parts.size() > 2) throw std::invalid_argument("[BATCH] --points should be N or MIN:MAX\n");
+            options.simulation.minPoints = toCount(parts[0], "Points");
+            options.simulation.maxPoints = toCount(parts.back(), "Points");
+            if (options.simulation.minPoints > options.simulation.maxPoints) {
+                throw std::invalid_argument("[BATCH] --points MIN should not exceed MAX\n");
+            }
+        } else if (option == "--rate") {
+            options.simulation.pointsPerSecond = toNumber<double>(getValue(argc, argv, i), "Rate");
+        } else if (option == "--seed") {
+            options.simulation.seed = toNumber<std::uint64_t>(getValue(argc, argv, i), "Seed");
+        } else if (option == "--start") {
+            options.simulation.startTime = toTimestamp(getValue(argc, argv, i));
+        } else if (option == "--profile") {
+            // options after the profile change it
+            options.simulation.profile = WorkloadProfile::get(getValue(argc, argv, i));
+        } else if (option == "--zipf") {
+            options.simulation.profile.zipfExponent = toNumber<double>(getValue(argc, argv, i), "Zipf exponent");
+        } else if (option == "--giant" || option == "--disorder") {
+            // SHARE:FACTOR or SHARE:LENGTH
+            std::vector<std::string> parts{split(getValue(argc, argv, i), ':')};
+            if (parts.size() != 2) throw std::invalid_argument("[BATCH] " + option + " should be SHARE:N\n");
+            double share{toNumber<double>(parts[0], "Share")};
+            unsigned count{toCount(parts[1], option == "--giant" ? "Giant factor" : "Burst length")};
+            if (option == "--giant") {
+                options.simulation.profile.giantShare = share;
+                options.simulation.profile.giantFactor = count;
+            } else {
+                options.simulation.profile.disorderShare = share;
+                options.simulation.profile.burstLength = count;
+            }
+        } else if (option == "--duplicates") {
+            options.simulation.profile.duplicateShare = toNumber<double>(getValue(argc, argv, i), "Share");
+        } else if (option == "--values") {
+            // DIST or DIST:LOW:HIGH
+            std::vector<std::string> parts{split(getValue(argc, argv, i), ':')};
+            if (parts.size() != 1 && parts.size() != 3) {
+                throw std::invalid_argument("[BATCH] --values should be DIST or DIST:LOW:HIGH\n");
+            }
+            options.simulation.profile.values = WorkloadProfile::getValueDistribution(parts[0]);
+            if (parts.size() == 3) {
+                options.simulation.profile.valueLow = toReal(parts[1], "Value");
+                options.simulation.profile.valueHigh = toReal(parts[2], "Value");
+            }
+        } else if (option == "--in-memory") {
+            options.inMemory = true;
+        } else if (option == "--generate-threads") {
+            options.simulation.noOfThreads = toThreadCount(getValue(argc, argv, i));
+        } else if (option == "--binary") {
+            options.simulation.format = SimulationFormat::BINARY;
+        } else if (option == "--staff" || option == "--project" || option == "--cache"
+                   || option == "--storage" || option == "--memory" || option == "--freeze"
+                   || option == "--ingest") {
+            operation.command = toUpper(option.substr(2));
+            options.operations.push_back(operation);
+        } else if (option == "--read-bench" || option == "--insert-bench") {
+            operation.command = toUpper(option.substr(2));
+            operation.noOfThreads = toThreadCount(getValue(argc, argv, i));
+            options.operations.push_back(operation);
+        } else if (option == "--report" || option == "--data") {
+            operation.command = toUpper(option.substr(2));
+            parseSelection(getValue(argc, argv, i), operation, true);
+            options.operations.push_back(operation);
+        } else if (option == "--del") {
+            operation.command = "DEL";
+            parseSelection(getValue(argc, argv, i), operation, false);
+            options.operations.push_back(operation);
+        } else if (option == "--del-val") {
+            // STAFF:PROJECT:START:END
+            operation.command = "DEL-VAL";
+            std::vector<std::string> parts{split(getValue(argc, argv, i), ':')};
+            if (parts.size() != 4) {
+                throw std::invalid_argument("[BATCH] --del-val needs STAFF:PROJECT:START:END\n");
+            }
+            parseSelection(parts[0] + ":" + parts[1], operation, false);
+            operation.range = parseRange(parts[2] + ":" + parts[3]);
+            options.operations.push_back(operation);
+        } else if (option == "--range") {
+            // restricts the preceding report or data output
+            if (options.operations.empty() || (options.operations.back().command != "REPORT"
+                && options.operations.back().command != "DATA")) {
+                throw std::invalid_argument("[BATCH] --range must follow --report or --data\n");
+            }
+            options.operations.back().range = parseRange(getValue(argc, argv, i));
+        } else if (option == "--out") {
+            // redirects output of the preceding operation
+            if (options.operations.empty()) {
+                throw std::invalid_argument("[BATCH] --out must follow an operation\n");
+            }
+            options.operations.back().outFile = getValue(argc, argv, i);
+        } else {
+            throw std::invalid_argument("[BATCH] Option '" + option + "' not recognised\n");
+        }
+    }
+    if (options.help) return options;
+    if (options.metricsInterval > 0 && options.metricsFile.empty()) {
+        throw std::invalid_argument("[BATCH] --metrics-interval needs --metrics\n");
+    }
+    if (options.dataType.empty()) throw std::invalid_argument("[BATCH] --type is required\n");
+    if (options.generate || options.inMemory) {
+        options.simulation.dataType = options.dataType;
+        std::transform(options.simulation.dataType.begin(), options.simulation.dataType.end(),
+                       options.simulation.dataType.begin(), ::tolower);
+    }
+    if (options.inMemory) {
+        if (!options.dataPath.empty() || options.producers > 0) {
+            throw std::invalid_argument("[BATCH] --in-memory reads no files, --input and --producers do not apply\n");
+        }
+    } else if (options.generate) {
+        // generated files are loaded unless another directory is given
+        if (options.dataPath.empty()) options.dataPath = options.simulation.outputPath;
+        if (options.operations.empty()) return options;
+    }
+    if (options.dataPath.empty() && !options.inMemory) throw std::invalid_argument("[BATCH] --input is required\n");
+    if (options.operations.empty()) throw std::invalid_argument("[BATCH] No operation requested\n");
+    if (options.dataType == "AUTO") {
+        // queued loads and benchmarks work on a dataset of one type
+        bool oneTypeOnly{options.producers > 0};
+        for (auto it = options.operations.begin(); it != options.operations.end(); ++it) {
+            if (it->command == "INGEST" || it->command == "READ-BENCH" || it->command == "INSERT-BENCH") {
+                oneTypeOnly = true;
+            }
+        }
+        if (oneTypeOnly || options.noOfShards > 0) {
+            throw std::invalid_argument("[BATCH] --producers, --shards, --ingest and benchmarks need one data type\n");
+        }
+    }
+    if (options.noOfShards > 0) {
+        // a sharded dataset has no report cache, arena or frozen layout, and
+        // snapshots are taken of a DataManager
+        for (auto it = options.operations.begin(); it != options.operations.end(); ++it) {
+            if (it->command == "CACHE" || it->command == "STORAGE" || it->command == "MEMORY"
+                || it->command == "FREEZE" || it->command == "READ-BENCH") {
+                throw std::invalid_argument("[BATCH] --cache, --storage, --memory, --freeze and --read-bench "
+                                            "do not apply to --shards\n");
+            }
+        }
+    }
+    return options;
+}
+
+// return command line usage instructions
+std::string BatchMode::getUsage() {
+    std::ostringstream stringStream;
+    stringStream
+        << "Usage: datahero                       (interactive mode)"                << std::endl
+        << "       datahero --type TYPE --input DIR OPERATION [OPERATION ...]"      << std::endl
+        << "       datahero --type TYPE --generate DIR [GENERATOR ...] [OPERATION ...]" << std::endl
+        << "       datahero --type TYPE --in-memory [GENERATOR ...] OPERATION [OPERATION ...]" << std::endl
+        << std::endl
+        << "Options:"                                                                 << std::endl
+        << "   --type TYPE              double, int, complexdouble or auto, which"    << std::endl
+        << "                            detects the type of every file"               << std::endl
+        << "   --input DIR              directory containing data files"              << std::endl
+        << "   --compress               keep measurements in compressed blocks"       << std::endl
+        << "   --producers N            parse files on N threads feeding a queue"     << std::endl
+        << "   --shards N               load into N shards, each with its own lock,"  << std::endl
+        << "                            and insert every batch of --producers or"     << std::endl
+        << "                            --in-memory shard by shard in parallel"       << std::endl
+        << "   --trace FILE             write timeline of the run to FILE, open it in" << std::endl
+        << "                            chrome://tracing or ui.perfetto.dev"         << std::endl
+        << "   --metrics FILE           write Prometheus metrics to FILE at the end"  << std::endl
+        << "     --metrics-interval S   and every S seconds meanwhile"                << std::endl
+        << "   --metrics-port PORT      serve Prometheus metrics on 127.0.0.1:PORT"   << std::endl
+        << "                            while running"                                << std::endl
+        << "   --debug                  print debug messages"                         << std::endl
+        << "   --help                   show this message"                            << std::endl
+        << std::endl
+        << "Generator options:"                                                       << std::endl
+        << "   --generate DIR           write data files to existing directory DIR,"  << std::endl
+        << "                            also the default --input"                     << std::endl
+        << "   --in-memory              generate the data straight into memory"       << std::endl
+        << "                            instead of loading files; with --generate"    << std::endl
+        << "                            the files are written meanwhile"              << std::endl
+        << "   --staff-count N          staff members (default 2)"                    << std::endl
+        << "   --project-count N        projects of every staff member (default 2)"   << std::endl
+        << "   --file-count N           files of every project (default 1)"           << std::endl
+        << "   --points N|MIN:MAX       measurements per file (default 5:10)"         << std::endl
+        << "   --rate R                 measurements per second, 0 unthrottled"       << std::endl
+        << "   --seed S                 random seed, same seed gives same files"      << std::endl
+        << "   --start TIMESTAMP        first timestamp (default 1462033286)"         << std::endl
+        << "   --binary                 write binary instead of text files"           << std::endl
+        << "   --generate-threads N     threads writing files (default one per core)," << std::endl
+        << "                            the files do not depend on it"                << std::endl
+        << "   --profile NAME           workload: uniform (default), skewed, giant,"  << std::endl
+        << "                            bursty, duplicates or realistic, changed by"  << std::endl
+        << "                            the options following it:"                    << std::endl
+        << "     --zipf S               Zipf exponent of project popularity"          << std::endl
+        << "     --giant SHARE:FACTOR   share of projects with FACTOR times larger"   << std::endl
+        << "                            files"                                        << std::endl
+        << "     --disorder SHARE:LENGTH"                                            << std::endl
+        << "                            share of measurements out of order, in"       << std::endl
+        << "                            bursts of LENGTH"                             << std::endl
+        << "     --duplicates SHARE     share of files written twice"                 << std::endl
+        << "     --values DIST[:LOW:HIGH]"                                            << std::endl
+        << "                            uniform, normal, exponential or spiky values" << std::endl
+        << "                            (default 50 to 100)"                          << std::endl
+        << std::endl
+        << "Operations, run in the given order over one load of the data:"           << std::endl
+        << "   --staff                  staff name list"                              << std::endl
+        << "   --project                project name list"                            << std::endl
+        << "   --data SEL               data of all or particular projects"           << std::endl
+        << "   --report SEL             analysis report of all or particular projects" << std::endl
+        << "     --range START:END      restrict preceding data or report output"     << std::endl
+        << "                            to timestamp range"                           << std::endl
+        << "   --del STAFF:PROJECT      delete project"                               << std::endl
+        << "   --del-val STAFF:PROJECT:START:END"                                    << std::endl
+        << "                            delete measurements in timestamp range"       << std::endl
+        << "   --cache                  report cache statistics"                      << std::endl
+        << "   --storage                block storage size and decode throughput"     << std::endl
+        << "   --memory                 memory used by every project and in total,"  << std::endl
+        << "                            map entries and names estimated"              << std::endl
+        << "   --freeze                 compact data for the following operations"    << std::endl
+        << "   --ingest                 ingest queue statistics of a --producers load" << std::endl
+        << "   --read-bench N           snapshot report throughput of 1 to N reader"  << std::endl
+        << "                            threads while another thread writes"          << std::endl
+        << "   --insert-bench N         skewed insert throughput of 1 to N threads,"  << std::endl
+        << "                            one lock against sharded locks"               << std::endl
+        << "     --out FILE             write output of preceding operation to FILE"  << std::endl
+        << std::endl
+        << "SEL is <all> or STAFF:PROJECT, where STAFF or PROJECT can be <all>"      << std::endl
+        << std::endl
+        << "Exit codes:"                                                              << std::endl
+        << "   0 success, 1 unexpected error, 2 bad command line, 3 data not loaded," << std::endl
+        << "   4 staff/project/range not found, 5 output file not written"            << std::endl;
+    return stringStream.str();
+}
+
+// load data of types detected per file and run all operations
+int BatchMode::runMixedOperations(const BatchOptions& options) {
+    MixedDataManager data;
+    // load or generate the data once for all operations
+    if (options.inMemory) {
+        int exitCode{runInMemorySimulation(options, data)};
+        if (exitCode != BATCH_SUCCESS) return exitCode;
+    } else if (!MixedDataInput::readFromFile(data, options.dataPath, true)) {
+        return BATCH_INPUT_ERROR;
+    }
+    bool publish{isExportingMetrics(options)};
+    if (publish) data.publishMetrics();
+    for (auto it = options.operations.begin(); it != options.operations.end(); ++it) {
+        int exitCode{runStatisticsOperation(data, *it)};
+        if (publish) data.publishMetrics();
+        if (exitCode != BATCH_SUCCESS) return exitCode;
+    }
+    return BATCH_SUCCESS;
+}
+
+// write data files of the load generator
+int BatchMode::runSimulation(const BatchOptions& options) {
+    try {
+        // statistics of the run are not requested output
+        std::clog << Simulation::generate(options.simulation).show();
+    }
+    catch (const std::invalid_argument& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_USAGE_ERROR;
+    }
+    catch (const std::runtime_error& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_OUTPUT_ERROR;
+    }
+    return BATCH_SUCCESS;
+}
+
+// write operation output to standard output or file
+int BatchMode::writeOutput(const std::string& output, const BatchOperation& operation) {
+    if (operation.outFile.empty()) {
+        std::cout << output;
+        return std::cout ? BATCH_SUCCESS : BATCH_OUTPUT_ERROR;
+    }
+    if (!FileMsg::print(output, operation.outFile)) return BATCH_OUTPUT_ERROR;
+    return BATCH_SUCCESS;
+}
+
+// run DataHero in batch mode
+int BatchMode::run(int argc, char* argv[]) {
+    BatchOptions options;
+    try {
+        options = parseArguments(argc, argv);
+    }
+    catch (const std::invalid_argument& e) {
+        ErrorMsg::print(e.what());
+        ErrorMsg::print(getUsage());
+        return BATCH_USAGE_ERROR;
+    }
+    if (options.help) {
+        std::cout << getUsage();
+        return BATCH_SUCCESS;
+    }
+    // only requested output goes to standard output
+    ScreenMsg::quietMode = true;
+    DebugMsg::debugMode = options.debug;
+    BlockStorage::compressBlocks = options.compress;
+    std::unique_ptr<MetricsExporter> exporter;
+    if (isExportingMetrics(options)) {
+        try {
+            exporter.reset(new MetricsExporter(options.metricsFile, options.metricsInterval, options.metricsPort));
+        }
+        catch (const std::runtime_error& e) {
+            ErrorMsg::print(e.what());
+            return BATCH_OUTPUT_ERROR;
+        }
+    }
+    if (!options.traceFile.empty()) Trace::start();
+    int exitCode{runAll(options)};
+    // a failed run is traced and measured too
+    if (!options.traceFile.empty()) {
+        Trace::stop();
+        if (!Trace::write(options.traceFile) && exitCode == BATCH_SUCCESS) exitCode = BATCH_OUTPUT_ERROR;
+    }
+    if (exporter && !exporter->stop() && exitCode == BATCH_SUCCESS) exitCode = BATCH_OUTPUT_ERROR;
+    return exitCode;
+}
+
+// true if metrics are written or served
+bool BatchMode::isExportingMetrics(const BatchOptions& options) {
+    return !options.metricsFile.empty() || options.metricsPort > 0;
+}
+
+// generate or load data and run all operations
+int BatchMode::runAll(const BatchOptions& options) {
+    try {
+        if (options.generate && !options.inMemory) {
+            int exitCode{runSimulation(options)};
+            if (exitCode != BATCH_SUCCESS || options.operations.empty()) return exitCode;
+        }
+        if (options.dataType == "AUTO") return runMixedOperations(options);
+        else if (options.dataType == "DOUBLE") return runOperations<double>(options);
+        else if (options.dataType == "INT") return runOperations<int>(options);
+        else return runOperations<std::complex<double>>(options);
+    }
+    catch (const std::exception& e) {
+        ErrorMsg::print(std::string("[BATCH] Unexpected error: ") + e.what() + "\n");
+    }
+    return BATCH_FAILURE;
+}
@@ -0,0 +1,322 @@
+#ifndef BATCH_MODE_HPP
+#define BATCH_MODE_HPP
+
+#include <iostream>  // std
+#include <string>    // string
+#include <vector>    // vector
+#include <complex>   // complex numbers
+#include <sstream>   // stringstream
+#include <stdexcept> // invalid_argument
+#include <algorithm> // transform
+
+#include "msg.hpp"         // classes managing outputs
+#include "maps.hpp"        // classes managing databases
+#include "dataInput.hpp"   // classes reading data into databases
+#include "reportCache.hpp" // time range of a query
+#include "snapshotDataManager.hpp" // concurrent snapshot reads
+#include "shardedDataManager.hpp"  // concurrent inserts
+#include "mixedDataManager.hpp"    // dataset of int, double and complex series
+#include "simulation.hpp"          // load generator
+
+/* ------------------------------------------------------------------------
+* BATCH MODE EXIT CODES
+* -----------------------------------------------------------------------*/
+
+// exit codes returned when DataHero is run with command line arguments
+enum BatchExitCode {
+    BATCH_SUCCESS      = 0, // all operations succeeded
+    BATCH_FAILURE      = 1, // unexpected error
+    BATCH_USAGE_ERROR  = 2, // command line could not be understood
+    BATCH_INPUT_ERROR  = 3, // a data file could not be loaded
+    BATCH_NOT_FOUND    = 4, // requested staff, project or range does not exist
+    BATCH_OUTPUT_ERROR = 5, // output file could not be written
+    BATCH_REGRESSION   = 6  // benchmark slower than its baseline
+};
+
+/* ------------------------------------------------------------------------
+* BATCH MODE OPERATIONS AND OPTIONS
+* -----------------------------------------------------------------------*/
+
+// one operation requested on the command line
+struct BatchOperation {
+    // STAFF, PROJECT, REPORT, DATA, DEL, DEL-VAL, CACHE, STORAGE, MEMORY,
+    // FREEZE, READ-BENCH, INSERT-BENCH or INGEST
+    std::string command;
+    // upper case names, ALL selects every staff member or project
+    std::string staffName;
+    std::string projectName;
+    // timestamps the operation is restricted to
+    TimeRange range;
+    // output file, standard output if empty
+    std::string outFile;
+    // largest number of threads of READ-BENCH and INSERT-BENCH
+    unsigned noOfThreads;
+};
+
+// everything requested on the command line
+struct BatchOptions {
+    // DOUBLE, INT, COMPLEXDOUBLE or AUTO, detected per file
+    std::string dataType;
+    std::string dataPath;
+    bool debug;
+    bool help;
+    // keep measurements in compressed blocks
+    bool compress;
+    // parser threads feeding the ingest queue, 0 reads files one by one
+    unsigned producers;
+    // load into a ShardedDataManager of this many shards, 0 into a
+    // DataManager
+    unsigned noOfShards;
+    std::vector<BatchOperation> operations;
+    // write data files before the load, which reads them unless --input
+    // names another directory
+    bool generate;
+    SimulationConfig simulation;
+    // generate data straight into the dataset instead of loading files,
+    // writing them meanwhile if generate is set
+    bool inMemory;
+    // write trace-event JSON of the run to this file if not empty
+    std::string traceFile;
+    // write Prometheus metrics to this file at the end if not empty, and
+    // every metricsInterval seconds meanwhile if not 0
+    std::string metricsFile;
+    unsigned metricsInterval;
+    // serve metrics on this port of 127.0.0.1 while running if not 0
+    unsigned metricsPort;
+};
+
+/* ------------------------------------------------------------------------
+* CLASS RUNNING DATAHERO WITHOUT PROMPTS
+* -----------------------------------------------------------------------*/
+
+// Loads one data directory and runs the operations given on the command
+// line over it, in order, e.g.
+//   datahero --type double --input sim_double --report all --out reports/all.txt
+// Stops at the first failing operation and returns its BatchExitCode.
+class BatchMode {
+private:
+    // load data and run all operations for data type T
+    template <typename T> static int runOperations(const BatchOptions& options);
+    // load data into a DataManager<T> or ShardedDataManager<T> and run all
+    // operations
+    template <typename T, typename Data> static int runOperations(const BatchOptions& options, Data& data);
+    // load data of types detected per file and run all operations
+    static int runMixedOperations(const BatchOptions& options);
+    // generate or load data and run all operations
+    static int runAll(const BatchOptions& options);
+    // true if metrics are written or served
+    static bool isExportingMetrics(const BatchOptions& options);
+    // write data files of the load generator
+    static int runSimulation(const BatchOptions& options);
+    // generate data straight into a DataManager, MixedDataManager or
+    // ShardedDataManager
+    template <typename Data> static int runInMemorySimulation(const BatchOptions& options, Data& data);
+    // run one operation
+    template <typename T> static int runOperation(DataManager<T>& data,
+                                                  const BatchOperation& operation);
+    template <typename T> static int runOperation(ShardedDataManager<T>& data,
+                                                  const BatchOperation& operation);
+    // run statistics operation of a DataManager or MixedDataManager, or
+    // any other through runDataOperation
+    template <typename Data> static int runStatisticsOperation(Data& data,
+                                                               const BatchOperation& operation);
+    // run one operation supported by every dataset, Data is a DataManager,
+    // MixedDataManager or ShardedDataManager
+    template <typename Data> static int runDataOperation(Data& data,
+                                                         const BatchOperation& operation);
+    // write operation output to standard output or file
+    static int writeOutput(const std::string& output, const BatchOperation& operation);
+    // command line parsing helpers
+    static std::string toUpper(std::string text);
+    static std::vector<std::string> split(const std::string& text, const char& separator);
+    static unsigned toTimestamp(const std::string& text);
+    static void parseSelection(const std::string& text, BatchOperation& operation, bool allowAll);
+    static TimeRange parseRange(const std::string& text);
+    static unsigned toThreadCount(const std::string& text);
+    static unsigned toCount(const std::string& text, const std::string& option);
+    static double toReal(const std::string& text, const std::string& option);
+    template <typename Number> static Number toNumber(const std::string& text, const std::string& option);
+    static std::string getValue(int argc, char* argv[], int& i);
+
+public:
+    // parse command line, throws invalid_argument if it cannot be understood
+    static BatchOptions parseArguments(int argc, char* argv[]);
+    // return command line usage instructions
+    static std::string getUsage();
+    // run DataHero in batch mode, returns one of BatchExitCode
+    static int run(int argc, char* argv[]);
+};
+
+/* ------------------------------------------------------------------------
+* DEFINE BATCH MODE TEMPLATE FUNCTIONS
+* -----------------------------------------------------------------------*/
+
+// read non-negative number of an option from text
+template <typename Number> Number BatchMode::toNumber(const std::string& text, const std::string& option) {
+    std::istringstream stringStream(text);
+    Number number{};
+    if (text.empty() || text[0] == '-' || !(stringStream >> number) || !stringStream.eof()) {
+        throw std::invalid_argument("[BATCH] " + option + " '" + text + "' is not valid\n");
+    }
+    return number;
+}
+
+// load data and run all operations for data type T
+template <typename T> int BatchMode::runOperations(const BatchOptions& options) {
+    if (options.noOfShards > 0) {
+        ShardedDataManager<T> data(options.noOfShards);
+        return runOperations<T>(options, data);
+    }
+    DataManager<T> data;
+    return runOperations<T>(options, data);
+}
+
+// load data into a DataManager<T> or ShardedDataManager<T> and run all
+// operations
+template <typename T, typename Data> int BatchMode::runOperations(const BatchOptions& options, Data& data) {
+    // gauges are named after the lower case data type
+    std::string dataset{options.dataType};
+    std::transform(dataset.begin(), dataset.end(), dataset.begin(), ::tolower);
+    bool publish{isExportingMetrics(options)};
+    IngestStats ingestStats{0, 0, 0, 0, 0, 0, 0, 0, 0};
+    // load or generate the data once for all operations
+    if (options.inMemory) {
+        int exitCode{runInMemorySimulation(options, data)};
+        if (exitCode != BATCH_SUCCESS) return exitCode;
+    } else {
+        bool loaded{options.producers > 0
+                    ? DataInput<T>::readFromFileQueued(data, options.dataPath, options.producers, ingestStats, true)
+                    : DataInput<T>::readFromFile(data, options.dataPath, true)};
+        if (!loaded) return BATCH_INPUT_ERROR;
+    }
+    if (publish) data.publishMetrics(dataset);
+    for (auto it = options.operations.begin(); it != options.operations.end(); ++it) {
+        // queue statistics belong to the load rather than the data
+        int exitCode{it->command == "INGEST" ? writeOutput(ingestStats.show(), *it)
+                                             : runOperation<T>(data, *it)};
+        if (publish) data.publishMetrics(dataset);
+        if (exitCode != BATCH_SUCCESS) return exitCode;
+    }
+    return BATCH_SUCCESS;
+}
+
+// generate data straight into a DataManager or MixedDataManager
+template <typename Data> int BatchMode::runInMemorySimulation(const BatchOptions& options, Data& data) {
+    try {
+        // statistics of the run are not requested output
+        std::clog << Simulation::generateInto(options.simulation, data, options.generate).show();
+    }
+    catch (const std::invalid_argument& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_USAGE_ERROR;
+    }
+    catch (const std::runtime_error& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_OUTPUT_ERROR;
+    }
+    return BATCH_SUCCESS;
+}
+
+// run one operation
+template <typename T> int BatchMode::runOperation(DataManager<T>& data,
+                                                  const BatchOperation& operation) {
+    std::string output;
+    if (operation.command == "READ-BENCH") {
+        // readers work on snapshots of a copy, the loaded data stays as it is
+        SnapshotDataManager<T> snapshots(data);
+        output = snapshots.benchmarkReaders(operation.noOfThreads);
+    } else if (operation.command == "INSERT-BENCH") {
+        // synthetic experiments, the loaded data is not used
+        output = ShardedDataManager<T>::benchmarkInserts(operation.noOfThreads);
+    } else {
+        return runStatisticsOperation(data, operation);
+    }
+    return writeOutput(output, operation);
+}
+
+// run one operation of a sharded dataset, which has no statistics
+// operations; parseArguments rejects them
+template <typename T> int BatchMode::runOperation(ShardedDataManager<T>& data,
+                                                  const BatchOperation& operation) {
+    if (operation.command == "INSERT-BENCH") {
+        // synthetic experiments, the loaded data is not used
+        return writeOutput(ShardedDataManager<T>::benchmarkInserts(operation.noOfThreads), operation);
+    }
+    return runDataOperation(data, operation);
+}
+
+// run statistics operation of a DataManager or MixedDataManager
+template <typename Data> int BatchMode::runStatisticsOperation(Data& data,
+                                                               const BatchOperation& operation) {
+    std::string output;
+    if (operation.command == "CACHE") {
+        output = data.reportCacheShow();
+    } else if (operation.command == "STORAGE") {
+        output = data.storageShow();
+    } else if (operation.command == "MEMORY") {
+        output = data.memoryShow();
+    } else if (operation.command == "FREEZE") {
+        data.freeze();
+        output = data.frozenShow();
+    } else {
+        return runDataOperation(data, operation);
+    }
+    return writeOutput(output, operation);
+}
+
+// run one operation supported by every dataset
+template <typename Data> int BatchMode::runDataOperation(Data& data,
+                                                         const BatchOperation& operation) {
+    const std::string& staffName = operation.staffName;
+    const std::string& projectName = operation.projectName;
+    const TimeRange& range = operation.range;
+    std::string output;
+    if (operation.command == "STAFF") {
+        output = data.staffDatabaseShow();
+    } else if (operation.command == "PROJECT") {
+        output = data.projectDatabaseShow();
+    } else if (operation.command == "DATA" && range.isRange) {
+        if (staffName == "ALL" && projectName == "ALL") {
+            output = data.fullDatabaseRangeShow(range.startTime, range.endTime);
+        } else if (projectName == "ALL") {
+            output = data.staffDatabaseRangeShow(staffName, range.startTime, range.endTime);
+        } else if (staffName == "ALL") {
+            output = data.projectDatabaseRangeShow(projectName, range.startTime, range.endTime);
+        } else {
+            output = data.fullDatabaseRangeShow(staffName, projectName, range.startTime, range.endTime);
+        }
+    } else if (operation.command == "DATA") {
+        if (staffName == "ALL" && projectName == "ALL") output = data.fullDatabaseShow();
+        else if (projectName == "ALL") output = data.staffDatabaseShow(staffName);
+        else if (staffName == "ALL") output = data.projectDatabaseShow(projectName);
+        else output = data.fullDatabaseShow(staffName, projectName);
+    } else if (operation.command == "REPORT" && !range.isRange) {
+        if (staffName == "ALL" && projectName == "ALL") output = data.getReport();
+        else if (projectName == "ALL") output = data.getStaffReport(staffName);
+        else if (staffName == "ALL") output = data.getProjectReport(projectName);
+        else output = data.getReport(staffName, projectName);
+    } else if (operation.command == "REPORT") {
+        if (staffName == "ALL" && projectName == "ALL") {
+            output = data.getRangeReport(range.startTime, range.endTime);
+        } else if (projectName == "ALL") {
+            output = data.getStaffRangeReport(staffName, range.startTime, range.endTime);
+        } else if (staffName == "ALL") {
+            output = data.getProjectRangeReport(projectName, range.startTime, range.endTime);
+        } else {
+            output = data.getRangeReport(staffName, projectName, range.startTime, range.endTime);
+        }
+    } else if (operation.command == "DEL") {
+        if (!data.deleteEntry(staffName, projectName)) return BATCH_NOT_FOUND;
+        return BATCH_SUCCESS;
+    } else if (operation.command == "DEL-VAL") {
+        if (!data.deleteMeasurementRange(staffName, projectName, range.startTime, range.endTime)) {
+            return BATCH_NOT_FOUND;
+        }
+        return BATCH_SUCCESS;
+    }
+    // error message was already printed by the database
+    if (output.empty()) return BATCH_NOT_FOUND;
+    return writeOutput(output, operation);
+}
+
+#endif /* BATCH_MODE_HPP */
@@ -0,0 +1,690 @@
+#include <sstream>   // stringstream
+#include <iomanip>   // setprecision
+#include <algorithm> // transform
+#include <cstdio>    // remove
+#include <set>       // set
+#include <cmath>     // pow
+#include <fstream>   // ifstream
+#include <stdexcept> // invalid_argument, runtime_error, logic_error
+#include <functional> // function
+#include <memory>    // unique_ptr
+
+#include "benchmark.hpp"    // benchmark suite
+#include "batchMode.hpp"    // exit codes
+#include "binaryFormat.hpp" // binary data files
+#include "dataInput.hpp"    // reading data directories
+#include "filePath.hpp"     // scratch directory
+
+/* ------------------------------------------------------------------------
+* DEFINE BENCHMARK CONSTANTS
+* -----------------------------------------------------------------------*/
+
+const unsigned long long Benchmark::minSize{1000ULL};
+const unsigned long long Benchmark::maxSize{100000000ULL};
+const unsigned long long Benchmark::maxOutputSize{10000000ULL};
+const double Benchmark::minSampleSeconds{0.02};
+const unsigned Benchmark::maxRepeats{100000};
+const char* Benchmark::scratchFile{"datahero_benchmark.tmp"};
+const char* Benchmark::scratchDirectory{"datahero_benchmark_files"};
+
+/* ------------------------------------------------------------------------
+* DEFINE BENCHMARK TEMPLATE FUNCTIONS
+* -----------------------------------------------------------------------*/
+
+// return contents of the text data file of experiment
+template <typename T> std::string Benchmark::getText(const Experiment<T>& experiment) {
+    std::ostringstream stringStream;
+    stringStream << "Staff: " << experiment.getStaffName() << std::endl
+                 << "Project: " << experiment.getProjectName() << std::endl
+                 << "-----------------------------" << std::endl;
+    experiment.getSeries().forEach([&stringStream](const unsigned& timestamp, const T& value) {
+        stringStream << Measurement<T>(timestamp, value) << std::endl;
+    });
+    return stringStream.str();
+}
+
+// return contents of the binary data file of experiment
+template <typename T> std::string Benchmark::getBinary(const Experiment<T>& experiment) {
+    std::string buffer;
+    BinaryFormat::appendHeader<T>(buffer, experiment.getStaffName(), experiment.getProjectName(),
+                                  experiment.getSeries().getSize());
+    experiment.getSeries().forEach([&buffer](const unsigned& timestamp, const T& value) {
+        BinaryFormat::append(buffer, static_cast<std::uint32_t>(timestamp));
+        BinaryFormat::appendValue(buffer, value);
+    });
+    return buffer;
+}
+
+// time body repeatedly, each time after an untimed prepare
+template <typename Prepare, typename Body>
+double Benchmark::timeRepeats(unsigned& noOfRepeats, Prepare prepare, Body body) {
+    double seconds{};
+    unsigned repeat{};
+    for (; noOfRepeats > 0 ? repeat < noOfRepeats : seconds < minSampleSeconds && repeat < maxRepeats; ++repeat) {
+        prepare();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        seconds += getSecondsSince(start);
+    }
+    noOfRepeats = repeat;
+    return seconds / repeat;
+}
+
+// run every benchmark over a dataset of type T and size once
+template <typename T> void Benchmark::runOnce(const BenchmarkOptions& options, const std::string& dataType,
+                                              const unsigned long long& size,
+                                              const std::vector<BenchmarkResult>& reference,
+                                              std::vector<BenchmarkResult>& results) {
+    // time benchmark name, repeated as often as in reference
+    unsigned noOfRepeats{};
+    auto time = [&](const std::string& name, const std::function<void()>& prepare,
+                    const std::function<void()>& body) {
+        noOfRepeats = getRepeats(reference, name, dataType, size);
+        return timeRepeats(noOfRepeats, prepare, body);
+    };
+    auto addResult = [&](const std::string& name, const unsigned long long& noOfPoints,
+                         const unsigned long long& noOfCalls, const double& seconds) {
+        results.push_back(BenchmarkResult{name, dataType, size, noOfPoints, noOfCalls, noOfRepeats,
+                                          std::vector<double>{seconds}, seconds, seconds, seconds});
+    };
+    auto writeScratchFile = [](const std::string& contents, const std::string& fileName) {
+        if (!FileMsg::print(contents, fileName)) {
+            throw std::runtime_error("[BENCHMARK] Scratch file '" + fileName + "' could not be written\n");
+        }
+    };
+    auto makeScratchDirectory = []() {
+        removeDirectory(scratchDirectory);
+        if (!makeDirectory(scratchDirectory)) {
+            throw std::runtime_error("[BENCHMARK] Scratch directory '" + std::string(scratchDirectory)
+                                     + "' could not be created\n");
+        }
+    };
+
+    // text and binary files of all projects, first files of all projects
+    // followed by their second files
+    std::vector<std::string> texts, binaries;
+    unsigned long long noOfPoints{};
+    for (int secondFile{}; secondFile < 2; ++secondFile) {
+        DataManager<T> generated;
+        Simulation::generateInto(getConfig(dataType, size, options.seed, secondFile == 1), generated, false);
+        std::vector<ProjectSharedPtr<T>> projects{generated.getProjects()};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            noOfPoints += (*it)->getSeries().getSize();
+            texts.push_back(getText(*(*it)));
+            binaries.push_back(getBinary(*(*it)));
+        }
+    }
+
+    // parse file contents already in memory; files parsed from binary keep
+    // the generated values unrounded and are the input of the benchmarks
+    // below
+    std::vector<std::istringstream> streams;
+    std::vector<Experiment<T>> experiments;
+    auto prepareParse = [&](const std::vector<std::string>& contents, const std::ios::openmode& mode) {
+        streams.clear();
+        for (auto it = contents.begin(); it != contents.end(); ++it) streams.emplace_back(*it, mode);
+        experiments.assign(contents.size(), Experiment<T>());
+    };
+    auto parse = [&]() {
+        for (std::size_t i{}; i < streams.size(); ++i) experiments[i].readFromStream(streams[i]);
+    };
+    addResult("parse-text", noOfPoints, texts.size(),
+              time("parse-text", [&]() { prepareParse(texts, std::ios::in); }, parse));
+    addResult("parse-binary", noOfPoints, binaries.size(),
+              time("parse-binary", [&]() { prepareParse(binaries, std::ios::in | std::ios::binary); }, parse));
+    streams.clear();
+    binaries.clear();
+
+    // read the text files from disk
+    {
+        makeScratchDirectory();
+        std::vector<std::string> fileNames;
+        for (std::size_t i{}; i < texts.size(); ++i) {
+            fileNames.push_back(joinPath(scratchDirectory, "file" + std::to_string(i) + ".txt"));
+            writeScratchFile(texts[i], fileNames.back());
+        }
+        std::vector<Experiment<T>> read;
+        double seconds{time("read-file", [&]() { read.assign(fileNames.size(), Experiment<T>()); }, [&]() {
+            for (std::size_t i{}; i < fileNames.size(); ++i) read[i].readFromFile(fileNames[i]);
+        })};
+        removeDirectory(scratchDirectory);
+        addResult("read-file", noOfPoints, fileNames.size(), seconds);
+    }
+    texts.clear();
+
+    // write both files of every project with the load generator and load
+    // the directory back, which has to give every measurement written
+    {
+        SimulationConfig config{getConfig(dataType, size, options.seed, false)};
+        config.outputPath = scratchDirectory;
+        config.noOfFiles = 2;
+        makeScratchDirectory();
+        SimulationStats stats{Simulation::generate(config)};
+        std::unique_ptr<DataManager<T>> loaded;
+        bool read{true};
+        double seconds{time("load-directory", [&]() { loaded.reset(new DataManager<T>()); }, [&]() {
+            read = DataInput<T>::readFromFile(*loaded, scratchDirectory, true) && read;
+        })};
+        removeDirectory(scratchDirectory);
+        unsigned long long noOfLoaded{};
+        std::vector<ProjectSharedPtr<T>> projects{loaded->getProjects()};
+        for (auto it = projects.begin(); it != projects.end(); ++it) noOfLoaded += (*it)->getSeries().getSize();
+        if (!read || noOfLoaded != stats.noOfPoints) {
+            throw std::runtime_error("[BENCHMARK] Loaded " + std::to_string(noOfLoaded) + " of "
+                                     + std::to_string(stats.noOfPoints) + " measurements generated in '"
+                                     + std::string(scratchDirectory) + "'\n");
+        }
+        addResult("load-directory", stats.noOfPoints, stats.noOfFiles, seconds);
+    }
+
+    std::size_t noOfProjects{experiments.size() / 2};
+    std::set<std::string> staffNames, projectNames;
+    unsigned long long noOfFirstPoints{};
+    for (std::size_t i{}; i < noOfProjects; ++i) {
+        staffNames.insert(experiments[i].getStaffName());
+        projectNames.insert(experiments[i].getProjectName());
+        noOfFirstPoints += experiments[i].getSeries().getSize();
+    }
+    // every repeat works on copies of the files and, but for the reports,
+    // on a database of its own
+    std::vector<Experiment<T>> copies;
+    auto copyFiles = [&](const std::size_t& first, const std::size_t& last) {
+        copies.assign(experiments.begin() + first, experiments.begin() + last);
+    };
+    std::unique_ptr<DataManager<T>> data;
+    auto insertFiles = [&](const std::size_t& first, const std::size_t& last) {
+        for (std::size_t i{first}; i < last; ++i) data->insertExperiment(std::move(copies[i - first]));
+    };
+
+    // add all files to the project map alone, without the staff and
+    // project references
+    {
+        std::unique_ptr<ProjectDb<T>> projectDb;
+        addResult("add-entry", noOfPoints, experiments.size(), time("add-entry", [&]() {
+            copyFiles(0, experiments.size());
+            projectDb.reset(new ProjectDb<T>(std::make_shared<Arena>()));
+        }, [&]() {
+            for (auto it = copies.begin(); it != copies.end(); ++it) {
+                projectDb->addEntry(it->getStaffName(), it->getProjectName(), std::move(*it));
+            }
+        }));
+    }
+
+    // insert the first files as new projects, then merge the second files
+    // into them
+    addResult("insert-experiment", noOfFirstPoints, noOfProjects, time("insert-experiment", [&]() {
+        copyFiles(0, noOfProjects);
+        data.reset(new DataManager<T>());
+    }, [&]() { insertFiles(0, noOfProjects); }));
+    auto insertFirstFiles = [&]() {
+        copyFiles(0, noOfProjects);
+        data.reset(new DataManager<T>());
+        insertFiles(0, noOfProjects);
+        copyFiles(noOfProjects, experiments.size());
+    };
+    addResult("merge-experiment", noOfPoints - noOfFirstPoints, experiments.size() - noOfProjects,
+              time("merge-experiment", insertFirstFiles, [&]() { insertFiles(noOfProjects, experiments.size()); }));
+    copies.clear();
+
+    // reports from scratch, then the same report from the report cache
+    std::string output;
+    auto clearReportCache = [&]() { data->clearReportCache(); };
+    addResult("report-all", noOfPoints, 1, time("report-all", clearReportCache, [&]() {
+        output = data->getReport();
+    }));
+    addResult("report-all-cached", noOfPoints, 1, time("report-all-cached", []() {}, [&]() {
+        output = data->getReport();
+    }));
+    addResult("report-staff", noOfPoints, staffNames.size(), time("report-staff", clearReportCache, [&]() {
+        for (auto it = staffNames.begin(); it != staffNames.end(); ++it) output = data->getStaffReport(*it);
+    }));
+    addResult("report-project", noOfPoints, projectNames.size(), time("report-project", clearReportCache, [&]() {
+        for (auto it = projectNames.begin(); it != projectNames.end(); ++it) output = data->getProjectReport(*it);
+    }));
+
+    // show all data and dump it to a file
+    if (size <= maxOutputSize) {
+        addResult("show-all", noOfPoints, 1, time("show-all", clearReportCache, [&]() {
+            output = data->fullDatabaseShow();
+        }));
+        bool written{true};
+        double seconds{time("dump-all", []() {}, [&]() {
+            written = FileMsg::print(output, scratchFile) && written;
+        })};
+        std::remove(scratchFile);
+        if (!written) {
+            throw std::runtime_error("[BENCHMARK] Scratch file '" + std::string(scratchFile)
+                                     + "' could not be written\n");
+        }
+        addResult("dump-all", noOfPoints, 1, seconds);
+    }
+    output.clear();
+
+    // delete the later half of the first file and the earlier half of the
+    // second file of every project
+    SimulationConfig config{getConfig(dataType, size, options.seed, false)};
+    unsigned firstDeleted{config.startTime + config.maxPoints / 2};
+    unsigned lastDeleted{firstDeleted + config.maxPoints - 1};
+    double seconds{time("delete-range", [&]() {
+        insertFirstFiles();
+        insertFiles(noOfProjects, experiments.size());
+    }, [&]() {
+        for (std::size_t i{}; i < noOfProjects; ++i) {
+            data->deleteMeasurementRange(experiments[i].getStaffName(), experiments[i].getProjectName(),
+                                         firstDeleted, lastDeleted);
+        }
+    })};
+    std::vector<ProjectSharedPtr<T>> projects{data->getProjects()};
+    unsigned long long noOfKept{};
+    for (auto it = projects.begin(); it != projects.end(); ++it) noOfKept += (*it)->getSeries().getSize();
+    addResult("delete-range", noOfPoints - noOfKept, projects.size(), seconds);
+}
+
+// run every benchmark over a dataset of type T and size once, as run of
+// all runs
+template <typename T> void Benchmark::runType(const BenchmarkOptions& options, const std::string& dataType,
+                                              const unsigned long long& size, const unsigned& run,
+                                              const std::vector<BenchmarkResult>& reference,
+                                              std::vector<BenchmarkResult>& results) {
+    std::clog << "[BENCHMARK] " << dataType << ", " << size << " measurements, run " << run + 1
+              << " of " << options.noOfRuns << std::endl;
+    runOnce<T>(options, dataType, size, reference, results);
+}
+
+/* ------------------------------------------------------------------------
+* HELPER FUNCTIONS FOR PARSING COMMAND LINE
+* -----------------------------------------------------------------------*/
+
+// read dataset size from text
+unsigned long long Benchmark::toSize(const std::string& text) {
+    std::istringstream stringStream(text);
+    unsigned long long size{};
+    if (text.empty() || text[0] == '-' || !(stringStream >> size) || !stringStream.eof()
+        || size < minSize || size > maxSize) {
+        throw std::invalid_argument("[BENCHMARK] Dataset size '" + text + "' should be "
+                                    + std::to_string(minSize) + " to " + std::to_string(maxSize) + "\n");
+    }
+    return size;
+}
+
+// return value following an option
+std::string Benchmark::getValue(int argc, char* argv[], int& i) {
+    if (i + 1 >= argc) {
+        throw std::invalid_argument("[BENCHMARK] Option '" + std::string(argv[i]) + "' needs a value\n");
+    }
+    return argv[++i];
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE BENCHMARK CLASS
+* -----------------------------------------------------------------------*/
+
+// set median and confidence interval of the samples of result
+void Benchmark::summarise(BenchmarkResult& result) {
+    std::vector<double> sorted{result.samples};
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t n{sorted.size()};
+    result.seconds = n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    // the median lies between the k-th smallest and the k-th largest sample
+    // unless at most k - 1 samples fall on one side of it, which has a
+    // binomial probability; k is the largest with at most 2.5% on each
+    // side, or 1 if there are too few samples for that
+    std::size_t k{1};
+    double term{std::pow(0.5, static_cast<double>(n))}; // P(k - 1 below)
+    double cumulative{term};                             // P(at most k - 1 below)
+    while (2 * (k + 1) <= n + 1) {
+        term *= static_cast<double>(n - k + 1) / k;
+        if (cumulative + term > 0.025) break;
+        cumulative += term;
+        ++k;
+    }
+    result.lowSeconds = sorted[k - 1];
+    result.highSeconds = sorted[n - k];
+}
+
+// return dataset sizes of options
+std::vector<unsigned long long> Benchmark::getSizes(const BenchmarkOptions& options) {
+    std::vector<unsigned long long> sizes;
+    for (unsigned long long size{options.minPoints}; size <= options.maxPoints; size *= 10) {
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+// return load generator configuration of one file of every project
+SimulationConfig Benchmark::getConfig(const std::string& dataType, const unsigned long long& size,
+                                      const std::uint64_t& seed, const bool& secondFile) {
+    SimulationConfig config;
+    config.dataType = dataType;
+    config.noOfStaff = 4;
+    config.noOfProjects = 4;
+    config.noOfFiles = 1;
+    config.minPoints = static_cast<unsigned>(size / 32);
+    config.maxPoints = config.minPoints;
+    // another stream for the second file, whose timestamps follow the first
+    config.seed = secondFile ? ~seed : seed;
+    if (secondFile) config.startTime += config.maxPoints;
+    return config;
+}
+
+// return seconds elapsed since start
+double Benchmark::getSecondsSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// parse command line
+BenchmarkOptions Benchmark::parseArguments(int argc, char* argv[]) {
+    BenchmarkOptions options{"ALL", minSize, 1000000ULL, 42, "", false, 5, "", 10};
+    for (int i{1}; i < argc; ++i) {
+        std::string option{argv[i]};
+        if (option == "--help" || option == "-h") {
+            options.help = true;
+        } else if (option == "--type") {
+            options.dataType = getValue(argc, argv, i);
+            std::transform(options.dataType.begin(), options.dataType.end(), options.dataType.begin(), ::toupper);
+            if (options.dataType != "INT" && options.dataType != "DOUBLE"
+                && options.dataType != "COMPLEXDOUBLE" && options.dataType != "ALL") {
+                throw std::invalid_argument("[BENCHMARK] Data type '" + options.dataType + "' not supported\n");
+            }
+        } else if (option == "--sizes") {
+            std::string text{getValue(argc, argv, i)};
+            std::size_t separator{text.find(':')};
+            options.minPoints = toSize(text.substr(0, separator));
+            options.maxPoints = separator == std::string::npos ? options.minPoints
+                                                                : toSize(text.substr(separator + 1));
+            if (options.minPoints > options.maxPoints) {
+                throw std::invalid_argument("[BENCHMARK] Sizes '" + text + "' should be MIN:MAX\n");
+            }
+        } else if (option == "--seed") {
+            std::string text{getValue(argc, argv, i)};
+            std::istringstream stringStream(text);
+            if (text.empty() || text[0] == '-' || !(stringStream >> options.seed) || !stringStream.eof()) {
+                throw std::invalid_argument("[BENCHMARK] Seed '" + text + "' is not valid\n");
+            }
+        } else if (option == "--out") {
+            options.outFile = getValue(argc, argv, i);
+        } else if (option == "--runs") {
+            std::string text{getValue(argc, argv, i)};
+            std::istringstream stringStream(text);
+            if (text.empty() || text[0] == '-' || !(stringStream >> options.noOfRuns) || !stringStream.eof()
+                || options.noOfRuns == 0) {
+                throw std::invalid_argument("[BENCHMARK] Number of runs '" + text + "' should be positive\n");
+            }
+        } else if (option == "--baseline") {
+            options.baselineFile = getValue(argc, argv, i);
+        } else if (option == "--threshold") {
+            std::string text{getValue(argc, argv, i)};
+            std::istringstream stringStream(text);
+            if (text.empty() || text[0] == '-' || !(stringStream >> options.threshold) || !stringStream.eof()) {
+                throw std::invalid_argument("[BENCHMARK] Threshold '" + text + "' is not valid\n");
+            }
+        } else {
+            throw std::invalid_argument("[BENCHMARK] Unknown option '" + option + "'\n");
+        }
+    }
+    return options;
+}
+
+// return command line usage instructions
+std::string Benchmark::getUsage() {
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "Usage: benchmark [options]"                                                << std::endl
+        << std::endl
+        << "Times file parsing, loading of generated data directories,"              << std::endl
+        << "ProjectDb::addEntry, insertExperiment, mergeExperiment, reports of all"   << std::endl
+        << "data, staff members and projects, show and dump of all data and"          << std::endl
+        << "deleteMeasurementRange over generated datasets and writes the median"     << std::endl
+        << "time of every benchmark over several runs, with its 95% confidence"       << std::endl
+        << "interval, as JSON. Every run repeats a benchmark as often as in the"      << std::endl
+        << "baseline, or else until the first run took 20 ms. A generated"            << std::endl
+        << "directory that does not load back fails the run."                         << std::endl
+        << std::endl
+        << "Options:"                                                                  << std::endl
+        << "   --help, -h               show this text"                               << std::endl
+        << "   --type TYPE              int, double, complexdouble or all (default)"  << std::endl
+        << "   --sizes MIN[:MAX]        dataset sizes from MIN to MAX measurements in" << std::endl
+        << "                            steps of ten, 1000 to 100000000 (default"     << std::endl
+        << "                            1000:1000000); show and dump are run up to"   << std::endl
+        << "                            10000000"                                      << std::endl
+        << "   --seed N                 seed of the generated datasets (default 42)"  << std::endl
+        << "   --runs N                 runs of every benchmark (default 5)"          << std::endl
+        << "   --out FILE               write results to FILE instead of standard"    << std::endl
+        << "                            output"                                        << std::endl
+        << "   --baseline FILE          compare results with those of an earlier run" << std::endl
+        << "                            in FILE and print the differences to standard" << std::endl
+        << "                            error"                                         << std::endl
+        << "     --threshold PERCENT    growth of a median that fails the comparison" << std::endl
+        << "                            if the confidence intervals do not overlap"   << std::endl
+        << "                            (default 10)"                                  << std::endl
+        << std::endl
+        << "Exit codes:"                                                               << std::endl
+        << "   0 success, 1 unexpected error, 2 bad command line, 3 baseline not"     << std::endl
+        << "   read, 5 output file not written, 6 benchmark slower than baseline"     << std::endl;
+    return stringStream.str();
+}
+
+// check statistics of int measurements whose sum does not fit an int
+void Benchmark::checkStatistics() {
+    TimeSeries<int> series;
+    series.push_back(1, 1000000000);
+    series.push_back(2, 1000000002);
+    series.push_back(3, 1000000004);
+    Aggregate<int> aggregate{series.getAggregate()};
+    if (aggregate.getMean() != 1000000002 || aggregate.getStandardDeviation() != 2) {
+        throw std::logic_error("[BENCHMARK] Statistics of int measurements summing beyond INT_MAX are wrong: mean "
+                               + std::to_string(aggregate.getMean()) + ", standard deviation "
+                               + std::to_string(aggregate.getStandardDeviation()) + "\n");
+    }
+}
+
+// return repeats of a benchmark in reference
+unsigned Benchmark::getRepeats(const std::vector<BenchmarkResult>& reference, const std::string& name,
+                               const std::string& dataType, const unsigned long long& size) {
+    for (auto it = reference.begin(); it != reference.end(); ++it) {
+        if (it->name == name && it->dataType == dataType && it->size == size) return it->noOfRepeats;
+    }
+    return 0;
+}
+
+// run benchmarks of options
+std::vector<BenchmarkResult> Benchmark::runAll(const BenchmarkOptions& options,
+                                               const std::vector<BenchmarkResult>& baseline) {
+    checkStatistics();
+    std::vector<BenchmarkResult> results;
+    std::vector<unsigned long long> sizes{getSizes(options)};
+    // every run goes over all datasets, so that the samples of a benchmark
+    // are spread over the whole session rather than taken back to back,
+    // and a slow spell of the machine does not shift all of them
+    // the first run repeats benchmarks as often as the baseline, and later
+    // runs as often as the first
+    for (unsigned run{}; run < options.noOfRuns; ++run) {
+        const std::vector<BenchmarkResult>& reference{run == 0 ? baseline : results};
+        std::vector<BenchmarkResult> runResults;
+        for (auto it = sizes.begin(); it != sizes.end(); ++it) {
+            if (options.dataType == "INT" || options.dataType == "ALL") {
+                runType<int>(options, "int", *it, run, reference, runResults);
+            }
+            if (options.dataType == "DOUBLE" || options.dataType == "ALL") {
+                runType<double>(options, "double", *it, run, reference, runResults);
+            }
+            if (options.dataType == "COMPLEXDOUBLE" || options.dataType == "ALL") {
+                runType<std::complex<double>>(options, "complexdouble", *it, run, reference, runResults);
+            }
+        }
+        if (run == 0) {
+            results = runResults;
+            continue;
+        }
+        // later runs give the same benchmarks in the same order
+        for (std::size_t i{}; i < runResults.size(); ++i) results[i].samples.push_back(runResults[i].seconds);
+    }
+    for (auto it = results.begin(); it != results.end(); ++it) summarise(*it);
+    return results;
+}
+
+// return results as JSON
+std::string Benchmark::toJson(const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    std::ostringstream stringStream;
+    stringStream << "{" << std::endl
+                 << "  \"suite\": \"datahero\"," << std::endl
+                 << "  \"seed\": " << options.seed << "," << std::endl
+                 << "  \"runs\": " << options.noOfRuns << "," << std::endl
+                 << "  \"results\": [" << std::endl;
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        stringStream << "    {\"name\": \"" << it->name << "\", \"type\": \"" << it->dataType
+                     << "\", \"size\": " << it->size << ", \"points\": " << it->noOfPoints
+                     << ", \"calls\": " << it->noOfCalls << ", \"repeats\": " << it->noOfRepeats
+                     << ", \"seconds\": " << std::setprecision(6)
+                     << it->seconds << ", \"low\": " << it->lowSeconds << ", \"high\": " << it->highSeconds
+                     << ", \"pointsPerSecond\": "
+                     << (it->seconds > 0 ? it->noOfPoints / it->seconds : 0) << "}"
+                     << (it + 1 != results.end() ? "," : "") << std::endl;
+    }
+    stringStream << "  ]" << std::endl
+                 << "}" << std::endl;
+    return stringStream.str();
+}
+
+// return value of key in a line of JSON results
+std::string Benchmark::getField(const std::string& line, const std::string& key) {
+    std::string label{"\"" + key + "\": "};
+    std::size_t start{line.find(label)};
+    if (start == std::string::npos) return "";
+    start += label.size();
+    if (start < line.size() && line[start] == '"') {
+        std::size_t end{line.find('"', start + 1)};
+        return end == std::string::npos ? "" : line.substr(start + 1, end - start - 1);
+    }
+    std::size_t end{line.find_first_of(",}", start)};
+    return line.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+// read results written by toJson
+std::vector<BenchmarkResult> Benchmark::readBaseline(const std::string& fileName) {
+    std::ifstream inFile(fileName);
+    if (!inFile.is_open()) {
+        throw std::runtime_error("[BENCHMARK] Baseline file '" + fileName + "' could not be opened\n");
+    }
+    std::vector<BenchmarkResult> baseline;
+    std::string line;
+    while (std::getline(inFile, line)) {
+        if (getField(line, "name").empty()) continue;
+        BenchmarkResult result{getField(line, "name"), getField(line, "type"), 0, 0, 0, 0,
+                               std::vector<double>{}, 0, 0, 0};
+        std::istringstream values(getField(line, "size") + " " + getField(line, "points") + " "
+                                  + getField(line, "calls") + " " + getField(line, "repeats") + " "
+                                  + getField(line, "seconds") + " " + getField(line, "low") + " "
+                                  + getField(line, "high"));
+        if (!(values >> result.size >> result.noOfPoints >> result.noOfCalls >> result.noOfRepeats
+                     >> result.seconds >> result.lowSeconds >> result.highSeconds) || result.noOfRepeats == 0) {
+            throw std::runtime_error("[BENCHMARK] Baseline file '" + fileName + "' has an invalid line: "
+                                     + line + "\n");
+        }
+        baseline.push_back(result);
+    }
+    if (baseline.empty()) {
+        throw std::runtime_error("[BENCHMARK] Baseline file '" + fileName + "' holds no results\n");
+    }
+    return baseline;
+}
+
+// return table comparing results with baseline
+std::string Benchmark::compare(const std::vector<BenchmarkResult>& results,
+                               const std::vector<BenchmarkResult>& baseline, const double& threshold,
+                               unsigned& noOfRegressions) {
+    double factor{1 + threshold / 100};
+    noOfRegressions = 0;
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "-----------------------------" << std::endl
+        << "Benchmark baseline comparison, threshold " << threshold << "%" << std::endl
+        << "-----------------------------" << std::endl
+        << std::left << std::setw(20) << "Benchmark" << std::setw(14) << "Type" << std::right
+        << std::setw(10) << "Size" << std::setw(14) << "Baseline ms" << std::setw(14) << "Current ms"
+        << std::setw(10) << "Change" << "  Status" << std::endl;
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        auto base = baseline.begin();
+        while (base != baseline.end() && (base->name != it->name || base->dataType != it->dataType
+                                          || base->size != it->size)) ++base;
+        stringStream << std::left << std::setw(20) << it->name << std::setw(14) << it->dataType << std::right
+                     << std::setw(10) << it->size << std::fixed << std::setprecision(4);
+        if (base == baseline.end()) {
+            stringStream << std::setw(14) << "-" << std::setw(14) << it->seconds * 1000
+                         << std::setw(10) << "-" << "  new" << std::endl;
+            continue;
+        }
+        std::string status{"ok"};
+        if (it->seconds > base->seconds * factor && it->lowSeconds > base->highSeconds) {
+            status = "REGRESSED";
+            ++noOfRegressions;
+        } else if (it->seconds * factor < base->seconds && it->highSeconds < base->lowSeconds) {
+            status = "improved";
+        }
+        double change{base->seconds > 0 ? (it->seconds / base->seconds - 1) * 100 : 0};
+        stringStream << std::setw(14) << base->seconds * 1000 << std::setw(14) << it->seconds * 1000
+                     << std::setw(9) << std::showpos << std::setprecision(1) << change << std::noshowpos
+                     << "%  " << status << std::endl;
+    }
+    stringStream.unsetf(std::ios::fixed);
+    stringStream << "-----------------------------" << std::endl
+                 << noOfRegressions << " of " << results.size() << " benchmarks regressed" << std::endl;
+    return stringStream.str();
+}
+
+// run the benchmark suite
+int Benchmark::run(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        options = parseArguments(argc, argv);
+    }
+    catch (const std::invalid_argument& e) {
+        ErrorMsg::print(e.what());
+        ErrorMsg::print(getUsage());
+        return BATCH_USAGE_ERROR;
+    }
+    if (options.help) {
+        std::cout << getUsage();
+        return BATCH_SUCCESS;
+    }
+    // only the results go to standard output
+    ScreenMsg::quietMode = true;
+    // read the baseline first, so that a missing one fails at once
+    std::vector<BenchmarkResult> baseline;
+    if (!options.baselineFile.empty()) {
+        try {
+            baseline = readBaseline(options.baselineFile);
+        }
+        catch (const std::runtime_error& e) {
+            ErrorMsg::print(e.what());
+            return BATCH_INPUT_ERROR;
+        }
+    }
+    std::vector<BenchmarkResult> results;
+    try {
+        results = runAll(options, baseline);
+    }
+    catch (const std::invalid_argument& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_USAGE_ERROR;
+    }
+    catch (const std::runtime_error& e) {
+        ErrorMsg::print(e.what());
+        return BATCH_OUTPUT_ERROR;
+    }
+    catch (const std::exception& e) {
+        ErrorMsg::print(std::string("[BENCHMARK] Unexpected error: ") + e.what() + "\n");
+        return BATCH_FAILURE;
+    }
+    std::string json{toJson(options, results)};
+    if (options.outFile.empty()) {
+        std::cout << json;
+        if (!std::cout) return BATCH_OUTPUT_ERROR;
+    } else if (!FileMsg::print(json, options.outFile)) {
+        return BATCH_OUTPUT_ERROR;
+    }
+    if (baseline.empty()) return BATCH_SUCCESS;
+    unsigned noOfRegressions{};
+    std::clog << compare(results, baseline, options.threshold, noOfRegressions);
+    return noOfRegressions > 0 ? BATCH_REGRESSION : BATCH_SUCCESS;
+}
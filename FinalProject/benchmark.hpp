@@ -0,0 +1,167 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <vector>   // vector
+#include <cstdint>  // fixed width integers
+#include <chrono>   // steady_clock
+
+#include "msg.hpp"        // classes managing outputs
+#include "maps.hpp"       // classes managing databases
+#include "simulation.hpp" // load generator
+
+/* ------------------------------------------------------------------------
+* BENCHMARK OPTIONS AND RESULTS
+* -----------------------------------------------------------------------*/
+
+// what the benchmark suite runs
+struct BenchmarkOptions {
+    // INT, DOUBLE, COMPLEXDOUBLE or ALL
+    std::string dataType;
+    // dataset sizes in measurements, from minPoints to maxPoints in steps
+    // of ten
+    unsigned long long minPoints;
+    unsigned long long maxPoints;
+    // the input of every size and type is generated from this seed
+    std::uint64_t seed;
+    // JSON output file, standard output if empty
+    std::string outFile;
+    bool help;
+    // runs of every benchmark, summarised by their median
+    unsigned noOfRuns;
+    // JSON results of an earlier run to compare with, none if empty
+    std::string baselineFile;
+    // percentage a median may grow by over its baseline
+    double threshold;
+};
+
+// one timed benchmark
+struct BenchmarkResult {
+    // e.g. "parse-text" or "report-staff"
+    std::string name;
+    // int, double or complexdouble
+    std::string dataType;
+    // requested dataset size and measurements it holds
+    unsigned long long size;
+    unsigned long long noOfPoints;
+    // calls timed, e.g. one per project
+    unsigned long long noOfCalls;
+    // times the calls are repeated in every run
+    unsigned noOfRepeats;
+    // time of the calls in every run, divided by the repeats, their median
+    // and its 95% confidence interval
+    std::vector<double> samples;
+    double seconds;
+    double lowSeconds;
+    double highSeconds;
+};
+
+/* ------------------------------------------------------------------------
+* CLASS BENCHMARKING DATAHERO
+* -----------------------------------------------------------------------*/
+
+// Times the hot paths of DataHero over generated datasets of 10^3 to 10^8
+// measurements and writes the results as JSON, e.g.
+//   benchmark --type double --sizes 1000:1000000 --out results.json
+// Every benchmark is run several times and reported by its median, which
+// can be checked against the results of an earlier run on the same
+// machine, as timings of other machines are not comparable, e.g.
+//   benchmark --sizes 10000:100000 --baseline benchmarkBaseline.json
+// Every run repeats a benchmark a fixed number of times, taken from the
+// baseline or else from the first run, where it is repeated until it took
+// minSampleSeconds, so that a run of microseconds is timed over tens of
+// milliseconds all the same.
+// A dataset of size N is 16 projects of 4 staff members, each loaded from
+// two files of N / 32 measurements: the first file of every project is
+// inserted, the second merged into it. Both are drawn by the load
+// generator from fixed seeds, so results of two runs are comparable.
+class Benchmark {
+private:
+    // return dataset sizes of options
+    static std::vector<unsigned long long> getSizes(const BenchmarkOptions& options);
+    // return load generator configuration of one file of every project of
+    // a dataset; the second file follows the first in time
+    static SimulationConfig getConfig(const std::string& dataType, const unsigned long long& size,
+                                      const std::uint64_t& seed, const bool& secondFile);
+    // return repeats of a benchmark in reference, 0 if it is not there
+    static unsigned getRepeats(const std::vector<BenchmarkResult>& reference, const std::string& name,
+                               const std::string& dataType, const unsigned long long& size);
+    // time body noOfRepeats times, each after an untimed prepare, or if
+    // noOfRepeats is 0 until minSampleSeconds are timed and set it to the
+    // times run; returns the seconds of one repeat
+    template <typename Prepare, typename Body>
+    static double timeRepeats(unsigned& noOfRepeats, Prepare prepare, Body body);
+    // run every benchmark over a dataset of type T and size once, repeated
+    // as often as in reference
+    template <typename T> static void runOnce(const BenchmarkOptions& options, const std::string& dataType,
+                                              const unsigned long long& size,
+                                              const std::vector<BenchmarkResult>& reference,
+                                              std::vector<BenchmarkResult>& results);
+    // run every benchmark over a dataset of type T and size once, as run of
+    // all runs
+    template <typename T> static void runType(const BenchmarkOptions& options, const std::string& dataType,
+                                              const unsigned long long& size, const unsigned& run,
+                                              const std::vector<BenchmarkResult>& reference,
+                                              std::vector<BenchmarkResult>& results);
+    // check statistics which the benchmarks cannot show, throws logic_error
+    // if they are wrong
+    static void checkStatistics();
+    // set median and confidence interval of the samples of result
+    static void summarise(BenchmarkResult& result);
+    // return contents of the text and binary data file of experiment
+    template <typename T> static std::string getText(const Experiment<T>& experiment);
+    template <typename T> static std::string getBinary(const Experiment<T>& experiment);
+    // return seconds elapsed since start
+    static double getSecondsSince(const std::chrono::steady_clock::time_point& start);
+    // command line parsing helpers
+    static unsigned long long toSize(const std::string& text);
+    static std::string getValue(int argc, char* argv[], int& i);
+    // return value of key in a line of JSON results, empty if not found
+    static std::string getField(const std::string& line, const std::string& key);
+
+public:
+    // smallest and largest dataset size
+    static const unsigned long long minSize;
+    static const unsigned long long maxSize;
+    // largest dataset the show and dump benchmarks are run on, as they
+    // build the whole output in memory
+    static const unsigned long long maxOutputSize;
+    // least time of the repeats of a benchmark in every run, which keeps
+    // the samples of fast benchmarks well above the timer and scheduler
+    // noise, and most repeats
+    static const double minSampleSeconds;
+    static const unsigned maxRepeats;
+    // scratch file of the file reading and writing benchmarks, in the
+    // working directory
+    static const char* scratchFile;
+    // scratch directory the load generator writes to and the generated
+    // files are loaded back from, in the working directory
+    static const char* scratchDirectory;
+
+    // parse command line, throws invalid_argument if it cannot be understood
+    static BenchmarkOptions parseArguments(int argc, char* argv[]);
+    // return command line usage instructions
+    static std::string getUsage();
+    // run benchmarks of options, repeated as often as in baseline, throws
+    // invalid_argument if a dataset cannot be generated, runtime_error if
+    // the scratch files cannot be written or generated files do not load
+    // back and logic_error if statistics are wrong
+    static std::vector<BenchmarkResult> runAll(const BenchmarkOptions& options,
+                                               const std::vector<BenchmarkResult>& baseline);
+    // return results as JSON
+    static std::string toJson(const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results);
+    // read results written by toJson, throws runtime_error if the file
+    // cannot be read
+    static std::vector<BenchmarkResult> readBaseline(const std::string& fileName);
+    // return table comparing results with baseline; a benchmark regressed
+    // if its median grew by more than threshold percent and its confidence
+    // interval lies above the baseline one
+    static std::string compare(const std::vector<BenchmarkResult>& results,
+                               const std::vector<BenchmarkResult>& baseline, const double& threshold,
+                               unsigned& noOfRegressions);
+    // run the benchmark suite, returns one of BatchExitCode
+    static int run(int argc, char* argv[]);
+};
+
+#endif /* BENCHMARK_HPP */
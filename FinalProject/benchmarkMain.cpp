@@ -0,0 +1,9 @@
+#include "benchmark.hpp" // benchmark suite
+
+/* ------------------------------------------------------------------------
+* BENCHMARK PROGRAM
+* -----------------------------------------------------------------------*/
+
+int main(int argc, char* argv[]) {
+    return Benchmark::run(argc, argv);
+}
@@ -0,0 +1,97 @@
+#ifndef BINARY_FORMAT_HPP
+#define BINARY_FORMAT_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <complex>  // complex numbers
+#include <cstdint>  // fixed width integers
+
+/* ------------------------------------------------------------------------
+* BINARY DATA FILE FORMAT
+* -----------------------------------------------------------------------*/
+
+// Binary data file, written by the load generator and read wherever text
+// data files are, in native (little-endian) byte order:
+//   4 bytes    "DHB1"
+//   1 byte     value type: 0 int, 1 double, 2 complex double
+//   4 bytes    length of staff name, then its characters
+//   4 bytes    length of project name, then its characters
+//   8 bytes    number of measurements
+//   then per measurement a 4 byte timestamp followed by the value as a
+//   4 byte int, an 8 byte double or two 8 byte doubles
+struct BinaryFormat {
+    // first bytes of every binary data file
+    static const char* getMagic() { return "DHB1"; }
+
+    // return true if text starts like a binary data file
+    static bool isBinary(const std::string& text) {
+        return text.size() >= 5 && text.compare(0, 4, getMagic(), 4) == 0;
+    }
+
+    // type code of values
+    static unsigned char getTypeCode(const int&) { return 0; }
+    static unsigned char getTypeCode(const double&) { return 1; }
+    static unsigned char getTypeCode(const std::complex<double>&) { return 2; }
+
+    // append fixed width integer or string to buffer
+    template <typename Integer> static void append(std::string& buffer, const Integer& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(Integer));
+    }
+    static void appendName(std::string& buffer, const std::string& name) {
+        append(buffer, static_cast<std::uint32_t>(name.size()));
+        buffer.append(name);
+    }
+
+    // append value to buffer
+    static void appendValue(std::string& buffer, const int& value) {
+        append(buffer, static_cast<std::int32_t>(value));
+    }
+    static void appendValue(std::string& buffer, const double& value) {
+        append(buffer, value);
+    }
+    static void appendValue(std::string& buffer, const std::complex<double>& value) {
+        append(buffer, value.real());
+        append(buffer, value.imag());
+    }
+
+    // append file header to buffer
+    template <typename T> static void appendHeader(std::string& buffer, const std::string& staffName,
+                                                   const std::string& projectName,
+                                                   const std::uint64_t& noOfMeasurements) {
+        buffer.append(getMagic(), 4);
+        buffer.push_back(static_cast<char>(getTypeCode(T())));
+        appendName(buffer, staffName);
+        appendName(buffer, projectName);
+        append(buffer, noOfMeasurements);
+    }
+
+    // read fixed width integer or string from stream, false at its end
+    template <typename Integer> static bool read(std::istream& inStream, Integer& value) {
+        return static_cast<bool>(inStream.read(reinterpret_cast<char*>(&value), sizeof(Integer)));
+    }
+    static bool readName(std::istream& inStream, std::string& name) {
+        std::uint32_t length{};
+        if (!read(inStream, length)) return false;
+        name.resize(length);
+        return length == 0 || static_cast<bool>(inStream.read(&name[0], length));
+    }
+
+    // read value from stream, false at its end
+    static bool readValue(std::istream& inStream, int& value) {
+        std::int32_t stored{};
+        if (!read(inStream, stored)) return false;
+        value = stored;
+        return true;
+    }
+    static bool readValue(std::istream& inStream, double& value) {
+        return read(inStream, value);
+    }
+    static bool readValue(std::istream& inStream, std::complex<double>& value) {
+        double real{}, imag{};
+        if (!read(inStream, real) || !read(inStream, imag)) return false;
+        value = std::complex<double>(real, imag);
+        return true;
+    }
+};
+
+#endif /* BINARY_FORMAT_HPP */
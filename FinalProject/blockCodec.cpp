@@ -0,0 +1,360 @@
+#include <cstring>   // memcpy
+#include <algorithm> // minmax_element
+#if defined(__AVX2__)
+#include <immintrin.h> // AVX2 intrinsics
+#endif
+
+#include "blockCodec.hpp" // encodings of time series blocks
+
+/* ------------------------------------------------------------------------
+* BLOCK STORAGE OPTIONS
+* -----------------------------------------------------------------------*/
+
+// blocks are stored uncompressed by default
+bool BlockStorage::compressBlocks{false};
+
+/* ------------------------------------------------------------------------
+* HELPER FUNCTIONS FOR BIT MANIPULATION
+* -----------------------------------------------------------------------*/
+
+// number of leading zero bits of non-zero word
+static unsigned countLeadingZeros(std::uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_clzll(word);
+#else
+    unsigned count{};
+    while (!(word & (1ULL << 63))) { word <<= 1; ++count; }
+    return count;
+#endif
+}
+
+// number of trailing zero bits of non-zero word
+static unsigned countTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    unsigned count{};
+    while (!(word & 1)) { word >>= 1; ++count; }
+    return count;
+#endif
+}
+
+// map signed integer to unsigned, small magnitudes to small values
+static std::uint64_t zigZagEncode(const std::int64_t& value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+static std::int64_t zigZagDecode(const std::uint64_t& value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE BIT STREAMS
+* -----------------------------------------------------------------------*/
+
+// parametrised constructor
+BitWriter::BitWriter(ArenaVector<std::uint64_t>& userWords) : words(userWords), usedBits{64} {}
+
+// write lowest noOfBits bits of value
+void BitWriter::write(const std::uint64_t& value, const unsigned& noOfBits) {
+    std::uint64_t bits{noOfBits < 64 ? value & ((1ULL << noOfBits) - 1) : value};
+    if (usedBits == 64) {
+        words.push_back(0);
+        usedBits = 0;
+    }
+    unsigned freeBits{64 - usedBits};
+    if (noOfBits <= freeBits) {
+        words.back() |= bits << (freeBits - noOfBits);
+        usedBits += noOfBits;
+    } else {
+        // split field over two words
+        unsigned rest{noOfBits - freeBits};
+        words.back() |= bits >> rest;
+        words.push_back(bits << (64 - rest));
+        usedBits = rest;
+    }
+}
+
+// parametrised constructor
+BitReader::BitReader(const ArenaVector<std::uint64_t>& userWords) : words(userWords), word{}, usedBits{} {}
+
+// read noOfBits bits
+std::uint64_t BitReader::read(const unsigned& noOfBits) {
+    unsigned availableBits{64 - usedBits};
+    std::uint64_t value;
+    if (noOfBits <= availableBits) {
+        value = (words[word] << usedBits) >> (64 - noOfBits);
+        usedBits += noOfBits;
+    } else {
+        // field continues in the next word
+        unsigned rest{noOfBits - availableBits};
+        std::uint64_t high{(words[word] << usedBits) >> (64 - availableBits)};
+        ++word;
+        value = (high << rest) | (words[word] >> (64 - rest));
+        usedBits = rest;
+    }
+    if (usedBits == 64) {
+        ++word;
+        usedBits = 0;
+    }
+    return value;
+}
+
+// read one bit
+bool BitReader::readBit() {
+    return this->read(1) != 0;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE TIMESTAMP CODEC
+* -----------------------------------------------------------------------*/
+
+// encode non-decreasing timestamps
+void TimestampCodec::encode(const ColumnView<unsigned>& timestamps, ArenaVector<std::uint64_t>& words) {
+    if (timestamps.empty()) return;
+    BitWriter writer(words);
+    writer.write(timestamps[0], 32);
+    std::int64_t previousDelta{};
+    for (std::size_t i{1}; i < timestamps.size(); ++i) {
+        std::int64_t delta{static_cast<std::int64_t>(timestamps[i]) - timestamps[i - 1]};
+        std::uint64_t deltaOfDelta{zigZagEncode(delta - previousDelta)};
+        previousDelta = delta;
+        // prefix code selecting the field width
+        if (deltaOfDelta == 0) {
+            writer.write(0, 1);
+        } else if (deltaOfDelta < (1ULL << 7)) {
+            writer.write(2, 2);
+            writer.write(deltaOfDelta, 7);
+        } else if (deltaOfDelta < (1ULL << 9)) {
+            writer.write(6, 3);
+            writer.write(deltaOfDelta, 9);
+        } else if (deltaOfDelta < (1ULL << 12)) {
+            writer.write(14, 4);
+            writer.write(deltaOfDelta, 12);
+        } else {
+            // any change of a 32-bit delta fits in 33 bits
+            writer.write(15, 4);
+            writer.write(deltaOfDelta, 33);
+        }
+    }
+}
+
+// decode count timestamps
+void TimestampCodec::decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                            ArenaVector<unsigned>& timestamps) {
+    timestamps.resize(count);
+    if (count == 0) return;
+    BitReader reader(words);
+    std::int64_t timestamp{static_cast<std::int64_t>(reader.read(32))};
+    timestamps[0] = static_cast<unsigned>(timestamp);
+    std::int64_t delta{};
+    for (std::size_t i{1}; i < count; ++i) {
+        if (reader.readBit()) {
+            unsigned noOfBits{33};
+            if (!reader.readBit()) noOfBits = 7;
+            else if (!reader.readBit()) noOfBits = 9;
+            else if (!reader.readBit()) noOfBits = 12;
+            delta += zigZagDecode(reader.read(noOfBits));
+        }
+        timestamp += delta;
+        timestamps[i] = static_cast<unsigned>(timestamp);
+    }
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE DOUBLE CODEC
+* -----------------------------------------------------------------------*/
+
+// default constructor - no bit window yet
+GorillaEncoder::GorillaEncoder() : previous{}, leadingZeros{65}, trailingZeros{}, first{true} {}
+
+// write value
+void GorillaEncoder::write(const double& value, BitWriter& writer) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (first) {
+        writer.write(bits, 64);
+        previous = bits;
+        first = false;
+        return;
+    }
+    std::uint64_t xorBits{bits ^ previous};
+    previous = bits;
+    if (xorBits == 0) {
+        // same value as before
+        writer.write(0, 1);
+        return;
+    }
+    unsigned leading{countLeadingZeros(xorBits)};
+    unsigned trailing{countTrailingZeros(xorBits)};
+    // leading zero count is stored in 5 bits
+    if (leading > 31) leading = 31;
+    if (leading >= leadingZeros && trailing >= trailingZeros) {
+        // meaningful bits fit in the previous window
+        writer.write(2, 2);
+        writer.write(xorBits >> trailingZeros, 64 - leadingZeros - trailingZeros);
+    } else {
+        // new window: leading zeros, length - 1, meaningful bits
+        unsigned meaningfulBits{64 - leading - trailing};
+        writer.write(3, 2);
+        writer.write(leading, 5);
+        writer.write(meaningfulBits - 1, 6);
+        writer.write(xorBits >> trailing, meaningfulBits);
+        leadingZeros = leading;
+        trailingZeros = trailing;
+    }
+}
+
+// default constructor
+GorillaDecoder::GorillaDecoder() : previous{}, leadingZeros{}, trailingZeros{}, first{true} {}
+
+// read value
+double GorillaDecoder::read(BitReader& reader) {
+    if (first) {
+        previous = reader.read(64);
+        first = false;
+    } else if (reader.readBit()) {
+        if (reader.readBit()) {
+            leadingZeros = static_cast<unsigned>(reader.read(5));
+            unsigned meaningfulBits{static_cast<unsigned>(reader.read(6)) + 1};
+            trailingZeros = 64 - leadingZeros - meaningfulBits;
+        }
+        previous ^= reader.read(64 - leadingZeros - trailingZeros) << trailingZeros;
+    }
+    double value;
+    std::memcpy(&value, &previous, sizeof(value));
+    return value;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE FRAME OF REFERENCE CODEC FOR INTEGERS
+* -----------------------------------------------------------------------*/
+
+// Layout: word 0 holds the base in its low 32 bits and the bit width above
+// them, the following words hold the packed differences, least significant
+// bit first, followed by 8 bytes of padding so that any field can be read
+// with one unaligned 32-bit load.
+
+// mask of the lowest width bits
+static std::uint32_t getFieldMask(const unsigned& width) {
+    return width >= 32 ? 0xffffffffu : (1u << width) - 1;
+}
+
+// packed differences follow the word holding base and bit width
+static const unsigned char* getPackedBytes(const ArenaVector<std::uint64_t>& words) {
+    return reinterpret_cast<const unsigned char*>(words.data() + 1);
+}
+
+// read difference i from packed bytes
+static std::uint32_t unpackField(const unsigned char* bytes, const std::size_t& i, const unsigned& width) {
+    std::size_t bit{i * width};
+    // a field of up to 32 bits starting anywhere in a byte spans at most 5 bytes
+    std::uint64_t window{};
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    std::memcpy(&window, bytes + (bit >> 3), sizeof(window));
+#else
+    for (unsigned k{}; k < 5; ++k) window |= static_cast<std::uint64_t>(bytes[(bit >> 3) + k]) << (8 * k);
+#endif
+    return static_cast<std::uint32_t>(window >> (bit & 7)) & getFieldMask(width);
+}
+
+#if defined(__AVX2__)
+// read differences i to i + 7; fields of up to 25 bits fit in one unaligned
+// 32-bit load after shifting out at most 7 bits
+static __m256i unpackFields(const unsigned char* bytes, const std::size_t& i, const unsigned& width) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i index = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lanes);
+    __m256i bits = _mm256_mullo_epi32(index, _mm256_set1_epi32(static_cast<int>(width)));
+    __m256i fields = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bytes), _mm256_srli_epi32(bits, 3), 1);
+    fields = _mm256_srlv_epi32(fields, _mm256_and_si256(bits, _mm256_set1_epi32(7)));
+    return _mm256_and_si256(fields, _mm256_set1_epi32(static_cast<int>(getFieldMask(width))));
+}
+#endif
+
+// encode values as differences from the smallest one
+void ValueCodec<int>::encode(const ColumnView<int>& values, ArenaVector<std::uint64_t>& words) {
+    if (values.empty()) return;
+    auto range = std::minmax_element(values.begin(), values.end());
+    std::uint32_t base{static_cast<std::uint32_t>(*range.first)};
+    std::uint32_t largestDifference{static_cast<std::uint32_t>(*range.second) - base};
+    unsigned width{};
+    while (width < 32 && (largestDifference >> width) != 0) ++width;
+    std::size_t noOfBytes{(values.size() * width + 7) / 8 + 8};
+    words.assign(1 + (noOfBytes + 7) / 8, 0);
+    words[0] = base | (static_cast<std::uint64_t>(width) << 32);
+    unsigned char* bytes{reinterpret_cast<unsigned char*>(words.data() + 1)};
+    for (std::size_t i{}; i < values.size(); ++i) {
+        std::uint64_t field{static_cast<std::uint32_t>(values[i]) - base};
+        std::size_t bit{i * width};
+        for (unsigned k{}; k < 5; ++k) {
+            bytes[(bit >> 3) + k] |= static_cast<unsigned char>((field << (bit & 7)) >> (8 * k));
+        }
+    }
+}
+
+// decode count values
+void ValueCodec<int>::decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                             ArenaVector<int>& values) {
+    values.resize(count);
+    if (count == 0) return;
+    std::uint32_t base{static_cast<std::uint32_t>(words[0])};
+    unsigned width{static_cast<unsigned>(words[0] >> 32)};
+    const unsigned char* bytes{getPackedBytes(words)};
+    std::size_t i{};
+#if defined(__AVX2__)
+    if (width <= 25) {
+        __m256i baseVector = _mm256_set1_epi32(static_cast<int>(base));
+        for (; i + 8 <= count; i += 8) {
+            __m256i fields = _mm256_add_epi32(unpackFields(bytes, i, width), baseVector);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&values[i]), fields);
+        }
+    }
+#endif
+    for (; i < count; ++i) values[i] = static_cast<int>(base + unpackField(bytes, i, width));
+}
+
+// add values [first, last) to aggregate from the packed differences:
+// sum(d + base) and sum((d + base)^2) follow from sum(d) and sum(d^2)
+void ValueCodec<int>::addRange(const ArenaVector<std::uint64_t>& words, const std::size_t&,
+                               const std::size_t& first, const std::size_t& last, Aggregate<int>& aggregate) {
+    if (first >= last) return;
+    std::uint32_t base{static_cast<std::uint32_t>(words[0])};
+    unsigned width{static_cast<unsigned>(words[0] >> 32)};
+    const unsigned char* bytes{getPackedBytes(words)};
+    std::uint64_t sum{};
+    std::uint64_t sumOfSquares{};
+    std::size_t i{first};
+#if defined(__AVX2__)
+    if (width <= 25) {
+        // 64-bit lanes: squares of 25-bit fields need up to 50 bits
+        __m256i sumVector = _mm256_setzero_si256();
+        __m256i sumOfSquaresVector = _mm256_setzero_si256();
+        for (; i + 8 <= last; i += 8) {
+            __m256i fields = unpackFields(bytes, i, width);
+            __m256i low = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(fields));
+            __m256i high = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(fields, 1));
+            sumVector = _mm256_add_epi64(sumVector, _mm256_add_epi64(low, high));
+            sumOfSquaresVector = _mm256_add_epi64(sumOfSquaresVector,
+                _mm256_add_epi64(_mm256_mul_epu32(low, low), _mm256_mul_epu32(high, high)));
+        }
+        std::uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sumVector);
+        sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sumOfSquaresVector);
+        sumOfSquares += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+    for (; i < last; ++i) {
+        std::uint64_t field{unpackField(bytes, i, width)};
+        sum += field;
+        sumOfSquares += field * field;
+    }
+    // shift differences from base to pivot, in wrapping arithmetic like
+    // adding the values one by one
+    std::uint64_t count{last - first};
+    std::uint64_t shift{static_cast<std::uint64_t>(static_cast<long long>(static_cast<int>(base))
+                                                   - aggregate.pivot)};
+    aggregate.count += count;
+    aggregate.sum += static_cast<long long>(count * shift + sum);
+    aggregate.sumOfSquares += static_cast<long long>(count * shift * shift + 2 * shift * sum + sumOfSquares);
+}
@@ -0,0 +1,223 @@
+#ifndef BLOCK_CODEC_HPP
+#define BLOCK_CODEC_HPP
+
+#include <iostream> // std
+#include <vector>   // vector
+#include <complex>  // complex numbers
+#include <cstdint>  // fixed width integers
+
+#include "msg.hpp"            // classes managing outputs
+#include "aggregateIndex.hpp" // aggregates of measurements
+#include "arena.hpp"          // pooled memory of one dataset
+
+/* ------------------------------------------------------------------------
+* BLOCK STORAGE OPTIONS
+* -----------------------------------------------------------------------*/
+
+class BlockStorage {
+public:
+    // compressed blocks on/off, when on every block is encoded after bulk
+    // updates and full blocks as soon as they fill up
+    static bool compressBlocks;
+};
+
+/* ------------------------------------------------------------------------
+* COLUMN VIEWS
+* -----------------------------------------------------------------------*/
+
+// read-only view of count elements of a block column, wherever the column
+// is stored
+template <typename U> class ColumnView {
+private:
+    const U* first;
+    std::size_t count;
+public:
+    // parametrised constructors
+    ColumnView(const U* userFirst, const std::size_t& userCount) : first{userFirst}, count{userCount} {}
+    ColumnView(const ArenaVector<U>& column) : first{column.data()}, count{column.size()} {}
+
+    // access functions
+    const U* begin() const { return this->first; }
+    const U* end() const { return this->first + this->count; }
+    std::size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+    const U& operator[](const std::size_t& i) const { return this->first[i]; }
+};
+
+/* ------------------------------------------------------------------------
+* BIT STREAMS
+* -----------------------------------------------------------------------*/
+
+// appends bit fields, most significant bit first, to 64-bit words
+class BitWriter {
+private:
+    ArenaVector<std::uint64_t>& words;
+    // bits used in the last word
+    unsigned usedBits;
+public:
+    // parametrised constructor - writes to the end of userWords
+    BitWriter(ArenaVector<std::uint64_t>& userWords);
+    // write lowest noOfBits bits of value, noOfBits in [1, 64]
+    void write(const std::uint64_t& value, const unsigned& noOfBits);
+};
+
+// reads bit fields written by BitWriter
+class BitReader {
+private:
+    const ArenaVector<std::uint64_t>& words;
+    std::size_t word;
+    unsigned usedBits;
+public:
+    // parametrised constructor - reads from the start of userWords
+    BitReader(const ArenaVector<std::uint64_t>& userWords);
+    // read noOfBits bits, noOfBits in [1, 64]
+    std::uint64_t read(const unsigned& noOfBits);
+    // read one bit
+    bool readBit();
+};
+
+/* ------------------------------------------------------------------------
+* TIMESTAMP CODEC: DELTA OF DELTA
+* -----------------------------------------------------------------------*/
+
+// Timestamps of a block are stored as the first timestamp, the first delta
+// and then the change of delta from one timestamp to the next, which for
+// regular second-resolution data is almost always zero and takes one bit.
+class TimestampCodec {
+public:
+    static void encode(const ColumnView<unsigned>& timestamps, ArenaVector<std::uint64_t>& words);
+    static void decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                       ArenaVector<unsigned>& timestamps);
+};
+
+/* ------------------------------------------------------------------------
+* DOUBLE CODEC: XOR WITH PREVIOUS VALUE (GORILLA)
+* -----------------------------------------------------------------------*/
+
+// Each double is XORed with the previous one. Identical values take one
+// bit, slowly varying values share sign, exponent and leading mantissa
+// bits and only the meaningful bits of the XOR are written, reusing the
+// previous bit window when it still fits.
+class GorillaEncoder {
+private:
+    std::uint64_t previous;
+    unsigned leadingZeros;
+    unsigned trailingZeros;
+    bool first;
+public:
+    // default constructor
+    GorillaEncoder();
+    void write(const double& value, BitWriter& writer);
+};
+
+class GorillaDecoder {
+private:
+    std::uint64_t previous;
+    unsigned leadingZeros;
+    unsigned trailingZeros;
+    bool first;
+public:
+    // default constructor
+    GorillaDecoder();
+    double read(BitReader& reader);
+};
+
+/* ------------------------------------------------------------------------
+* VALUE CODECS FOR EVERY DATA TYPE
+* -----------------------------------------------------------------------*/
+
+// Every codec can add a range [first, last) of its encoded values to an
+// aggregate; codecs that cannot reduce encoded data decode the block first.
+
+// integer values are stored with their full width
+template <typename T> struct ValueCodec {
+    static void encode(const ColumnView<T>& values, ArenaVector<std::uint64_t>& words) {
+        BitWriter writer(words);
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            writer.write(static_cast<std::uint64_t>(*it), 8 * sizeof(T));
+        }
+    }
+    static void decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                       ArenaVector<T>& values) {
+        BitReader reader(words);
+        values.resize(count);
+        for (std::size_t i{}; i < count; ++i) {
+            // sign extend from the stored width
+            std::uint64_t bits{reader.read(8 * sizeof(T)) << (64 - 8 * sizeof(T))};
+            values[i] = static_cast<T>(static_cast<std::int64_t>(bits) >> (64 - 8 * sizeof(T)));
+        }
+    }
+    static void addRange(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                         const std::size_t& first, const std::size_t& last, Aggregate<T>& aggregate) {
+        ArenaVector<T> values;
+        decode(words, count, values);
+        for (std::size_t i{first}; i < last; ++i) aggregate.add(values[i]);
+    }
+};
+
+// Frame of reference: every value is stored as its difference from the
+// smallest value of the block, packed into as many bits as the largest
+// difference needs, e.g. 6 bits for values between 50 and 100. Sums are
+// computed on the packed differences without decoding, with AVX2 when the
+// compiler targets it (make AVX2=1).
+template <> struct ValueCodec<int> {
+    static void encode(const ColumnView<int>& values, ArenaVector<std::uint64_t>& words);
+    static void decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                       ArenaVector<int>& values);
+    static void addRange(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                         const std::size_t& first, const std::size_t& last, Aggregate<int>& aggregate);
+};
+
+template <> struct ValueCodec<double> {
+    static void encode(const ColumnView<double>& values, ArenaVector<std::uint64_t>& words) {
+        BitWriter writer(words);
+        GorillaEncoder encoder;
+        for (auto it = values.begin(); it != values.end(); ++it) encoder.write(*it, writer);
+    }
+    static void decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                       ArenaVector<double>& values) {
+        BitReader reader(words);
+        GorillaDecoder decoder;
+        values.resize(count);
+        for (std::size_t i{}; i < count; ++i) values[i] = decoder.read(reader);
+    }
+    static void addRange(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                         const std::size_t& first, const std::size_t& last, Aggregate<double>& aggregate) {
+        ArenaVector<double> values;
+        decode(words, count, values);
+        for (std::size_t i{first}; i < last; ++i) aggregate.add(values[i]);
+    }
+};
+
+// real and imaginary parts are two interleaved XOR streams
+template <> struct ValueCodec<std::complex<double>> {
+    static void encode(const ColumnView<std::complex<double>>& values, ArenaVector<std::uint64_t>& words) {
+        BitWriter writer(words);
+        GorillaEncoder realEncoder;
+        GorillaEncoder imagEncoder;
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            realEncoder.write(it->real(), writer);
+            imagEncoder.write(it->imag(), writer);
+        }
+    }
+    static void decode(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                       ArenaVector<std::complex<double>>& values) {
+        BitReader reader(words);
+        GorillaDecoder realDecoder;
+        GorillaDecoder imagDecoder;
+        values.resize(count);
+        for (std::size_t i{}; i < count; ++i) {
+            double real{realDecoder.read(reader)};
+            values[i] = std::complex<double>(real, imagDecoder.read(reader));
+        }
+    }
+    static void addRange(const ArenaVector<std::uint64_t>& words, const std::size_t& count,
+                         const std::size_t& first, const std::size_t& last,
+                         Aggregate<std::complex<double>>& aggregate) {
+        ArenaVector<std::complex<double>> values;
+        decode(words, count, values);
+        for (std::size_t i{first}; i < last; ++i) aggregate.add(values[i]);
+    }
+};
+
+#endif /* BLOCK_CODEC_HPP */
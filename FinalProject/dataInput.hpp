@@ -5,21 +5,39 @@
 #include <vector>    // vector
 #include <string>    // string
 #include <sstream>   // stringstream
+#include <utility>   // move
+#ifdef _WIN32
 #include "dirent.h"  // read all files in directory 
+#else
+#include <dirent.h>  // read all files in directory 
+#endif
+#include <map>       // map
+#include <thread>    // thread
+#include <atomic>    // atomic
+#include <fstream>   // ifstream
+#include <cctype>    // isalpha
 #include "msg.hpp"   // classes managing outputs
+#include "filePath.hpp" // join directory and file names
 #include "maps.hpp"  // classes managing databases
+#include "ingestQueue.hpp" // lock-free queue between producers and data owner
+#include "mixedDataManager.hpp" // dataset of int, double and complex series
+#include "shardedDataManager.hpp" // dataset for concurrent inserts
+#include "trace.hpp" // hot path tracing
 
 /* ------------------------------------------------------------------------
 * DEFINE TEMPLATE FOR GETTING DATA FROM FILE AND SCREEN
 * -----------------------------------------------------------------------*/
 
 template <typename T> class DataInput {
+	// reads files of all types
+	friend class MixedDataInput;
 private:
 
 	// function which gets a list of files from directory 
 	// (except the ones that begin with a dot)
 	static bool getFileList(std::vector<std::string>& fileList, 
 						    const std::string& dataPath) {
+		TraceSpan traceSpan("DataInput::getFileList", "list");
 		// pointer to directory
 	    DIR *d;
 	    struct dirent *dir;
@@ -32,7 +50,7 @@ private:
 		    	// if regular directory and file name does not start with "."
 				if (dir->d_type == DT_REG && dir->d_name[0] != '.') {
 					// save file name
-					fileList.push_back(dataPath + "\\" + dir->d_name);
+					fileList.push_back(joinPath(dataPath, dir->d_name));
 			    	++i;
 			    }
 			}
@@ -49,11 +67,29 @@ private:
 		}
 		return true;
 	}
+
+	// print how many of the listed files could not be read, return false if
+	// none could or if allFiles are required and any could not
+	static bool checkFilesRead(const std::size_t& noOfFailed, const std::size_t& noOfFiles,
+							   const std::string& dataPath, const bool& allFiles) {
+		if (noOfFailed == 0) return true;
+		std::ostringstream stringStream;
+		stringStream << std::endl
+			<< "[DATA-INPUT] " << noOfFailed << " of " << noOfFiles << " files could not be read!" << std::endl
+			<< "[DATA-INPUT] Looked in directory: "<< dataPath << std::endl;
+		ErrorMsg::print(stringStream.str());
+		return noOfFailed < noOfFiles && !allFiles;
+	}
 	
 public:
-	// function that reads in data from file into data maps
-	static bool readFromFile(DataManager<T>& data, 
-						     const std::string& dataPath) {
+	// function that reads in data from file into data maps, skipping files
+	// which cannot be read; return false if no file could be read, or any
+	// if allFiles are required. Data is a DataManager<T> or a
+	// ShardedDataManager<T>
+	template <typename Data>
+	static bool readFromFile(Data& data, 
+						     const std::string& dataPath, const bool& allFiles = false) {
+		TraceSpan traceSpan("DataInput::readFromFile", "load");
 		// declare vector for saving file names
 		std::vector<std::string> fileList;
         try {
@@ -61,29 +97,100 @@ public:
 			getFileList(fileList, dataPath);
 			// count number of files
 			size_t noOfFiles{fileList.size()};
+			size_t noOfFailed{};
 			// loop through all files
 			for (size_t i{}; i < noOfFiles; ++i) {
-				// declare experiment object
-				Experiment<T> userExperiment;
+				// declare experiment object, its measurements go to the arena
+				// of the dataset and reuse memory released by earlier files
+				Experiment<T> userExperiment(data.getArena());
 				// pass file name to experiment read from file function
-				userExperiment.readFromFile(fileList[i]);
+				if (!userExperiment.readFromFile(fileList[i])) {
+					++noOfFailed;
+					continue;
+				}
 				// insert data into maps
-				data.insertExperiment(userExperiment);
+				data.insertExperiment(std::move(userExperiment));
 			}  
+			return checkFilesRead(noOfFailed, noOfFiles, dataPath, allFiles);
         }
         catch (const std::invalid_argument& e) {
             ErrorMsg::print(e.what());
             return false;
         }
-        return true;
 	}	
 
+	// function that reads in data from file into data maps using
+	// noOfProducers parser threads; parsed experiments go through an
+	// IngestQueue to the calling thread, which alone touches the data and
+	// inserts them in file order, a drained batch at a time, so the result
+	// is the same as that of readFromFile. Queue counters go to stats. A
+	// ShardedDataManager<T> inserts every batch shard by shard in parallel.
+	template <typename Data>
+	static bool readFromFileQueued(Data& data, const std::string& dataPath,
+								   const unsigned& noOfProducers, IngestStats& stats,
+								   const bool& allFiles = false) {
+		TraceSpan traceSpan("DataInput::readFromFileQueued", "load");
+		std::vector<std::string> fileList;
+		try {
+			getFileList(fileList, dataPath);
+		}
+		catch (const std::invalid_argument& e) {
+			ErrorMsg::print(e.what());
+			return false;
+		}
+		// file index travels with the experiment
+		typedef std::pair<std::size_t, Experiment<T>> IngestItem;
+		IngestQueue<IngestItem> queue;
+		std::atomic<std::size_t> nextFile{0};
+		std::atomic<std::size_t> noOfFailed{0};
+		// set by the producer of a file before it is queued
+		std::vector<char> failed(fileList.size(), 0);
+		std::atomic<unsigned> noOfRunning{noOfProducers};
+		std::vector<std::thread> producers;
+		for (unsigned p{}; p < noOfProducers; ++p) {
+			producers.push_back(std::thread([&]() {
+				for (std::size_t i{nextFile++}; i < fileList.size(); i = nextFile++) {
+					// the arena belongs to the consumer, so parse into the heap
+					Experiment<T> userExperiment;
+					// a file which cannot be read still goes through the
+					// queue, so that later files are not held back
+					if (!userExperiment.readFromFile(fileList[i])) {
+						failed[i] = 1;
+						++noOfFailed;
+					}
+					queue.push(IngestItem(i, std::move(userExperiment)));
+				}
+				if (--noOfRunning == 0) queue.close();
+			}));
+		}
+		// experiments which arrived ahead of an earlier file
+		std::map<std::size_t, Experiment<T>> pending;
+		std::size_t nextInsert{};
+		while (!queue.isDone()) {
+			std::size_t drained{queue.drain([&](std::vector<IngestItem>& items) {
+				for (auto it = items.begin(); it != items.end(); ++it) {
+					pending.insert(std::make_pair(it->first, std::move(it->second)));
+				}
+				std::vector<Experiment<T>> batch;
+				for (auto it = pending.begin(); it != pending.end() && it->first == nextInsert; it = pending.erase(it)) {
+					if (!failed[it->first]) batch.push_back(std::move(it->second));
+					++nextInsert;
+				}
+				data.insertExperiments(std::move(batch));
+			})};
+			if (drained == 0) std::this_thread::yield();
+		}
+		for (auto it = producers.begin(); it != producers.end(); ++it) it->join();
+		stats = queue.getStats();
+		return checkFilesRead(noOfFailed, fileList.size(), dataPath, allFiles);
+	}
+
 	// function that reads in data from screen into data maps
 	static bool readFromScreen(DataManager<T>& data) {
 		bool finished{false};
 		while (!finished) {
-			// declare experiment object
-			Experiment<T> experiment;
+			// declare experiment object in the arena of the dataset
+			Experiment<T> experiment(data.getArena());
 			try {
 				// call read from screen function
 				experiment.readFromScreen();
@@ -93,7 +200,7 @@ public:
 	            return false;
 	        }
 			// insert data into maps
-			data.insertExperiment(experiment);
+			data.insertExperiment(std::move(experiment));
 			ScreenMsg::print("Type <y> to add another experiment ");
 			ScreenMsg::print("or any other letter to finish >> ");
 	        std::string reply{getInput<std::string>()};
@@ -111,4 +218,90 @@ public:
 	}	
 };
 
+/* ------------------------------------------------------------------------
+* DEFINE CLASS FOR GETTING DATA OF DETECTED TYPES FROM FILE
+* -----------------------------------------------------------------------*/
+
+class MixedDataInput {
+private:
+
+	// parse contents of a data file as type T and insert them
+	template <typename T> static void insertContents(MixedDataManager& data, const std::string& contents) {
+		// the experiment may be converted to the type of its project, so
+		// it is parsed into the heap
+		Experiment<T> userExperiment;
+		std::istringstream inStream(contents);
+		userExperiment.readFromStream(inStream);
+		data.insertExperiment(std::move(userExperiment));
+	}
+
+public:
+	// return type of the values in contents of a data file: complex if any
+	// value is in brackets, double if any has a decimal point, exponent or
+	// is not a number, int otherwise; binary data files name their type
+	static SeriesType detectSeriesType(const std::string& contents) {
+		if (BinaryFormat::isBinary(contents) && static_cast<unsigned char>(contents[4]) <= 2) {
+			return static_cast<SeriesType>(contents[4]);
+		}
+		std::istringstream inStream(contents);
+		// skip header: labelled staff and project names and horizontal line
+		std::string temporary;
+		inStream >> temporary >> temporary >> temporary >> temporary >> temporary;
+		SeriesType type{SeriesType::INT};
+		if (!inStream) return type;
+		for (std::size_t i(inStream.tellg()); i < contents.size(); ++i) {
+			if (contents[i] == '(') return SeriesType::COMPLEXDOUBLE;
+			if (contents[i] == '.' || std::isalpha(static_cast<unsigned char>(contents[i]))) {
+				type = SeriesType::DOUBLE;
+			}
+		}
+		return type;
+	}
+
+	// function that reads in data from file into data maps in one pass
+	// over the directory, each file as the type detected from its values;
+	// return false if no file could be read, or any if allFiles are required
+	static bool readFromFile(MixedDataManager& data, const std::string& dataPath,
+							 const bool& allFiles = false) {
+		TraceSpan traceSpan("MixedDataInput::readFromFile", "load");
+		std::vector<std::string> fileList;
+		try {
+			DataInput<int>::getFileList(fileList, dataPath);
+		}
+		catch (const std::invalid_argument& e) {
+			ErrorMsg::print(e.what());
+			return false;
+		}
+		std::size_t noOfFiles[3]{};
+		std::size_t noOfFailed{};
+		for (auto it = fileList.begin(); it != fileList.end(); ++it) {
+			DebugMsg::print("[MIXED-DATA-INPUT] Reading from file '" + *it + "'\n");
+			std::ifstream inFile(*it, std::ios::binary);
+			if (!inFile.is_open()) {
+				ErrorMsg::print("[MIXED-DATA-INPUT] Exception opening file '" + *it + "'\n");
+				Metrics::getParseErrors().add();
+				++noOfFailed;
+				continue;
+			}
+			// file is read once, then looked at twice in memory
+			std::ostringstream contents;
+			contents << inFile.rdbuf();
+			SeriesType type{detectSeriesType(contents.str())};
+			++noOfFiles[static_cast<int>(type)];
+			Metrics::getFilesIngested().add();
+			switch (type) {
+			case SeriesType::INT: insertContents<int>(data, contents.str()); break;
+			case SeriesType::DOUBLE: insertContents<double>(data, contents.str()); break;
+			default: insertContents<std::complex<double>>(data, contents.str());
+			}
+		}
+		std::ostringstream stringStream;
+		stringStream << std::endl << "[MIXED-DATA-INPUT] Files read: "
+			<< noOfFiles[0] << " int, " << noOfFiles[1] << " double, "
+			<< noOfFiles[2] << " complexdouble" << std::endl;
+		ScreenMsg::print(stringStream.str());
+		return DataInput<int>::checkFilesRead(noOfFailed, fileList.size(), dataPath, allFiles);
+	}
+};
+
 #endif /* DATA_INPUT_HPP */
\ No newline at end of file
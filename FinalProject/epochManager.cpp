@@ -0,0 +1,62 @@
+#include <thread>     // this_thread
+#include <functional> // hash
+#include <stdexcept>  // runtime_error
+#include <limits>     // numeric_limits
+
+#include "epochManager.hpp" // safe reclamation of shared snapshots
+
+/* ------------------------------------------------------------------------
+* DEFINE EPOCH MANAGER CLASS
+* -----------------------------------------------------------------------*/
+
+const std::size_t EpochManager::maxReaders;
+const unsigned long long EpochManager::unpinned{std::numeric_limits<unsigned long long>::max()};
+
+// default constructor
+EpochManager::EpochManager() : globalEpoch{0} {
+    DebugMsg::print("[EPOCH-MANAGER] Default constructor called\n");
+    for (std::size_t i{}; i < maxReaders; ++i) {
+        slots[i].epoch.store(unpinned);
+        slots[i].used.store(false);
+    }
+}
+
+// take a free slot and pin the current epoch in it
+std::size_t EpochManager::pin() {
+    // start probing at a slot picked by thread, so that concurrent readers
+    // rarely compete for the same one
+    std::size_t first{std::hash<std::thread::id>()(std::this_thread::get_id()) % maxReaders};
+    for (std::size_t i{}; i < maxReaders; ++i) {
+        Slot& slot = slots[(first + i) % maxReaders];
+        bool expected{false};
+        if (!slot.used.load(std::memory_order_relaxed)
+            && slot.used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            // sequentially consistent, so the pin is seen before the
+            // reader loads any published pointer
+            slot.epoch.store(globalEpoch.load());
+            return (first + i) % maxReaders;
+        }
+    }
+    throw std::runtime_error("[EPOCH-MANAGER] Too many concurrent readers\n");
+}
+
+// clear slot taken by pin
+void EpochManager::unpin(const std::size_t& slot) {
+    slots[slot].epoch.store(unpinned, std::memory_order_release);
+    slots[slot].used.store(false, std::memory_order_release);
+}
+
+// start a new epoch, returns the tag of objects retired before it
+unsigned long long EpochManager::retire() {
+    return globalEpoch.fetch_add(1);
+}
+
+// return oldest epoch pinned by any reader
+unsigned long long EpochManager::getOldestPinned() const {
+    unsigned long long oldest{unpinned};
+    for (std::size_t i{}; i < maxReaders; ++i) {
+        unsigned long long epoch{slots[i].epoch.load()};
+        if (epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
@@ -0,0 +1,55 @@
+#ifndef EPOCH_MANAGER_HPP
+#define EPOCH_MANAGER_HPP
+
+#include <iostream> // std
+#include <atomic>   // atomic
+#include <cstddef>  // size_t
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* EPOCH MANAGER CLASS: SAFE RECLAMATION OF SHARED SNAPSHOTS
+* -----------------------------------------------------------------------*/
+
+// Epoch-based reclamation. A reader pins the current epoch in a slot of
+// its own before it loads a published pointer and clears the slot when it
+// is done, without any lock. A writer that replaces a published pointer
+// tags the old object with the epoch returned by retire(); the object may
+// be freed once getOldestPinned() is greater than the tag, because every
+// reader that could still see it pinned an epoch no greater than the tag.
+class EpochManager {
+public:
+    // maximum number of readers pinned at the same time
+    static const std::size_t maxReaders = 64;
+    // value of a slot without reader, larger than any epoch
+    static const unsigned long long unpinned;
+
+private:
+    // one cache line per slot, so readers do not share lines
+    struct alignas(64) Slot {
+        std::atomic<unsigned long long> epoch;
+        std::atomic<bool> used;
+    };
+    Slot slots[maxReaders];
+    std::atomic<unsigned long long> globalEpoch;
+
+public:
+    // default constructor
+    EpochManager();
+    // slots are referred to by index, so the manager does not move
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // take a free slot and pin the current epoch in it, returns slot
+    // index; throws runtime_error if maxReaders are already pinned
+    std::size_t pin();
+    // clear slot taken by pin
+    void unpin(const std::size_t& slot);
+
+    // start a new epoch, returns the tag of objects retired before it
+    unsigned long long retire();
+    // return oldest epoch pinned by any reader, unpinned if there is none
+    unsigned long long getOldestPinned() const;
+};
+
+#endif /* EPOCH_MANAGER_HPP */
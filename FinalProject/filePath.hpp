@@ -0,0 +1,65 @@
+#ifndef FILE_PATH_HPP
+#define FILE_PATH_HPP
+
+#include <string> // string
+#include <vector> // vector
+#include <cstdio> // remove
+#ifdef _WIN32
+#include <direct.h>  // _mkdir, _rmdir
+#include "dirent.h"  // read all files in directory
+#else
+#include <sys/stat.h> // mkdir
+#include <unistd.h>   // rmdir
+#include <dirent.h>   // read all files in directory
+#endif
+
+/* ------------------------------------------------------------------------
+* JOIN DIRECTORY AND FILE NAMES
+* -----------------------------------------------------------------------*/
+
+#ifdef _WIN32
+const char PATH_SEPARATOR{'\\'};
+#else
+const char PATH_SEPARATOR{'/'};
+#endif
+
+// return path of file name in directory, with the separator of the system
+// unless the directory already ends with one
+inline std::string joinPath(const std::string& directory, const std::string& fileName) {
+	if (directory.empty()) return fileName;
+	char last{directory[directory.size() - 1]};
+	if (last == '/' || last == PATH_SEPARATOR) return directory + fileName;
+	return directory + PATH_SEPARATOR + fileName;
+}
+
+// create directory, return false if it could not be created or exists
+inline bool makeDirectory(const std::string& directory) {
+#ifdef _WIN32
+	return _mkdir(directory.c_str()) == 0;
+#else
+	return mkdir(directory.c_str(), 0755) == 0;
+#endif
+}
+
+// remove the regular files of directory and then the directory itself,
+// return false if any of them could not be removed
+inline bool removeDirectory(const std::string& directory) {
+	std::vector<std::string> fileNames;
+	DIR *d{opendir(directory.c_str())};
+	if (!d) return false;
+	for (struct dirent *dir{readdir(d)}; dir != NULL; dir = readdir(d)) {
+		if (dir->d_type == DT_REG) fileNames.push_back(joinPath(directory, dir->d_name));
+	}
+	closedir(d);
+	bool removed{true};
+	for (auto it = fileNames.begin(); it != fileNames.end(); ++it) {
+		removed = std::remove(it->c_str()) == 0 && removed;
+	}
+#ifdef _WIN32
+	return _rmdir(directory.c_str()) == 0 && removed;
+#else
+	return rmdir(directory.c_str()) == 0 && removed;
+#endif
+}
+
+#endif /* FILE_PATH_HPP */
@@ -0,0 +1,364 @@
+#ifndef FROZEN_DB_HPP
+#define FROZEN_DB_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <vector>   // vector
+#include <list>     // list
+#include <sstream>  // stringstream
+#include <utility>  // pair
+
+#include "msg.hpp"         // classes managing outputs
+#include "project.hpp"     // classes managing project
+#include "reportCache.hpp" // query keys and time ranges
+#include "perfectHash.hpp" // name lookup of a fixed set of keys
+
+/* ------------------------------------------------------------------------
+* FROZEN REFERENCE DATABASE
+* -----------------------------------------------------------------------*/
+
+// Immutable copy of a staff or project reference database: distinct names
+// in database order, each with a run of entries naming the other side of
+// the pair and the frozen project it refers to.
+struct FrozenReference {
+    // column labels, e.g. "Staff" and "Project"
+    std::string keys, values;
+    // names are looked up by perfect hash, their entries are
+    // [offsets[i], offsets[i + 1])
+    PerfectHash names;
+    std::vector<std::size_t> offsets;
+    std::vector<std::string> entryNames;
+    // index of the frozen project, PerfectHash::notFound if it has expired
+    std::vector<std::size_t> entryProjects;
+
+    // approximate heap memory held by the reference in bytes
+    std::size_t getMemoryUsage() const {
+        return names.getMemoryUsage() + offsets.capacity() * sizeof(std::size_t)
+             + entryNames.capacity() * sizeof(std::string) + entryProjects.capacity() * sizeof(std::size_t);
+    }
+};
+
+/* ------------------------------------------------------------------------
+* FROZEN PROJECT DATABASE CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// Read-optimised layout of a DataManager built once loading is done: all
+// projects in one array in staff/project order, perfect-hash lookup of
+// staff, project and staff/project names into it, and the pairs of both
+// reference databases as contiguous runs of array indices. The caller
+// compacts project series into full blocks with their indices and prefix
+// sums built before freezing. Projects changed afterwards are thawed one
+// by one: they keep their place in the layout but lose the compact form
+// until the next freeze; deleted projects are left as empty pointers.
+// Const functions do not change the layout or its projects, so a layout
+// whose projects are not changed any more can be read from many threads.
+template <typename T> class FrozenDb {
+private:
+    bool frozen;
+    // projects in staff/project order, empty pointer once deleted
+    std::vector<ProjectSharedPtr<T>> projects;
+    // true for projects changed since freezing
+    std::vector<bool> thawed;
+    // "staff\nproject" to index into projects
+    PerfectHash pairNames;
+    FrozenReference staffReference;
+    FrozenReference projectReference;
+
+    // lookup key of a staff/project pair, names never contain white space
+    static std::string getPairName(const std::string& staffName, const std::string& projectName) {
+        return staffName + "\n" + projectName;
+    }
+
+    // freeze reference database given as (key, value) pairs in database
+    // order, projectFirst tells whether keys are project names
+    void buildReference(FrozenReference& reference, const std::string& keys, const std::string& values,
+                        const std::vector<std::pair<std::string, std::string>>& entries,
+                        const bool& projectFirst) {
+        reference.keys = keys;
+        reference.values = values;
+        std::vector<std::string> names;
+        reference.offsets.clear();
+        reference.entryNames.clear();
+        reference.entryProjects.clear();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            // entries of one key are next to each other
+            if (names.empty() || names.back() != it->first) {
+                names.push_back(it->first);
+                reference.offsets.push_back(reference.entryNames.size());
+            }
+            reference.entryNames.push_back(it->second);
+            reference.entryProjects.push_back(projectFirst ? pairNames.find(getPairName(it->second, it->first))
+                                                           : pairNames.find(getPairName(it->first, it->second)));
+        }
+        reference.offsets.push_back(reference.entryNames.size());
+        reference.names.build(names);
+    }
+
+    // return project at index, empty pointer if it does not exist any more;
+    // returned by reference so that concurrent readers do not touch the
+    // reference counts
+    const ProjectSharedPtr<T>& getProject(const std::size_t& index) const {
+        static const ProjectSharedPtr<T> noProject;
+        if (index == PerfectHash::notFound) return noProject;
+        return projects[index];
+    }
+
+    // call function(project) for every existing project covered by query,
+    // in the order they are printed
+    template <typename Function> void forEachProject(const QueryKey& query, Function function) const {
+        const FrozenReference* reference{nullptr};
+        std::size_t index{};
+        switch (query.scope) {
+        case QueryScope::ALL:
+            for (auto it = projects.begin(); it != projects.end(); ++it) {
+                if (*it) function(*it);
+            }
+            return;
+        case QueryScope::STAFF:
+            reference = &staffReference;
+            index = staffReference.names.find(query.staffName);
+            break;
+        case QueryScope::PROJECT:
+            reference = &projectReference;
+            index = projectReference.names.find(query.projectName);
+            break;
+        default: {
+            const ProjectSharedPtr<T>& project = this->getProject(pairNames.find(
+                getPairName(query.staffName, query.projectName)));
+            if (project) function(project);
+            return;
+        }
+        }
+        if (index == PerfectHash::notFound) return;
+        for (std::size_t i{reference->offsets[index]}; i < reference->offsets[index + 1]; ++i) {
+            const ProjectSharedPtr<T>& project = this->getProject(reference->entryProjects[i]);
+            if (project) function(project);
+        }
+    }
+
+    // return measurements of a project, optionally only within time range
+    static std::list<Measurement<T>> getMeasurements(const ProjectSharedPtr<T>& project, const TimeRange& range) {
+        if (range.isRange) return project.get()->getMeasurements(range.startTime, range.endTime);
+        return project.get()->getMeasurements();
+    }
+
+    // return data of a name in a reference database, same as
+    // ProjectReferenceDb::show
+    std::string showReference(const FrozenReference& reference, const std::string& name,
+                              const TimeRange& range) const {
+        std::ostringstream stringStream;
+        std::size_t index{reference.names.find(name)};
+        if (index == PerfectHash::notFound) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        for (std::size_t i{reference.offsets[index]}; i < reference.offsets[index + 1]; ++i) {
+            const ProjectSharedPtr<T>& project = this->getProject(reference.entryProjects[i]);
+            if (!project) {
+                if (range.isRange) continue;
+                stringStream << showProject(reference.keys, name, reference.values, reference.entryNames[i],
+                                            std::list<Measurement<T>>{})
+                             << "[PROJECT-REF-DB] Data has expired!" << std::endl;
+                continue;
+            }
+            std::list<Measurement<T>> measurements{getMeasurements(project, range)};
+            if (range.isRange && measurements.empty()) continue;
+            stringStream << showProject(reference.keys, name, reference.values, reference.entryNames[i],
+                                        measurements)
+                         << std::endl;
+        }
+        return stringStream.str();
+    }
+
+public:
+    // default constructor - nothing frozen
+    FrozenDb() : frozen{false} {
+        DebugMsg::print("[FROZEN-DB] Default constructor called\n");
+    }
+
+    // access function
+    bool isFrozen() const { return this->frozen; }
+
+    // return table header followed by measurements of a project
+    static std::string showProject(const std::string& keys, const std::string& keyName,
+                                   const std::string& values, const std::string& valueName,
+                                   const std::list<Measurement<T>>& measurements) {
+        std::ostringstream stringStream;
+        stringStream << std::endl
+                     << keys   << ": " << keyName   << std::endl
+                     << values << ": " << valueName << std::endl
+                     << "-----------------------------" << std::endl
+                     << "Timestamp\tMeasurement       " << std::endl
+                     << "-----------------------------" << std::endl;
+        for (auto iter = measurements.begin(); iter != measurements.end(); ++iter) {
+            stringStream << *iter << std::endl;
+        }
+        return stringStream.str();
+    }
+
+    // freeze projects given in staff/project order together with the
+    // (key, value) pairs of the staff and project reference databases
+    void build(const std::vector<ProjectSharedPtr<T>>& userProjects,
+               const std::vector<std::pair<std::string, std::string>>& staffEntries,
+               const std::vector<std::pair<std::string, std::string>>& projectEntries) {
+        projects = userProjects;
+        thawed.assign(projects.size(), false);
+        std::vector<std::string> names;
+        names.reserve(projects.size());
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            names.push_back(getPairName((*it).get()->getStaffName(), (*it).get()->getProjectName()));
+        }
+        pairNames.build(names);
+        this->buildReference(staffReference, "Staff", "Project", staffEntries, false);
+        this->buildReference(projectReference, "Project", "Staff", projectEntries, true);
+        frozen = true;
+    }
+
+    // drop frozen layout
+    void clear() {
+        frozen = false;
+        projects.clear();
+        thawed.clear();
+        pairNames.build(std::vector<std::string>{});
+        staffReference = FrozenReference{};
+        projectReference = FrozenReference{};
+    }
+
+    // return true if a project exists and has a place in the layout
+    bool contains(const std::string& staffName, const std::string& projectName) const {
+        if (!frozen) return false;
+        return static_cast<bool>(this->getProject(pairNames.find(getPairName(staffName, projectName))));
+    }
+
+    // mark project as changed
+    void thaw(const std::string& staffName, const std::string& projectName) {
+        std::size_t index{pairNames.find(getPairName(staffName, projectName))};
+        if (index != PerfectHash::notFound) thawed[index] = true;
+    }
+
+    // remove deleted project, references to it expire
+    void erase(const std::string& staffName, const std::string& projectName) {
+        std::size_t index{pairNames.find(getPairName(staffName, projectName))};
+        if (index != PerfectHash::notFound) projects[index].reset();
+    }
+
+    // return projects covered by query, in the order they are printed
+    std::vector<ProjectSharedPtr<T>> getProjects(const QueryKey& query) const {
+        std::vector<ProjectSharedPtr<T>> queryProjects;
+        this->forEachProject(query, [&queryProjects](const ProjectSharedPtr<T>& project) {
+            queryProjects.push_back(project);
+        });
+        return queryProjects;
+    }
+
+    // return staff and project names of existing projects
+    std::vector<std::pair<std::string, std::string>> getPairs() const {
+        std::vector<std::pair<std::string, std::string>> pairs;
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            if (*it) pairs.push_back(std::make_pair((*it).get()->getStaffName(), (*it).get()->getProjectName()));
+        }
+        return pairs;
+    }
+
+    // return data view of query, same as the show functions of the
+    // mutable databases
+    std::string show(const QueryKey& query) const {
+        std::ostringstream stringStream;
+        switch (query.scope) {
+        case QueryScope::ALL:
+            for (auto it = projects.begin(); it != projects.end(); ++it) {
+                if (!*it) continue;
+                std::list<Measurement<T>> measurements{getMeasurements(*it, query.range)};
+                if (query.range.isRange && measurements.empty()) continue;
+                stringStream << showProject("Staff", (*it).get()->getStaffName(),
+                                            "Project", (*it).get()->getProjectName(), measurements);
+            }
+            return stringStream.str();
+        case QueryScope::STAFF:
+            return this->showReference(staffReference, query.staffName, query.range);
+        case QueryScope::PROJECT:
+            return this->showReference(projectReference, query.projectName, query.range);
+        default:
+            const ProjectSharedPtr<T>& project = this->getProject(pairNames.find(
+                getPairName(query.staffName, query.projectName)));
+            if (!project) {
+                ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+                return "";
+            }
+            std::list<Measurement<T>> measurements{getMeasurements(project, query.range)};
+            if (query.range.isRange && measurements.empty()) return "";
+            return showProject("Staff", query.staffName, "Project", query.projectName, measurements);
+        }
+    }
+
+    // return report of query, same as the report functions of the mutable
+    // databases
+    std::string getReport(const QueryKey& query) const {
+        std::ostringstream stringStream;
+        if (query.scope == QueryScope::PAIR && !this->getProject(pairNames.find(
+                getPairName(query.staffName, query.projectName)))) {
+            ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+            return "";
+        }
+        if ((query.scope == QueryScope::STAFF && staffReference.names.find(query.staffName) == PerfectHash::notFound)
+            || (query.scope == QueryScope::PROJECT
+                && projectReference.names.find(query.projectName) == PerfectHash::notFound)) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        this->forEachProject(query, [&stringStream, &query](const ProjectSharedPtr<T>& project) {
+            if (query.range.isRange) stringStream << project.get()->getReport(query.range.startTime, query.range.endTime);
+            else stringStream << project.get()->getReport();
+        });
+        return stringStream.str();
+    }
+
+    // return table of all pairs of the staff or project reference database,
+    // same as ProjectReferenceDb::show
+    std::string showNames(const QueryScope& scope) const {
+        const FrozenReference& reference = scope == QueryScope::STAFF ? staffReference : projectReference;
+        std::ostringstream stringStream;
+        stringStream << std::endl
+             << "-----------------------------" << std::endl
+             << reference.keys << "\t" << reference.values << std::endl
+             << "-----------------------------" << std::endl;
+        for (std::size_t index{}; index < reference.names.getSize(); ++index) {
+            for (std::size_t i{reference.offsets[index]}; i < reference.offsets[index + 1]; ++i) {
+                stringStream << reference.names.getKey(index) << "\t" << reference.entryNames[i] << std::endl;
+            }
+        }
+        return stringStream.str();
+    }
+
+    // approximate heap memory held by the frozen layout in bytes, the
+    // projects themselves are shared with the DataManager
+    std::size_t getMemoryUsage() const {
+        return pairNames.getMemoryUsage() + staffReference.getMemoryUsage() + projectReference.getMemoryUsage()
+             + projects.capacity() * sizeof(ProjectSharedPtr<T>) + thawed.capacity() / 8;
+    }
+
+    // return statistics of the frozen layout
+    std::string show() const {
+        std::size_t noOfThawed{}, noOfDeleted{};
+        for (std::size_t i{}; i < projects.size(); ++i) {
+            if (!projects[i]) ++noOfDeleted;
+            else if (thawed[i]) ++noOfThawed;
+        }
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Frozen layout"                 << std::endl
+            << "-----------------------------" << std::endl
+            << "Frozen: "        << (frozen ? "yes" : "no") << std::endl
+            << "Projects: "      << projects.size() << " (" << noOfThawed << " thawed, "
+                                 << noOfDeleted << " deleted)" << std::endl
+            << "Staff names: "   << staffReference.names.getSize()   << std::endl
+            << "Project names: " << projectReference.names.getSize() << std::endl
+            << "Lookup tables: " << pairNames.getMemoryUsage() + staffReference.getMemoryUsage()
+                                    + projectReference.getMemoryUsage() << " bytes" << std::endl
+            << "-----------------------------" << std::endl;
+        return stringStream.str();
+    }
+};
+
+#endif /* FROZEN_DB_HPP */
@@ -0,0 +1,31 @@
+#include <sstream> // stringstream
+#include <iomanip> // setprecision
+
+#include "ingestQueue.hpp" // lock-free queue between producers and data owner
+
+/* ------------------------------------------------------------------------
+* DEFINE INGEST QUEUE STATISTICS
+* -----------------------------------------------------------------------*/
+
+// return statistics table
+std::string IngestStats::show() const {
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "-----------------------------" << std::endl
+        << "Ingest queue"                  << std::endl
+        << "-----------------------------" << std::endl
+        << "Capacity: "          << capacity      << std::endl
+        << "Experiments: "       << noOfPushed    << std::endl
+        << "Waits on full queue: " << noOfFullWaits << std::endl
+        << "Enqueue latency: "   << std::fixed << std::setprecision(0)
+        << (noOfPushed > 0 ? static_cast<double>(totalEnqueueNanos) / noOfPushed : 0)
+        << " ns mean, " << maxEnqueueNanos << " ns max" << std::endl
+        << "Queue depth: "       << std::setprecision(1)
+        << (noOfDrains > 0 ? static_cast<double>(totalDepth) / noOfDrains : 0)
+        << " mean, " << maxDepth << " max" << std::endl
+        << "Drain batches: "     << noOfDrains << ", " << std::setprecision(1)
+        << (noOfDrains > 0 ? static_cast<double>(noOfPushed) / noOfDrains : 0)
+        << " mean size, " << maxBatch << " max" << std::endl
+        << "-----------------------------" << std::endl;
+    return stringStream.str();
+}
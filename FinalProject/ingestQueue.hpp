@@ -0,0 +1,181 @@
+#ifndef INGEST_QUEUE_HPP
+#define INGEST_QUEUE_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <vector>   // vector
+#include <memory>   // unique pointer
+#include <atomic>   // atomic
+#include <thread>   // yield
+#include <chrono>   // steady_clock
+#include <cstddef>  // size_t
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* INGEST QUEUE STATISTICS
+* -----------------------------------------------------------------------*/
+
+// counters of an IngestQueue, latencies in nanoseconds
+struct IngestStats {
+    std::size_t capacity;
+    std::size_t noOfPushed;
+    // pushes that found the queue full and had to wait
+    std::size_t noOfFullWaits;
+    unsigned long long totalEnqueueNanos;
+    unsigned long long maxEnqueueNanos;
+    // depth seen by the consumer at the start of every drain
+    std::size_t maxDepth;
+    std::size_t totalDepth;
+    std::size_t noOfDrains;
+    std::size_t maxBatch;
+
+    // return statistics table
+    std::string show() const;
+};
+
+/* ------------------------------------------------------------------------
+* INGEST QUEUE CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// Bounded lock-free queue of many producers and one consumer, a ring of
+// cells that each carry a sequence number (after D. Vyukov). A producer
+// claims a position with one compare-and-swap, moves its item into the
+// cell and publishes it by advancing the cell sequence; the consumer takes
+// items in position order and hands the cell back by advancing it again.
+// push() waits while the ring is full, which holds fast producers back to
+// the speed of the consumer. The consumer drains up to a batch of items at
+// a time, so that the owner of the data can apply them together.
+template <typename Item> class IngestQueue {
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        Item item;
+    };
+
+    std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    // next position claimed by a producer
+    alignas(64) std::atomic<std::size_t> enqueuePosition;
+    // next position taken by the consumer, only used by the consumer
+    alignas(64) std::size_t dequeuePosition;
+    std::atomic<bool> closed;
+    // producer counters
+    alignas(64) std::atomic<std::size_t> noOfPushed;
+    std::atomic<std::size_t> noOfFullWaits;
+    std::atomic<unsigned long long> totalEnqueueNanos;
+    std::atomic<unsigned long long> maxEnqueueNanos;
+    // consumer counters
+    std::size_t maxDepth, totalDepth, noOfDrains, maxBatch;
+
+    // return smallest power of two not below size
+    static std::size_t roundUp(const std::size_t& size) {
+        std::size_t capacity{2};
+        while (capacity < size) capacity <<= 1;
+        return capacity;
+    }
+
+public:
+    // parametrised constructor - capacity is rounded up to a power of two
+    IngestQueue(const std::size_t& userCapacity = 256)
+               : mask{roundUp(userCapacity) - 1}, cells{new Cell[mask + 1]}, enqueuePosition{0},
+                 dequeuePosition{0}, closed{false}, noOfPushed{0}, noOfFullWaits{0}, totalEnqueueNanos{0},
+                 maxEnqueueNanos{0}, maxDepth{}, totalDepth{}, noOfDrains{}, maxBatch{} {
+        DebugMsg::print("[INGEST-QUEUE] Parametrised constructor called\n");
+        for (std::size_t i{}; i <= mask; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // cells are shared with other threads, so the queue does not move
+    IngestQueue(const IngestQueue&) = delete;
+    IngestQueue& operator=(const IngestQueue&) = delete;
+
+    // access function
+    std::size_t getCapacity() const { return this->mask + 1; }
+
+    // move item into the queue, false if it is full; item is left as it
+    // was if the push fails
+    bool tryPush(Item& item) {
+        std::size_t position{enqueuePosition.load(std::memory_order_relaxed)};
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            std::size_t sequence{cell->sequence.load(std::memory_order_acquire)};
+            std::ptrdiff_t difference{static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position)};
+            if (difference == 0) {
+                // cell is free, claim its position
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                // cell still holds the item of the previous round
+                return false;
+            } else {
+                // another producer claimed the position first
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = std::move(item);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // move item into the queue, waiting while it is full
+    void push(Item&& item) {
+        auto start = std::chrono::steady_clock::now();
+        if (!this->tryPush(item)) {
+            noOfFullWaits.fetch_add(1, std::memory_order_relaxed);
+            while (!this->tryPush(item)) std::this_thread::yield();
+        }
+        unsigned long long nanos{static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count())};
+        noOfPushed.fetch_add(1, std::memory_order_relaxed);
+        totalEnqueueNanos.fetch_add(nanos, std::memory_order_relaxed);
+        unsigned long long maxNanos{maxEnqueueNanos.load(std::memory_order_relaxed)};
+        while (nanos > maxNanos && !maxEnqueueNanos.compare_exchange_weak(maxNanos, nanos, std::memory_order_relaxed)) {}
+    }
+
+    // move next item out of the queue, false if it is empty; consumer only
+    bool tryPop(Item& item) {
+        Cell& cell = cells[dequeuePosition & mask];
+        std::size_t sequence{cell.sequence.load(std::memory_order_acquire)};
+        if (sequence != dequeuePosition + 1) return false;
+        item = std::move(cell.item);
+        // hand the cell to the producer of the next round
+        cell.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    // move up to maxItems items out of the queue and call consume(items)
+    // once if there were any, returns number of items; consumer only
+    template <typename Function> std::size_t drain(Function consume, const std::size_t& maxItems = 64) {
+        std::size_t depth{enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition};
+        std::vector<Item> items;
+        Item item;
+        while (items.size() < maxItems && this->tryPop(item)) items.push_back(std::move(item));
+        if (items.empty()) return 0;
+        if (depth > maxDepth) maxDepth = depth;
+        totalDepth += depth;
+        ++noOfDrains;
+        if (items.size() > maxBatch) maxBatch = items.size();
+        std::size_t noOfItems{items.size()};
+        consume(items);
+        return noOfItems;
+    }
+
+    // tell the consumer that no more items will come
+    void close() { closed.store(true, std::memory_order_release); }
+
+    // return true once the queue is closed and every item was taken;
+    // consumer only
+    bool isDone() const {
+        return closed.load(std::memory_order_acquire)
+            && enqueuePosition.load(std::memory_order_acquire) == dequeuePosition;
+    }
+
+    // return counters, consumer only
+    IngestStats getStats() const {
+        return IngestStats{mask + 1, noOfPushed.load(), noOfFullWaits.load(), totalEnqueueNanos.load(),
+                           maxEnqueueNanos.load(), maxDepth, totalDepth, noOfDrains, maxBatch};
+    }
+};
+
+#endif /* INGEST_QUEUE_HPP */
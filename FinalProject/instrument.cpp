@@ -0,0 +1,160 @@
+#include <iostream> // std
+#include <sstream>  // stringstream
+#include <string>   // string
+#include <map>      // map
+#include <mutex>    // mutex, lock_guard
+#include <new>      // bad_alloc, nothrow_t
+#include <cstdlib>  // malloc, free
+
+#include "instrument.hpp" // allocation and copy accounting
+
+#ifdef DATAHERO_INSTRUMENT
+
+/* ------------------------------------------------------------------------
+* OPERATION TOTALS
+* -----------------------------------------------------------------------*/
+
+// counters of one operation over all its calls
+struct OperationTotals {
+    unsigned long long noOfCalls;
+    InstrumentCounters counters;
+};
+
+// totals of every operation, by name
+static std::map<std::string, OperationTotals>& getOperations() {
+    static std::map<std::string, OperationTotals> operations;
+    return operations;
+}
+static std::mutex& getOperationsMutex() {
+    static std::mutex operationsMutex;
+    return operationsMutex;
+}
+
+// prints the totals when DataHero exits; constructed after the totals
+// are, so destroyed before them
+struct OperationsPrinter {
+    OperationsPrinter() { getOperations(); }
+    ~OperationsPrinter() { std::cerr << Instrument::show(); }
+};
+static OperationsPrinter operationsPrinter;
+
+// names of the counted classes
+static const char* getTypeName(const int& type) {
+    static const char* names[]{"measurement", "header line", "experiment", "project", "project db",
+                               "project reference db"};
+    return names[type];
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE INSTRUMENT CLASS
+* -----------------------------------------------------------------------*/
+
+bool Instrument::isEnabled() { return true; }
+
+// counters of the calling thread, plain data so that operator new can use
+// them at any time
+InstrumentCounters& Instrument::getThreadCounters() {
+    static thread_local InstrumentCounters threadCounters;
+    return threadCounters;
+}
+
+void Instrument::countAllocation(const std::size_t& noOfBytes) {
+    InstrumentCounters& counters = getThreadCounters();
+    ++counters.noOfAllocations;
+    counters.noOfBytes += noOfBytes;
+}
+
+InstrumentCounters Instrument::getCounters() {
+    return getThreadCounters();
+}
+
+void Instrument::addOperation(const char* operation, const InstrumentCounters& before,
+                              const InstrumentCounters& after) {
+    std::lock_guard<std::mutex> lock(getOperationsMutex());
+    auto inserted = getOperations().insert(std::make_pair(std::string(operation), OperationTotals{}));
+    OperationTotals& totals = inserted.first->second;
+    ++totals.noOfCalls;
+    totals.counters.noOfAllocations += after.noOfAllocations - before.noOfAllocations;
+    totals.counters.noOfBytes += after.noOfBytes - before.noOfBytes;
+    for (int type{}; type < static_cast<int>(InstrumentedType::NO_OF_TYPES); ++type) {
+        totals.counters.noOfCopies[type] += after.noOfCopies[type] - before.noOfCopies[type];
+        totals.counters.noOfMoves[type] += after.noOfMoves[type] - before.noOfMoves[type];
+    }
+}
+
+std::string Instrument::show() {
+    std::lock_guard<std::mutex> lock(getOperationsMutex());
+    if (getOperations().empty()) return "";
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "-----------------------------" << std::endl
+        << "Allocations and copies"        << std::endl
+        << "-----------------------------" << std::endl;
+    for (auto it = getOperations().begin(); it != getOperations().end(); ++it) {
+        const InstrumentCounters& counters = it->second.counters;
+        stringStream << it->first << ": " << it->second.noOfCalls << " calls, "
+                     << counters.noOfAllocations << " allocs, " << counters.noOfBytes << " bytes, "
+                     << counters.noOfCopies[static_cast<int>(InstrumentedType::MEASUREMENT)]
+                     << " measurement copies";
+        // other counts only where there are any
+        for (int type{}; type < static_cast<int>(InstrumentedType::NO_OF_TYPES); ++type) {
+            if (type != static_cast<int>(InstrumentedType::MEASUREMENT) && counters.noOfCopies[type] > 0) {
+                stringStream << ", " << counters.noOfCopies[type] << " " << getTypeName(type) << " copies";
+            }
+            if (counters.noOfMoves[type] > 0) {
+                stringStream << ", " << counters.noOfMoves[type] << " " << getTypeName(type) << " moves";
+            }
+        }
+        stringStream << std::endl;
+    }
+    stringStream << "-----------------------------" << std::endl;
+    return stringStream.str();
+}
+
+/* ------------------------------------------------------------------------
+* GLOBAL ALLOCATION HOOKS
+* -----------------------------------------------------------------------*/
+
+// GCC takes the malloc and free below for a mismatch with the operator
+// new and delete they implement
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// allocation and release of memory behind operator new and delete
+static void* allocate(const std::size_t& noOfBytes) {
+    Instrument::countAllocation(noOfBytes);
+    return std::malloc(noOfBytes > 0 ? noOfBytes : 1);
+}
+static void release(void* pointer) {
+    std::free(pointer);
+}
+
+void* operator new(std::size_t noOfBytes) {
+    void* pointer = allocate(noOfBytes);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+void* operator new[](std::size_t noOfBytes) {
+    return ::operator new(noOfBytes);
+}
+void* operator new(std::size_t noOfBytes, const std::nothrow_t&) noexcept {
+    return allocate(noOfBytes);
+}
+void* operator new[](std::size_t noOfBytes, const std::nothrow_t& tag) noexcept {
+    return ::operator new(noOfBytes, tag);
+}
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+
+#else
+
+bool Instrument::isEnabled() { return false; }
+void Instrument::countAllocation(const std::size_t&) {}
+InstrumentCounters Instrument::getCounters() { return InstrumentCounters{}; }
+void Instrument::addOperation(const char*, const InstrumentCounters&, const InstrumentCounters&) {}
+std::string Instrument::show() { return ""; }
+
+#endif /* DATAHERO_INSTRUMENT */
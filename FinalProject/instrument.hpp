@@ -0,0 +1,101 @@
+#ifndef INSTRUMENT_HPP
+#define INSTRUMENT_HPP
+
+#include <string>  // string
+#include <cstddef> // size_t
+
+/* ------------------------------------------------------------------------
+* ALLOCATION AND COPY ACCOUNTING
+* -----------------------------------------------------------------------*/
+
+// Built with -DDATAHERO_INSTRUMENT (make INSTRUMENT=1), DataHero counts
+// every heap allocation through global operator new and every copy and
+// move of the classes below, per thread. Public operations open an
+// InstrumentScope, which adds what its thread did meanwhile to the totals
+// of the operation, and the totals are printed to standard error when
+// DataHero exits, e.g.
+//   DataManager::insertExperiment: 16 calls, 48 allocs, 3072 bytes,
+//   0 measurement copies, 16 header line copies
+// Nested operations are also counted in the operation around them, and
+// the work of pool threads in none. Without the flag, all functions below
+// are empty and compiled away.
+
+// classes whose copies and moves are counted; a derived class counts for
+// its base too, e.g. a Project copy also copies an Experiment
+enum class InstrumentedType {
+    MEASUREMENT, HEADER_LINE, EXPERIMENT, PROJECT, PROJECT_DB, PROJECT_REFERENCE_DB, NO_OF_TYPES
+};
+
+// counters of one thread
+struct InstrumentCounters {
+    unsigned long long noOfAllocations;
+    unsigned long long noOfBytes;
+    unsigned long long noOfCopies[static_cast<int>(InstrumentedType::NO_OF_TYPES)];
+    unsigned long long noOfMoves[static_cast<int>(InstrumentedType::NO_OF_TYPES)];
+};
+
+class Instrument {
+public:
+    // true in the instrumented build
+    static bool isEnabled();
+    // count allocation of bytes by the calling thread
+    static void countAllocation(const std::size_t& noOfBytes);
+    // count copy or move of type by the calling thread
+    static inline void countCopy(const InstrumentedType& type);
+    static inline void countMove(const InstrumentedType& type);
+    // return counters of the calling thread
+    static InstrumentCounters getCounters();
+    // add counters after minus counters before to the totals of operation
+    static void addOperation(const char* operation, const InstrumentCounters& before,
+                             const InstrumentCounters& after);
+    // return line per operation, empty if nothing was counted
+    static std::string show();
+
+private:
+    static InstrumentCounters& getThreadCounters();
+};
+
+// counts what the calling thread does while the scope is open for
+// operation, a string literal
+class InstrumentScope {
+private:
+#ifdef DATAHERO_INSTRUMENT
+    const char* operation;
+    InstrumentCounters before;
+#endif
+
+public:
+    explicit InstrumentScope(const char* userOperation);
+    ~InstrumentScope();
+    InstrumentScope(const InstrumentScope&) = delete;
+    InstrumentScope& operator=(const InstrumentScope&) = delete;
+};
+
+/* ------------------------------------------------------------------------
+* DEFINE INLINE INSTRUMENT FUNCTIONS
+* -----------------------------------------------------------------------*/
+
+#ifdef DATAHERO_INSTRUMENT
+
+inline void Instrument::countCopy(const InstrumentedType& type) {
+    ++getThreadCounters().noOfCopies[static_cast<int>(type)];
+}
+inline void Instrument::countMove(const InstrumentedType& type) {
+    ++getThreadCounters().noOfMoves[static_cast<int>(type)];
+}
+inline InstrumentScope::InstrumentScope(const char* userOperation)
+    : operation{userOperation}, before(Instrument::getCounters()) {}
+inline InstrumentScope::~InstrumentScope() {
+    Instrument::addOperation(operation, before, Instrument::getCounters());
+}
+
+#else
+
+inline void Instrument::countCopy(const InstrumentedType&) {}
+inline void Instrument::countMove(const InstrumentedType&) {}
+inline InstrumentScope::InstrumentScope(const char*) {}
+inline InstrumentScope::~InstrumentScope() {}
+
+#endif /* DATAHERO_INSTRUMENT */
+
+#endif /* INSTRUMENT_HPP */
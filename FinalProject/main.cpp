@@ -11,6 +11,7 @@
 #include "menus.hpp"	 // classes providing info
 #include "maps.hpp"      // classes managing data maps
 #include "dataInput.hpp"      // classes managing data maps
+#include "batchMode.hpp"      // running DataHero without prompts
 
 /* ------------------------------------------------------------------------
 * POLYMORPHISM : INITIALISE GENERAL INFO AND HELP MENUS
@@ -33,7 +34,8 @@ std::string getWelcomeScreen() {
 * ANALYSIS MENU MANAGER
 * -----------------------------------------------------------------------*/
 
-template <typename T> void analysisChoiceManager(const std::string& DataHeroPath, MainMenu& mainMenu, DataManager<T>& data) {
+// Data is a DataManager or a MixedDataManager
+template <typename Data> void analysisChoiceManager(const std::string& DataHeroPath, MainMenu& mainMenu, Data& data) {
     // show menu
     mainMenu.dataManageCmdsShow();
     // declare some strings for later
@@ -129,6 +131,59 @@ template <typename T> void analysisChoiceManager(const std::string& DataHeroPath
 					ScreenMsg::print(output);
 				}
 			}
+        } else if (choice == "R-DATA" || choice == "R-REPORT") {
+            ScreenMsg::print("\nExisting staff list:\n");
+            // print reference staff database
+            ScreenMsg::print(data.staffDatabaseShow());
+            ScreenMsg::print("\nType staff name or <all> to extract all staff data >> "); 
+            staffName = getInput<std::string>();
+            // convert to upper case letters just in case
+            std::transform(staffName.begin(), staffName.end(), staffName.begin(), ::toupper);
+            ScreenMsg::print("\nType project name or <all> to extract all project data >> "); 
+            projectName = getInput<std::string>(); 
+            // convert to upper case letters just in case
+            std::transform(projectName.begin(), projectName.end(), projectName.begin(), ::toupper);
+            // declare variables to specify timestamp ranges 
+            unsigned startRange, endRange;
+            ScreenMsg::print("Type start time of the range >> ");        
+            startRange = getInput<unsigned>();
+            ScreenMsg::print("Type end time of the range >> ");        
+            endRange = getInput<unsigned>();
+            if (choice == "R-DATA") {
+                // data within range, looked up with timestamp index
+                if (staffName == "ALL" && projectName == "ALL") {
+                    output = data.fullDatabaseRangeShow(startRange, endRange);
+                } else if (staffName != "ALL" && projectName == "ALL") { 
+                    output = data.staffDatabaseRangeShow(staffName, startRange, endRange);
+                } else if (staffName == "ALL" && projectName != "ALL") { 
+                    output = data.projectDatabaseRangeShow(projectName, startRange, endRange);
+                } else {
+                    output = data.fullDatabaseRangeShow(staffName, projectName, startRange, endRange);
+                }
+            } else {
+                // report of measurements within range
+                if (staffName == "ALL" && projectName == "ALL") {
+                    output = data.getRangeReport(startRange, endRange);
+                } else if (staffName != "ALL" && projectName == "ALL") { 
+                    output = data.getStaffRangeReport(staffName, startRange, endRange);
+                } else if (staffName == "ALL" && projectName != "ALL") { 
+                    output = data.getProjectRangeReport(projectName, startRange, endRange);
+                } else {
+                    output = data.getRangeReport(staffName, projectName, startRange, endRange);
+                }
+            }
+            // errors get printed directly from databases
+            if (!output.empty()) ScreenMsg::print(output);
+        } else if (choice == "CACHE") {
+            // print report cache hit rate and memory
+            ScreenMsg::print(data.reportCacheShow());
+        } else if (choice == "MEMORY") {
+            // print bytes held by every project and the dataset
+            ScreenMsg::print(data.memoryShow());
+        } else if (choice == "FREEZE") {
+            // compact layout for queries, thawed again by any change
+            data.freeze();
+            ScreenMsg::print(data.frozenShow());
         } else if (choice == "DEL") {
             ScreenMsg::print("\nExisting staff list:\n");
             // print reference staff database
@@ -195,13 +250,13 @@ template <typename T> void analysisChoiceManager(const std::string& DataHeroPath
 
 std::string getDataType() {
     std::string dataType;
-    while (dataType != "DOUBLE" && dataType != "INT" && dataType != "COMPLEXDOUBLE") {
+    while (dataType != "DOUBLE" && dataType != "INT" && dataType != "COMPLEXDOUBLE" && dataType != "AUTO") {
         // force user to select correct data type
-        ScreenMsg::print("\nChoose data type: <double>, <int>, <complexdouble> >> ");
+        ScreenMsg::print("\nChoose data type: <double>, <int>, <complexdouble>, <auto> (detected per file) >> ");
         dataType = getInput<std::string>();
         // convert to upper case letters just in case
         std::transform(dataType.begin(), dataType.end(), dataType.begin(), ::toupper);
-        if (dataType != "DOUBLE" && dataType != "INT" && dataType != "COMPLEXDOUBLE") {
+        if (dataType != "DOUBLE" && dataType != "INT" && dataType != "COMPLEXDOUBLE" && dataType != "AUTO") {
             // ask to try again if cannot recognise input
             ErrorMsg::print("\n[ERROR] Input not recognised, please try again\n"); 
         }
@@ -213,102 +268,98 @@ std::string getDataType() {
 * GET DATA PATH
 * -----------------------------------------------------------------------*/
 
-// if input from simulation or file, get file path
+// if input from file, get file path
 std::string getDataPath(const std::string& DataHeroPath, const std::string& userOrSimFile, std::string dataType) {
 	// convert reply to lower case letters
 	std::transform(dataType.begin(), dataType.end(), dataType.begin(), ::tolower);
     if (userOrSimFile == "F") {
-		ScreenMsg::print("\nEnter file(s) directory (e.g. <sim_" + dataType + ">:\n");
+		// a directory of detected types may mix the simulated ones
+		ScreenMsg::print("\nEnter file(s) directory (e.g. <" + (dataType == "auto" ? "data" : "sim_" + dataType) + ">:\n");
 		ScreenMsg::print(">> ");
         return DataHeroPath + getInput<std::string>();
-    } else if (userOrSimFile == "SIM") {
-        ScreenMsg::print("Data for Staff1 and Staff2 projects A and B will be simulated.\n");
-        ScreenMsg::print("Enter how many experiment files per staff to simulate (e.g. 3) >> ");
-        unsigned noOfFiles{ getInput<unsigned>() };
-		ScreenMsg::print("Confirm there is 'sim_" + dataType + "' folder within this code directory <y/n>: \n");
-		ScreenMsg::print(">> ");        
-        std::string reply{getInput<std::string>()};
-        // convert reply to upper case letters just in case
-        std::transform(reply.begin(), reply.end(), reply.begin(), ::toupper);
-        if (reply == "Y") {
-            // simulate data
-			Simulation::simulateData(DataHeroPath, noOfFiles, dataType);
-            // return data path
-			return DataHeroPath + "sim_" + dataType;
-        } else if (reply == "N") {
-            // ask user to create a folder before doing simulation
-            ScreenMsg::print("Please create folder 'sim_" + dataType + "' within this code directory.\n");            
-        }
-        return "";
     } else {
         return "";
     }
 }
 
+// ask how many files to simulate, 0 if the simulation folder is missing
+unsigned getNoOfSimulatedFiles(std::string dataType) {
+	// convert reply to lower case letters
+	std::transform(dataType.begin(), dataType.end(), dataType.begin(), ::tolower);
+    ScreenMsg::print("Data for Staff1 and Staff2 projects A and B will be simulated.\n");
+    ScreenMsg::print("Enter how many experiment files per staff to simulate (e.g. 3) >> ");
+    unsigned noOfFiles{ getInput<unsigned>() };
+	ScreenMsg::print("Confirm there is 'sim_" + dataType + "' folder within this code directory <y/n>: \n");
+	ScreenMsg::print(">> ");        
+    std::string reply{getInput<std::string>()};
+    // convert reply to upper case letters just in case
+    std::transform(reply.begin(), reply.end(), reply.begin(), ::toupper);
+    if (reply == "Y") {
+        return noOfFiles;
+    } else if (reply == "N") {
+        // ask user to create a folder before doing simulation
+        ScreenMsg::print("Please create folder 'sim_" + dataType + "' within this code directory.\n");            
+    }
+    return 0;
+}
+
 /* ------------------------------------------------------------------------
 * DATA INPUT MENU MANAGER
 * -----------------------------------------------------------------------*/
 
+// read data of type T from file(s) or screen, or simulate it, and analyse it
+template <typename T> void analyseData(const std::string& DataHeroPath, MainMenu& mainMenu,
+                                      const std::string& choice, const std::string& dataPath,
+                                      const std::string& dataType) {
+    DataManager<T> data;
+    bool dataExists{false};
+    if (choice == "S") {
+        dataExists = DataInput<T>::readFromScreen(data);
+    } else if (choice == "F") {
+        dataExists = DataInput<T>::readFromFile(data, dataPath);
+    } else {
+        unsigned noOfFiles{getNoOfSimulatedFiles(dataType)};
+        std::string lowerType{dataType};
+        std::transform(lowerType.begin(), lowerType.end(), lowerType.begin(), ::tolower);
+        // simulated straight into memory, the files are written meanwhile
+        if (noOfFiles > 0) dataExists = Simulation::simulateData(data, DataHeroPath, noOfFiles, lowerType);
+    }
+    if (dataExists) {
+        // data exists, call analysis menu
+        analysisChoiceManager(DataHeroPath, mainMenu, data);
+    }
+}
+
 void dataInputChoiceManager(const std::string& DataHeroPath, MainMenu& mainMenu) {
     // get user choice of data type
     std::string dataType = getDataType();
     // variable storing data path if input from file(s)
     std::string dataPath;
-    bool dataExists{false};
     mainMenu.infoCmdsShow("INPUT");
     // get user's menu option choice  
     std::string choice{mainMenu.getMenuInput()}; 
-    // if choice is to simulate data or read from file
-    if (choice == "SIM" || choice == "F") {
-        dataPath = getDataPath(DataHeroPath, choice, dataType);
-        if (dataType == "DOUBLE") {
-            DataManager<double> data;
-            dataExists = DataInput<double>::readFromFile(data, dataPath);
-            if (dataExists) {
-                // data exists, call analysis menu
-                analysisChoiceManager<double>(DataHeroPath, mainMenu, data);                
-            }
-        } else if (dataType == "INT") {
-            DataManager<int> data;
-            dataExists = DataInput<int>::readFromFile(data, dataPath); 
-            if (dataExists) {
-                // data exists, call analysis menu
-                analysisChoiceManager<int>(DataHeroPath, mainMenu, data); 
-            }        
-        } else if (dataType == "COMPLEXDOUBLE") {
-            DataManager<std::complex<double>> data;
-            dataExists = DataInput<std::complex<double>>::readFromFile(data, dataPath); 
-            if (dataExists) {
-                // data exists, call analysis menu
-                analysisChoiceManager<std::complex<double>>(DataHeroPath, mainMenu, data); 
-            }
-        }   
-    // if choice is to read from screen 
-    } else if (choice == "S") {
-        if (dataType == "DOUBLE") {
-            DataManager<double> data;
-            dataExists = DataInput<double>::readFromScreen(data);
-            if (dataExists) {
-                // data exists, call analysis menu
-				analysisChoiceManager<double>(DataHeroPath, mainMenu, data);
-            } 
-        } else if (dataType == "INT") {
-            DataManager<int> data;
-            dataExists = DataInput<int>::readFromScreen(data); 
-            if (dataExists) {
-                // data exists, call analysis menu
-				analysisChoiceManager<int>(DataHeroPath, mainMenu, data);
-            }   
-        } else if (dataType == "COMPLEXDOUBLE") {
-            DataManager<std::complex<double>> data;
-            dataExists = DataInput<std::complex<double>>::readFromScreen(data); 
-            if (dataExists) {
-                // data exists, call analysis menu
-                analysisChoiceManager<std::complex<double>>(DataHeroPath, mainMenu, data); 
-            } 
-        }     
-    } 
-    else ErrorMsg::print("\n[ERRPR] Input not recognised, try again\n");
+    if (choice != "SIM" && choice != "F" && choice != "S") {
+        ErrorMsg::print("\n[ERRPR] Input not recognised, try again\n");
+        return;
+    }
+    if (dataType == "AUTO") {
+        // types are detected from the values in files
+        if (choice != "F") {
+            ErrorMsg::print("\n[MAIN] Data type <auto> needs input from file(s)\n");
+            return;
+        }
+        MixedDataManager data;
+        if (MixedDataInput::readFromFile(data, getDataPath(DataHeroPath, choice, dataType))) {
+            // data exists, call analysis menu
+            analysisChoiceManager(DataHeroPath, mainMenu, data);
+        }
+        return;
+    }
+    // if choice is to read from file
+    if (choice == "F") dataPath = getDataPath(DataHeroPath, choice, dataType);
+    if (dataType == "DOUBLE") analyseData<double>(DataHeroPath, mainMenu, choice, dataPath, dataType);
+    else if (dataType == "INT") analyseData<int>(DataHeroPath, mainMenu, choice, dataPath, dataType);
+    else analyseData<std::complex<double>>(DataHeroPath, mainMenu, choice, dataPath, dataType);
 }
 
 
@@ -316,7 +367,10 @@ void dataInputChoiceManager(const std::string& DataHeroPath, MainMenu& mainMenu)
 * MAIN PROGRAM
 * -----------------------------------------------------------------------*/
 
-int main() {
+int main(int argc, char* argv[]) {
+
+	// any command line arguments select batch mode: no prompts, no menus
+	if (argc > 1) return BatchMode::run(argc, argv);
 
 	/* ------------------------------------------------------------------------
 	* POLYMORPHISM : INITIALISE MAIN MENU
@@ -341,8 +395,13 @@ int main() {
 		CommandUniquePtr{ new ShowDataInfo },
 		CommandUniquePtr{ new FileReportInfo },
 		CommandUniquePtr{ new ScreenReportInfo },
+		CommandUniquePtr{ new RangeDataInfo },
+		CommandUniquePtr{ new RangeReportInfo },
 		CommandUniquePtr{ new DelInfo },
 		CommandUniquePtr{ new DelValInfo },
+		CommandUniquePtr{ new CacheInfo },
+		CommandUniquePtr{ new MemoryInfo },
+		CommandUniquePtr{ new FreezeInfo },
 		CommandUniquePtr{ new ExitAnalysisInfo }
 	};
 
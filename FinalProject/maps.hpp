@@ -5,24 +5,76 @@
 #include <list>     // list
 #include <map>      // map
 #include <sstream>  // stringstream
+#include <vector>   // vector
+#include <chrono>   // steady_clock
+#include <iomanip>  // setprecision
+#include <algorithm> // sort
 
 #include "measurement.hpp" // classes managing measurements
 #include "project.hpp"     // classes managing project
+#include "threadPool.hpp"  // work-stealing thread pool
+#include "reportCache.hpp" // versioned report cache
+#include "frozenDb.hpp"    // read-optimised layout of loaded data
+#include "instrument.hpp"  // allocation and copy accounting
+#include "trace.hpp"       // hot path tracing
+#include "metrics.hpp"     // operational metrics
 
 /* ------------------------------------------------------------------------
 * DEFINE SOME TYPES
 * -----------------------------------------------------------------------*/
 
+// all map nodes of a DataManager are allocated from its arena
+
 // staff database and project database are multimaps of strings
-using ProjectReferenceDbType = std::multimap<std::string, std::string>;
+using ProjectReferenceDbType = std::multimap<std::string, std::string, std::less<std::string>,
+                                             ArenaAllocator<std::pair<const std::string, std::string>>>;
 // project database key is a pair of staff and project
 using ProjectDbKeyType = std::pair<std::string, std::string>;
 // project reference database contains shared pointers to measurements
 template <typename T> 
-using ProjectDbType = std::map<ProjectDbKeyType, ProjectSharedPtr<T>>;
+using ProjectDbType = std::map<ProjectDbKeyType, ProjectSharedPtr<T>, std::less<ProjectDbKeyType>,
+                               ArenaAllocator<std::pair<const ProjectDbKeyType, ProjectSharedPtr<T>>>>;
 // project shadow database has weak pointers to project database measurements
 template <typename T> 
-using ProjectShadowDbType = std::map<ProjectDbKeyType, ProjectWeakPtr<T>>;
+using ProjectShadowDbType = std::map<ProjectDbKeyType, ProjectWeakPtr<T>, std::less<ProjectDbKeyType>,
+                                     ArenaAllocator<std::pair<const ProjectDbKeyType, ProjectWeakPtr<T>>>>;
+// versions of projects
+using ProjectVersionDbType = std::map<ProjectDbKeyType, unsigned long, std::less<ProjectDbKeyType>,
+                                      ArenaAllocator<std::pair<const ProjectDbKeyType, unsigned long>>>;
+
+/* ------------------------------------------------------------------------
+* MEMORY FOOTPRINT OF PROJECTS
+* -----------------------------------------------------------------------*/
+
+// heap bytes held for one or more projects, as requested by their
+// containers; the arena rounds requests up to its size classes on top.
+// Measurements and block indices are counted from the capacities of their
+// containers, map entries and names are estimated from the usual node
+// layout of std::map, which the standard does not fix
+struct MemoryFootprint {
+    // measurement blocks and project objects
+    std::size_t storageBytes;
+    // block indices and the estimated map entries leading to the projects
+    std::size_t indexBytes;
+    // estimated staff and project names in the map entries
+    std::size_t nameBytes;
+
+    std::size_t getTotal() const { return storageBytes + indexBytes + nameBytes; }
+
+    // add footprint of other projects
+    MemoryFootprint& operator+=(const MemoryFootprint& otherFootprint) {
+        storageBytes += otherFootprint.storageBytes;
+        indexBytes += otherFootprint.indexBytes;
+        nameBytes += otherFootprint.nameBytes;
+        return *this;
+    }
+
+    // return heap bytes of a string, 0 if it is short enough to be kept
+    // inside the string object
+    static std::size_t getStringBytes(const std::string& text) {
+        return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+    }
+};
 
 /* ------------------------------------------------------------------------
 * PROJECT REFERENCE DATABASE CLASS
@@ -42,15 +94,18 @@ public:
         DebugMsg::print("[PROJECT-REF-DB] Default constructor called\n");        
     }
 
-    // parametrised constructor
-    ProjectReferenceDb(const std::string& mapFrom, const std::string& mapTo) 
-                      : keys(mapFrom), values(mapTo) {
+    // parametrised constructor, map nodes are allocated from arena
+    ProjectReferenceDb(const std::string& mapFrom, const std::string& mapTo,
+                       const std::shared_ptr<Arena>& arena = std::shared_ptr<Arena>()) 
+                      : database(ProjectReferenceDbType::allocator_type(arena)), keys(mapFrom), values(mapTo),
+                        dataContainer(typename ProjectShadowDbType<T>::allocator_type(arena)) {
         DebugMsg::print("[PROJECT-REF-DB] Parametrised constructor called\n");
     }
 
     // copy constructor for deep copying
     ProjectReferenceDb(const ProjectReferenceDb& userDatabase) {
         DebugMsg::print("[PROJECT-REF-DB] Copy constructor for deep copying called\n");
+        Instrument::countCopy(InstrumentedType::PROJECT_REFERENCE_DB);
         this->database = userDatabase.database;
         this->keys = userDatabase.keys;
         this->values = userDatabase.values;
@@ -60,6 +115,7 @@ public:
     // move constructor
     ProjectReferenceDb(ProjectReferenceDb&& userDatabase) {
         DebugMsg::print("[[PROJECT-REF-DB] Move constructor called\n");
+        Instrument::countMove(InstrumentedType::PROJECT_REFERENCE_DB);
         // steal the data
         this->database = move(userDatabase.database);
         this->keys = move(userDatabase.keys);
@@ -79,6 +135,7 @@ public:
     // copy assignment operator
     ProjectReferenceDb& operator=(const ProjectReferenceDb& userDatabase) {
         DebugMsg::print("[PROJECT-REF-DB] Copy assignment operator called\n");
+        Instrument::countCopy(InstrumentedType::PROJECT_REFERENCE_DB);
         if (&userDatabase == this) { return *this; } // no self-assignment
         // first delete this object’s data
         this->database.clear();
@@ -96,6 +153,7 @@ public:
     // move assignment operator
     ProjectReferenceDb& operator=(ProjectReferenceDb&& userDatabase) {
         DebugMsg::print("[PROJECT-REF-DB] Move assignment operator called\n");
+        Instrument::countMove(InstrumentedType::PROJECT_REFERENCE_DB);
         std::swap(this->database, userDatabase.database);  
         std::swap(this->keys, userDatabase.keys); 
         std::swap(this->values, userDatabase.values); 
@@ -106,25 +164,31 @@ public:
     // insert data to map
     void addEntry(const std::string& userKey, const std::string& userValue, 
                   ProjectWeakPtr<T> weakProject) {
-        // find key
-        auto nameList = database.equal_range(userKey);
-        // key not found by default
-        bool keyFound = false;
-        // iterate through database
-        for (auto it = nameList.first; it != nameList.second; ++it) {
-            if (it->second == userValue) {
-                // found that staff already has this project
-                keyFound = true;
-            }
-        }
-        if (!keyFound) {
-           // key does not exist yet, hence insert
-    	   database.insert(std::make_pair(userKey, userValue));
-        }
+        InstrumentScope instrumentScope("ProjectReferenceDb::addEntry");
         // make a key
         auto key = std::make_pair(userKey, userValue);
-        // ensure that list is up-to-date
-        dataContainer[key] = weakProject;
+        // every pair of the database has a weak pointer, so the pair is
+        // found without walking all values of userKey
+        auto entry = dataContainer.find(key);
+        if (entry == dataContainer.end()) {
+            // key does not exist yet, hence insert
+            database.insert(std::make_pair(userKey, userValue));
+            dataContainer.insert(std::make_pair(key, weakProject));
+        } else {
+            // ensure that list is up-to-date
+            entry->second = weakProject;
+        }
+    }
+
+    // return true if userKey has entries, even if their projects expired
+    bool contains(const std::string& userKey) const {
+        return this->database.find(userKey) != this->database.end();
+    }
+
+    // return true if the pair of userKey and userValue has an entry, even
+    // if its project expired
+    bool contains(const std::string& userKey, const std::string& userValue) const {
+        return this->dataContainer.find(std::make_pair(userKey, userValue)) != this->dataContainer.end();
     }
 
     // return stringstream of all entries
@@ -141,8 +205,9 @@ public:
         return stringStream.str();
     }
 
-    // return stringstream of a specific entry
-    std::string show(const std::string& userKey) {
+    // return stringstream of a specific entry, optionally only measurements 
+    // within time range (projects without any are then left out)
+    std::string show(const std::string& userKey, const TimeRange& range = TimeRange{}) {
         std::ostringstream stringStream;
         // find all values matching userKey
         auto ret = database.equal_range(userKey);
@@ -153,6 +218,15 @@ public:
             // iterate through that range of values
             for (auto it = ret.first; it != ret.second; ++it) {
                 auto key = std::make_pair(it->first, it->second);
+                auto projectWeakPtr = this->dataContainer[key];
+                std::list<Measurement<T>> measurements;
+                if (range.isRange) {
+                    auto projectPtr = projectWeakPtr.lock();
+                    if (projectPtr) {
+                        measurements = projectPtr.get()->getMeasurements(range.startTime, range.endTime);
+                    }
+                    if (measurements.empty()) continue;
+                }
                 // get table header
                 stringStream << std::endl
                          << keys   << ": " << key.first  << std::endl
@@ -160,10 +234,9 @@ public:
                          << "-----------------------------" << std::endl
                          << "Timestamp\tMeasurement       " << std::endl
                          << "-----------------------------" << std::endl;
-                auto projectWeakPtr = this->dataContainer[key];
                 // lock weak pointer while
                 if (auto projectPtr = projectWeakPtr.lock()) { 
-                    auto measurements = projectPtr.get()->getMeasurements();
+                    if (!range.isRange) measurements = projectPtr.get()->getMeasurements();
                     for (auto iter = measurements.begin(); iter != measurements.end(); ++iter) {
                         stringStream << *iter << std::endl;
                     }
@@ -177,6 +250,25 @@ public:
         return stringStream.str();
     }
 
+    // return projects matching specific key which still exist, in database order
+    std::vector<ProjectSharedPtr<T>> getProjects(const std::string& userKey) {
+        std::vector<ProjectSharedPtr<T>> projects;
+        // find all map entries with userKey
+        auto ret = database.equal_range(userKey);
+        for (auto it = ret.first; it != ret.second; ++it) {
+            // make new key from userKey and its corresponding value in map
+            auto key = std::make_pair(it->first, it->second); 
+            // get project weak pointers to data
+            auto projectWeakPtr = this->dataContainer[key]; 
+            // lock creates a shared_ptr that manages the referenced object 
+            // so that we can access the data     
+            if (auto projectPtr = projectWeakPtr.lock()) {
+                projects.push_back(projectPtr);
+            }
+        }
+        return projects;
+    }
+
     // return report stingstream matching specific key
     std::string getReport(const std::string& userKey) {
         std::ostringstream stringStream;
@@ -186,18 +278,17 @@ public:
         if (ret.first == ret.second) {
             ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
         } else {
-            for (auto it = ret.first; it != ret.second; ++it) {
-                // make new key from userKey and its corresponding value in map
-                auto key = std::make_pair(it->first, it->second); 
-                // get project weak pointers to data
-                auto projectWeakPtr = this->dataContainer[key]; 
-                // lock creates a shared_ptr that manages the referenced object 
-                // so that we can access the data     
-                if (auto projectPtr = projectWeakPtr.lock()) {
-                    // get report associated with key
-                    stringStream << projectPtr.get()->getReport();
-                }
-            }   
+            // collect projects in database order
+            std::vector<ProjectSharedPtr<T>> projects{this->getProjects(userKey)};
+            // compute reports in parallel, each into its own slot
+            std::vector<std::string> reports(projects.size());
+            WorkStealingPool::getSharedPool().parallelFor(projects.size(), [&](std::size_t i) {
+                reports[i] = projects[i].get()->getReport();
+            });
+            // print reports in database order
+            for (auto it = reports.begin(); it != reports.end(); ++it) {
+                stringStream << *it;
+            }
         }
         return stringStream.str(); 
     }
@@ -210,6 +301,20 @@ public:
 template <typename T> class ProjectDb {
 private:
     ProjectDbType<T> database;
+    // copy projects shared with published snapshots before changing them
+    bool copyOnWrite{false};
+
+    // return project of map entry for changing, replaced by a private copy
+    // first if a published snapshot may still be reading it
+    Project<T>* getWritable(typename ProjectDbType<T>::iterator dbProjectIterator) {
+        ProjectSharedPtr<T>& project = dbProjectIterator->second;
+        if (copyOnWrite && project.use_count() > 1) {
+            DebugMsg::print("[PROJECT-DB] Project shared with a snapshot, copying it\n");
+            ArenaAllocator<Project<T>> allocator(database.get_allocator().getArena());
+            project = std::allocate_shared<Project<T>>(allocator, *project);
+        }
+        return project.get();
+    }
 
 public:
 
@@ -223,15 +328,23 @@ public:
         DebugMsg::print("[PROJECT] Parametrised constructor called\n");
     }
 
+    // parametrised constructor - empty database allocating from arena
+    ProjectDb(const std::shared_ptr<Arena>& arena) 
+             : database(typename ProjectDbType<T>::allocator_type(arena)) {
+        DebugMsg::print("[PROJECT] Parametrised constructor called\n");
+    }
+
     // copy constructor for deep copying
     ProjectDb(const ProjectDb& userDatabase) {
         DebugMsg::print("[PROJECT] Copy constructor for deep copying called\n");
+        Instrument::countCopy(InstrumentedType::PROJECT_DB);
         this->database = userDatabase.database;
     }
 
     // move constructor
     ProjectDb(ProjectDb&& userDatabase) {
         DebugMsg::print("[PROJECT] Move constructor called\n");
+        Instrument::countMove(InstrumentedType::PROJECT_DB);
         // steal the data
         this->database = move(userDatabase.database);
     }
@@ -243,10 +356,12 @@ public:
     // access functions
     ProjectDbType<T> getDatabase() const { return this->database; }
     std::size_t getSize() { return this->database.size(); }
+    void setCopyOnWrite(const bool& userCopyOnWrite) { this->copyOnWrite = userCopyOnWrite; }
 
     // copy assignment operator
     ProjectDb& operator=(const ProjectDb& userDatabase) {
         DebugMsg::print("[PROJECT] Copy assignment operator called\n");
+        Instrument::countCopy(InstrumentedType::PROJECT_DB);
         if (&userDatabase == this) { return *this; } // no self-assignment
         // first delete this object’s data
         this->database.clear();
@@ -258,14 +373,35 @@ public:
     // move assignment operator
     ProjectDb& operator=(ProjectDb&& userDatabase) {
         DebugMsg::print("[PROJECT] Move assignment operator called\n");
+        Instrument::countMove(InstrumentedType::PROJECT_DB);
         std::swap(this->database, userDatabase.database);  
         return *this;
     }
 
+    // return all projects in staff/project order
+    std::vector<ProjectSharedPtr<T>> getProjects() const {
+        std::vector<ProjectSharedPtr<T>> projects;
+        projects.reserve(this->database.size());
+        for (auto it = this->database.begin(); it != this->database.end(); ++it) {
+            projects.push_back(it->second);
+        }
+        return projects;
+    }
+
+    // return project matching key, empty pointer if it does not exist
+    ProjectSharedPtr<T> getProject(const std::string& staffName, 
+                                   const std::string& projectName) const {
+        auto dbProjectIterator = database.find(std::make_pair(staffName, projectName));
+        if (dbProjectIterator == database.end()) return ProjectSharedPtr<T>{};
+        return dbProjectIterator->second;
+    }
+
     // return shared pointers (shared with ProjectReferenceDb class)
     ProjectSharedPtr<T> addEntry(const std::string& staffName, 
                                  const std::string& projectName, 
-                                 ExperimentSharedPtr<T> experimentSharedPtr) {
+                                 Experiment<T>&& experiment) {
+        InstrumentScope instrumentScope("ProjectDb::addEntry");
+        TraceSpan traceSpan("ProjectDb::addEntry", "insert");
         // make a key
     	auto key = std::make_pair(staffName, projectName);
         // insert data into database
@@ -273,18 +409,18 @@ public:
         if (dbProjectIterator != database.end()) {
             DebugMsg::print("[PROJECT-DB] Existing project found, merging experiments\n");
             // if there already exist data mathing the key, add new data
-            Project<T> newProject{experimentSharedPtr};
-            (dbProjectIterator->second).get()->mergeExperiment(newProject);
+            this->getWritable(dbProjectIterator)->mergeExperiment(experiment);
             // database[key] gets automatically updated when the value the pointer is showing to changes
-        } else {
-            DebugMsg::print("[PROJECT-DB] No project found, adding experiment as project\n");
-            // else insert new entry into the map
-            Project<T> newProject{experimentSharedPtr};
-            auto newProjectPtr = std::make_shared<Project<T>> (newProject);
-            database[key] = newProjectPtr;
+            return dbProjectIterator->second;
         }
+        DebugMsg::print("[PROJECT-DB] No project found, adding experiment as project\n");
+        // else insert new entry into the map, the project and its reference
+        // counts are allocated together from the arena of the database
+        ArenaAllocator<Project<T>> allocator(database.get_allocator().getArena());
+        auto newProjectPtr = std::allocate_shared<Project<T>>(allocator, std::move(experiment));
+        database.insert(std::make_pair(key, newProjectPtr));
         // return shared pointers
-        return database[key];
+        return newProjectPtr;
     }
 
     // delete data from the map
@@ -303,6 +439,16 @@ public:
         return true;
     }
 
+    // remove entry from the map and return its project, empty pointer if
+    // it does not exist
+    ProjectSharedPtr<T> takeEntry(const std::string& staff, const std::string& project) {
+        auto dbProjectIterator = database.find(std::make_pair(staff, project));
+        if (dbProjectIterator == database.end()) return ProjectSharedPtr<T>{};
+        ProjectSharedPtr<T> taken{dbProjectIterator->second};
+        database.erase(dbProjectIterator);
+        return taken;
+    }
+
     // delete data from the map
     bool deleteMeasurementRange(const std::string& staff, const std::string& project, 
                                 const unsigned& startTime, const unsigned& endTime) {
@@ -312,7 +458,7 @@ public:
         auto dbProjectIterator = database.find(key);  
         if (dbProjectIterator != database.end()) {
             DebugMsg::print("[PROJECT-DB] Existing project found\n");
-            Project<T> *theProject = (dbProjectIterator->second).get();
+            Project<T> *theProject = this->getWritable(dbProjectIterator);
             bool success = theProject->deleteMeasurementRange(startTime, endTime);
 			if (success) ScreenMsg::print("\n[PROJECT-DB] Measurements deleted\n");
 			else return false;
@@ -323,12 +469,29 @@ public:
         return true;  
     }
 
-    // return stringstream of all entries    
-    std::string show() {
+    // compact project if nobody else holds it, i.e. it is new or changed
+    // since it was last shared with a snapshot
+    void compactUnshared(const std::string& staff, const std::string& project) {
+        auto dbProjectIterator = database.find(std::make_pair(staff, project));
+        if (dbProjectIterator != database.end() && dbProjectIterator->second.use_count() == 1) {
+            (dbProjectIterator->second).get()->compactMeasurements();
+        }
+    }
+
+    // return stringstream of all entries, optionally only measurements within
+    // time range (projects without any are then left out)
+    std::string show(const TimeRange& range = TimeRange{}) {
+        TraceSpan traceSpan("ProjectDb::show", "format");
         std::ostringstream stringStream;
         for (auto it = this->database.begin(); it != this->database.end(); ++it) {
             // key contains staff name and project name
             auto key = it->first; 
+            // get data 
+            auto experimentSharedPtr = it->second;
+            auto measurements = range.isRange 
+                ? experimentSharedPtr.get()->getMeasurements(range.startTime, range.endTime)
+                : experimentSharedPtr.get()->getMeasurements();
+            if (range.isRange && measurements.empty()) continue;
             // print table header
             stringStream << std::endl
                          << "Staff: "   << key.first        << std::endl
@@ -336,9 +499,6 @@ public:
                          << "-----------------------------" << std::endl
                          << "Timestamp\tMeasurement       " << std::endl
                          << "-----------------------------" << std::endl;
-            // get data 
-            auto experimentSharedPtr = it->second;
-            auto measurements = experimentSharedPtr.get()->getMeasurements();
             for (auto iter = measurements.begin(); iter != measurements.end(); ++iter) {
                 stringStream << *iter << std::endl;
             }
@@ -346,8 +506,10 @@ public:
         return stringStream.str();
     }
 
-    // return stringstream of a specific entry
-    std::string show(const std::string& staffName, const std::string& projectName) {
+    // return stringstream of a specific entry, optionally only measurements 
+    // within time range
+    std::string show(const std::string& staffName, const std::string& projectName,
+                     const TimeRange& range = TimeRange{}) {
         std::ostringstream stringStream;
         // make a key
         auto key = std::make_pair(staffName, projectName);
@@ -363,7 +525,10 @@ public:
                          << "-----------------------------" << std::endl;
             // get data
             auto experimentSharedPtr = dbProjectIterator->second;
-            auto measurements = experimentSharedPtr.get()->getMeasurements();
+            auto measurements = range.isRange 
+                ? experimentSharedPtr.get()->getMeasurements(range.startTime, range.endTime)
+                : experimentSharedPtr.get()->getMeasurements();
+            if (range.isRange && measurements.empty()) return "";
             for (auto iter = measurements.begin(); iter != measurements.end(); ++iter) {
                 stringStream << *iter << std::endl;
             }
@@ -377,9 +542,17 @@ public:
     // return all data report stingstream 
     std::string getReport() {
         std::ostringstream stringStream;
-        for (auto it = this->database.begin(); it != this->database.end(); ++it) {
-            auto experimentSharedPtr = it->second;
-            stringStream << experimentSharedPtr.get()->getReport();    
+        // collect projects in staff/project order
+        std::vector<ProjectSharedPtr<T>> projects{this->getProjects()};
+        // compute reports on the work-stealing pool, each into its own slot,
+        // so that one large project does not hold up the rest
+        std::vector<std::string> reports(projects.size());
+        WorkStealingPool::getSharedPool().parallelFor(projects.size(), [&](std::size_t i) {
+            reports[i] = projects[i].get()->getReport();
+        });
+        // print reports in staff/project order, as if computed one by one
+        for (auto it = reports.begin(); it != reports.end(); ++it) {
+            stringStream << *it;
         }
         return stringStream.str();    
     }
@@ -406,9 +579,199 @@ public:
 
 template <typename T> class DataManager {
 private:
-	ProjectDb<T> fullDatabase;
-    ProjectReferenceDb<T> staffDatabase{"Staff", "Project"};
-    ProjectReferenceDb<T> projectDatabase{"Project", "Staff"};
+    // pooled memory of measurements, projects and map nodes, released in
+    // whole chunks when the dataset is destroyed
+    std::shared_ptr<Arena> arena{std::make_shared<Arena>()};
+	ProjectDb<T> fullDatabase{arena};
+    ProjectReferenceDb<T> staffDatabase{"Staff", "Project", arena};
+    ProjectReferenceDb<T> projectDatabase{"Project", "Staff", arena};
+    // version counters, bumped every time a project changes
+    ProjectVersionDbType projectVersions{ProjectVersionDbType::allocator_type(arena)};
+    // reports and data views computed so far
+    ReportCache reportCache;
+    // read-optimised layout, used for all queries while frozen
+    FrozenDb<T> frozenDatabase;
+    // footprint total of all projects, kept up to date by every change,
+    // and the largest it has been
+    std::size_t projectBytes{};
+    std::size_t peakProjectBytes{};
+
+    // return memory held for project: its measurements, the indices and
+    // map entries leading to it and the names in both; the map entries are
+    // an estimate, the maps do not report the size of their nodes
+    MemoryFootprint getFootprint(const Project<T>& project) const {
+        // red-black tree node as laid out by common standard libraries:
+        // colour, parent, left and right pointers
+        const std::size_t nodeOverhead{4 * sizeof(void*)};
+        // the project has an entry in the project map, both reference maps,
+        // both shadow maps and the version map, each holding both names
+        const std::size_t noOfEntries{6};
+        std::size_t entryBytes{noOfEntries * nodeOverhead + sizeof(typename ProjectDbType<T>::value_type)
+                               + 2 * sizeof(ProjectReferenceDbType::value_type)
+                               + 2 * sizeof(typename ProjectShadowDbType<T>::value_type)
+                               + sizeof(ProjectVersionDbType::value_type)};
+        std::size_t nameObjectBytes{2 * noOfEntries * sizeof(std::string)};
+        // long names are on the heap once for every entry and the project
+        std::size_t nameHeapBytes{MemoryFootprint::getStringBytes(project.getStaffName())
+                                  + MemoryFootprint::getStringBytes(project.getProjectName())};
+        return MemoryFootprint{sizeof(Project<T>) + project.getSeries().getStorageBytes(),
+                               project.getSeries().getIndexBytes() + entryBytes - nameObjectBytes,
+                               nameObjectBytes + (noOfEntries + 1) * nameHeapBytes};
+    }
+
+    // return footprint total of existing project, 0 if it does not exist
+    std::size_t getFootprintTotal(const std::string& staff, const std::string& project) const {
+        ProjectSharedPtr<T> found{this->fullDatabase.getProject(staff, project)};
+        return found ? this->getFootprint(*found).getTotal() : 0;
+    }
+
+    // account change of a footprint total from before to after bytes
+    void updateProjectBytes(const std::size_t& before, const std::size_t& after) {
+        this->projectBytes = this->projectBytes - before + after;
+        if (this->projectBytes > this->peakProjectBytes) this->peakProjectBytes = this->projectBytes;
+    }
+
+    // count footprint total of all projects afresh, e.g. after they were
+    // compacted or queries built their indices
+    void recountProjectBytes() {
+        std::vector<ProjectSharedPtr<T>> projects{this->fullDatabase.getProjects()};
+        std::size_t total{};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            total += this->getFootprint(**it).getTotal();
+        }
+        this->updateProjectBytes(this->projectBytes, total);
+    }
+
+    // return current version of a project
+    unsigned long getVersion(const ProjectDbKeyType& key) const {
+        auto it = projectVersions.find(key);
+        if (it == projectVersions.end()) return 0;
+        return it->second;
+    }
+
+    // mark project as changed so that cached results using it become stale
+    void bumpVersion(const std::string& staff, const std::string& project) {
+        ++projectVersions[std::make_pair(staff, project)];
+    }
+
+    // fill frozen layout with the current projects and reference pairs
+    void buildFrozen(FrozenDb<T>& frozen) const {
+        frozen.build(this->fullDatabase.getProjects(), this->getReferenceEntries(QueryScope::STAFF),
+                     this->getReferenceEntries(QueryScope::PROJECT));
+    }
+
+    // return projects covered by query, in the order they are printed
+    std::vector<ProjectSharedPtr<T>> getQueryProjects(const QueryKey& query) {
+        if (frozenDatabase.isFrozen()) return frozenDatabase.getProjects(query);
+        switch (query.scope) {
+        case QueryScope::ALL:
+            return this->fullDatabase.getProjects();
+        case QueryScope::STAFF:
+            return this->staffDatabase.getProjects(query.staffName);
+        case QueryScope::PROJECT:
+            return this->projectDatabase.getProjects(query.projectName);
+        default:
+            ProjectSharedPtr<T> project{this->fullDatabase.getProject(query.staffName, query.projectName)};
+            if (project) return std::vector<ProjectSharedPtr<T>>{project};
+            return std::vector<ProjectSharedPtr<T>>{};
+        }
+    }
+
+    // return key and current version of every project
+    ProjectVersionList getDependencies(const std::vector<ProjectSharedPtr<T>>& projects) const {
+        ProjectVersionList dependencies;
+        dependencies.reserve(projects.size());
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            auto key = std::make_pair((*it).get()->getStaffName(), (*it).get()->getProjectName());
+            dependencies.push_back(std::make_pair(key, this->getVersion(key)));
+        }
+        return dependencies;
+    }
+
+    // compute query output without the cache
+    std::string computeUncached(const QueryKey& query) {
+        if (frozenDatabase.isFrozen()) {
+            if (query.view == QueryView::DATA) return this->frozenDatabase.show(query);
+            return this->frozenDatabase.getReport(query);
+        }
+        if (query.view == QueryView::DATA) {
+            switch (query.scope) {
+            case QueryScope::ALL: return this->fullDatabase.show(query.range);
+            case QueryScope::STAFF: return this->staffDatabase.show(query.staffName, query.range);
+            case QueryScope::PROJECT: return this->projectDatabase.show(query.projectName, query.range);
+            default: return this->fullDatabase.show(query.staffName, query.projectName, query.range);
+            }
+        }
+        switch (query.scope) {
+        case QueryScope::ALL: return this->fullDatabase.getReport();
+        case QueryScope::STAFF: return this->staffDatabase.getReport(query.staffName);
+        case QueryScope::PROJECT: return this->projectDatabase.getReport(query.projectName);
+        default: return this->fullDatabase.getReport(query.staffName, query.projectName);
+        }
+    }
+
+    // return report of every project, recomputing only stale project reports
+    std::vector<std::string> computeReports(const std::vector<ProjectSharedPtr<T>>& projects,
+                                            const ProjectVersionList& dependencies, const TimeRange& range) {
+        TraceSpan traceSpan("DataManager::computeReports", "report");
+        std::vector<std::string> reports(projects.size());
+        // find which project reports have to be recomputed
+        std::vector<std::size_t> stale;
+        for (std::size_t i{}; i < projects.size(); ++i) {
+            if (!reportCache.findFragment(dependencies[i].first, range, dependencies[i].second, reports[i])) {
+                stale.push_back(i);
+            }
+        }
+        // recompute them on the work-stealing pool
+        WorkStealingPool::getSharedPool().parallelFor(stale.size(), [&](std::size_t j) {
+            std::size_t i{stale[j]};
+            if (range.isRange) reports[i] = projects[i].get()->getReport(range.startTime, range.endTime);
+            else reports[i] = projects[i].get()->getReport();
+        });
+        for (auto it = stale.begin(); it != stale.end(); ++it) {
+            reportCache.storeFragment(dependencies[*it].first, range, dependencies[*it].second, reports[*it]);
+        }
+        return reports;
+    }
+
+    // put together report of several projects, recomputing only stale project reports
+    std::string assembleReport(const std::vector<ProjectSharedPtr<T>>& projects,
+                               const ProjectVersionList& dependencies, const TimeRange& range) {
+        std::vector<std::string> reports{this->computeReports(projects, dependencies, range)};
+        TraceSpan traceSpan("DataManager::assembleReport", "format");
+        // print reports in the order projects were given
+        std::ostringstream stringStream;
+        for (auto it = reports.begin(); it != reports.end(); ++it) {
+            stringStream << *it;
+        }
+        return stringStream.str();
+    }
+
+    // return query output, reusing cached results which are still up to date
+    std::string runQuery(const QueryKey& query) {
+        InstrumentScope instrumentScope(query.view == QueryView::REPORT ? "DataManager::getReport"
+                                                                        : "DataManager::show");
+        TraceSpan traceSpan("DataManager::runQuery", "query");
+        MetricTimer reportTimer(query.view == QueryView::REPORT ? &Metrics::getReportLatency() : nullptr);
+        if (query.view == QueryView::REPORT) Metrics::getReportCalls().add();
+        std::vector<ProjectSharedPtr<T>> projects{this->getQueryProjects(query)};
+        // nothing to cache, let the database print why
+        if (projects.empty()) return this->computeUncached(query);
+        ProjectVersionList dependencies{this->getDependencies(projects)};
+        std::string output;
+        if (reportCache.findQuery(query, dependencies, output)) return output;
+        if (query.view == QueryView::DATA) {
+            output = this->computeUncached(query);
+        } else {
+            output = this->assembleReport(projects, dependencies, query.range);
+        }
+        if (output.empty() && query.range.isRange) {
+            ErrorMsg::print("\n[DATA-MANAGER] No measurements found in specified time range\n");
+        }
+        // do not keep failed queries, so that their errors are printed again
+        if (!output.empty()) reportCache.storeQuery(query, dependencies, output);
+        return output;
+    }
 
 public:
 	// default constructor
@@ -422,15 +785,22 @@ public:
         this->fullDatabase = userDataManager.fullDatabase;
         this->staffDatabase = userDataManager.staffDatabase;
         this->projectDatabase = userDataManager.projectDatabase;
+        this->projectVersions = userDataManager.projectVersions;
+        this->reportCache = userDataManager.reportCache;
+        this->frozenDatabase = userDataManager.frozenDatabase;
     }
 
     // move constructor
     DataManager(DataManager&& userDataManager) {
         DebugMsg::print("[DATA-MANAGER] Move constructor called\n");
-        // steal the data
-        this->fullDatabase = move(userDataManager.fullDatabase);
-        this->staffDatabase = move(userDataManager.staffDatabase);
-        this->projectDatabase = move(userDataManager.projectDatabase);
+        // steal the data together with the arena holding it
+        std::swap(this->arena, userDataManager.arena);
+        this->fullDatabase = std::move(userDataManager.fullDatabase);
+        this->staffDatabase = std::move(userDataManager.staffDatabase);
+        this->projectDatabase = std::move(userDataManager.projectDatabase);
+        this->projectVersions = std::move(userDataManager.projectVersions);
+        this->reportCache = std::move(userDataManager.reportCache);
+        this->frozenDatabase = std::move(userDataManager.frozenDatabase);
     }
 
 	// default destructor
@@ -457,10 +827,16 @@ public:
         this->fullDatabase.clear();
         this->staffDatabase.clear();
         this->projectDatabase.clear();
+        this->projectVersions.clear();
+        this->reportCache.clear();
+        this->frozenDatabase.clear();
         // declare new object
         this->fullDatabase = userDataManager.fullDatabase;
         this->staffDatabase = userDataManager.staffDatabase;
         this->projectDatabase = userDataManager.projectDatabase;
+        this->projectVersions = userDataManager.projectVersions;
+        this->reportCache = userDataManager.reportCache;
+        this->frozenDatabase = userDataManager.frozenDatabase;
         return *this;
     }
 
@@ -470,69 +846,404 @@ public:
         std::swap(this->fullDatabase, userDatabase.dfullDatabase);  
         std::swap(this->staffDatabase, userDatabase.staffDatabase); 
         std::swap(this->projectDatabase, userDatabase.projectDatabase); 
+        std::swap(this->projectVersions, userDatabase.projectVersions); 
+        std::swap(this->reportCache, userDatabase.reportCache); 
+        std::swap(this->frozenDatabase, userDatabase.frozenDatabase); 
         return *this;
     }
 
     // printing functions
     std::string fullDatabaseShow() { 
-        return this->fullDatabase.show(); 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", TimeRange{}}); 
     }
     std::string fullDatabaseShow(const std::string& staffName, 
                                  const std::string& projectName) { 
-        return this->fullDatabase.show(staffName, projectName); 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName, TimeRange{}}); 
     }
     std::string staffDatabaseShow() { 
+        if (frozenDatabase.isFrozen()) return this->frozenDatabase.showNames(QueryScope::STAFF);
         return this->staffDatabase.show(); 
     }
     std::string staffDatabaseShow(const std::string& staffName) { 
-        return this->staffDatabase.show(staffName); 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "", TimeRange{}}); 
     }
     std::string projectDatabaseShow() { 
+        if (frozenDatabase.isFrozen()) return this->frozenDatabase.showNames(QueryScope::PROJECT);
         return this->projectDatabase.show(); 
     }
     std::string projectDatabaseShow(const std::string& projectName) { 
-        return this->projectDatabase.show(projectName); 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName, TimeRange{}}); 
+    }
+
+    // printing functions restricted to timestamps in [startTime, endTime]
+    std::string fullDatabaseRangeShow(const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", 
+                                       TimeRange{startTime, endTime}}); 
     }
+    std::string fullDatabaseRangeShow(const std::string& staffName, const std::string& projectName,
+                                      const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName, 
+                                       TimeRange{startTime, endTime}}); 
+    }
+    std::string staffDatabaseRangeShow(const std::string& staffName, 
+                                       const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "", 
+                                       TimeRange{startTime, endTime}}); 
+    }
+    std::string projectDatabaseRangeShow(const std::string& projectName, 
+                                         const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName, 
+                                       TimeRange{startTime, endTime}}); 
+    }
+
+    // report functions
     std::string getReport() { 
-        return this->fullDatabase.getReport(); 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", TimeRange{}}); 
     }
     std::string getReport(const std::string& staffName, 
                           const std::string& projectName) { 
-        return this->fullDatabase.getReport(staffName, projectName); 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName, TimeRange{}}); 
     }
     std::string getStaffReport(const std::string& staffName) { 
-        return this->staffDatabase.getReport(staffName); 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "", TimeRange{}}); 
     }
     std::string getProjectReport(const std::string& projectName) { 
-        return this->projectDatabase.getReport(projectName); 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName, TimeRange{}}); 
+    }
+
+    // report functions restricted to timestamps in [startTime, endTime]
+    std::string getRangeReport(const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", 
+                                       TimeRange{startTime, endTime}}); 
+    }
+    std::string getRangeReport(const std::string& staffName, const std::string& projectName,
+                               const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName, 
+                                       TimeRange{startTime, endTime}}); 
+    }
+    std::string getStaffRangeReport(const std::string& staffName, 
+                                    const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "", 
+                                       TimeRange{startTime, endTime}}); 
+    }
+    std::string getProjectRangeReport(const std::string& projectName, 
+                                      const unsigned& startTime, const unsigned& endTime) { 
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName, 
+                                       TimeRange{startTime, endTime}}); 
+    }
+
+    // return project matching key, empty pointer if it does not exist
+    ProjectSharedPtr<T> getProject(const std::string& staffName, const std::string& projectName) const {
+        return this->fullDatabase.getProject(staffName, projectName);
+    }
+
+    // return reports of existing projects in the order of keys, through the
+    // report cache; reports restricted to a range without measurements are empty
+    std::vector<std::string> getProjectReports(const std::vector<ProjectDbKeyType>& keys,
+                                               const TimeRange& range = TimeRange{}) {
+        std::vector<ProjectSharedPtr<T>> projects;
+        projects.reserve(keys.size());
+        for (auto it = keys.begin(); it != keys.end(); ++it) {
+            ProjectSharedPtr<T> project{this->fullDatabase.getProject(it->first, it->second)};
+            if (project) projects.push_back(project);
+        }
+        return this->computeReports(projects, this->getDependencies(projects), range);
+    }
+
+    // return arena of the dataset, new experiments should allocate from it
+    const std::shared_ptr<Arena>& getArena() const {
+        return this->arena;
+    }
+
+    // return all projects, in key order
+    std::vector<ProjectSharedPtr<T>> getProjects() const {
+        return this->fullDatabase.getProjects();
+    }
+
+    // return report cache statistics
+    const ReportCache& getReportCache() const { 
+        return this->reportCache; 
+    }
+    // forget cached results, so the next queries are computed again
+    void clearReportCache() {
+        this->reportCache.clear();
+    }
+    std::string reportCacheShow() const { 
+        return this->reportCache.show(); 
+    }
+
+    // return block storage statistics: raw and stored size of all
+    // measurements and how fast the stored blocks decode
+    std::string storageShow() const {
+        std::vector<ProjectSharedPtr<T>> projects{this->fullDatabase.getProjects()};
+        StorageStats stats{0, 0, 0, 0, 0, 0};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            stats += (*it).get()->getSeries().getStorageStats();
+        }
+        // decode all encoded blocks repeatedly for at least 0.2 seconds
+        std::size_t decoded{};
+        double seconds{};
+        auto start = std::chrono::steady_clock::now();
+        do {
+            for (auto it = projects.begin(); it != projects.end(); ++it) {
+                decoded += (*it).get()->getSeries().decodeBlocks();
+            }
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (seconds < 0.2 && stats.noOfEncodedBlocks > 0);
+        // std::list node holds two pointers next to the measurement
+        std::size_t listBytes{stats.noOfMeasurements * (sizeof(Measurement<T>) + 2 * sizeof(void*))};
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Block storage"                 << std::endl
+            << "-----------------------------" << std::endl
+            << "Compression: "    << (BlockStorage::compressBlocks ? "on" : "off") << std::endl
+            << "Measurements: "   << stats.noOfMeasurements << std::endl
+            << "Blocks: "         << stats.noOfBlocks
+            << " (" << stats.noOfEncodedBlocks << " encoded)" << std::endl
+            << "Raw size: "       << stats.rawBytes  << " bytes" << std::endl
+            << "List size: "      << listBytes       << " bytes" << std::endl
+            << "Column size: "    << stats.columnBytes << " bytes" << std::endl
+            << "Block headers: "  << stats.blockBytes  << " bytes" << std::endl
+            << "Compression ratio: " << std::setprecision(3)
+            << (stats.columnBytes > 0 ? static_cast<double>(stats.rawBytes) / stats.columnBytes : 0) << std::endl;
+        if (stats.noOfEncodedBlocks > 0) {
+            stringStream << "Decode throughput: " << std::setprecision(3)
+                << decoded / seconds / 1e6 << " million measurements/s" << std::endl;
+        }
+        stringStream << arena->show()
+                     << "-----------------------------" << std::endl;
+        return stringStream.str();
+    }
+
+    // return heap memory held by the dataset in bytes: projects, report
+    // cache and frozen layout
+    std::size_t getMemoryUsage() {
+        this->recountProjectBytes();
+        return this->projectBytes + this->reportCache.getMemoryUsage() + this->frozenDatabase.getMemoryUsage();
+    }
+
+    // return memory footprint of every project, largest first, with the
+    // totals of the dataset
+    std::string memoryShow() {
+        std::vector<ProjectSharedPtr<T>> projects{this->fullDatabase.getProjects()};
+        std::vector<std::pair<MemoryFootprint, ProjectSharedPtr<T>>> footprints;
+        MemoryFootprint total{0, 0, 0};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            footprints.push_back(std::make_pair(this->getFootprint(**it), *it));
+            total += footprints.back().first;
+        }
+        std::stable_sort(footprints.begin(), footprints.end(),
+                         [](const std::pair<MemoryFootprint, ProjectSharedPtr<T>>& a,
+                            const std::pair<MemoryFootprint, ProjectSharedPtr<T>>& b) {
+                             return a.first.getTotal() > b.first.getTotal();
+                         });
+        this->updateProjectBytes(this->projectBytes, total.getTotal());
+        std::size_t cacheBytes{this->reportCache.getMemoryUsage()};
+        std::size_t frozenBytes{this->frozenDatabase.getMemoryUsage()};
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Memory footprint (bytes)"      << std::endl
+            << "-----------------------------" << std::endl
+            << "Staff\tProject\tMeasurements\tIndex*\tNames*\tTotal*" << std::endl;
+        for (auto it = footprints.begin(); it != footprints.end(); ++it) {
+            stringStream << it->second.get()->getStaffName() << "\t" << it->second.get()->getProjectName() << "\t"
+                         << it->first.storageBytes << "\t" << it->first.indexBytes << "\t"
+                         << it->first.nameBytes << "\t" << it->first.getTotal() << std::endl;
+        }
+        stringStream
+            << "-----------------------------" << std::endl
+            << "* estimated: map entries and names are sized by the usual std::map node layout" << std::endl
+            << "-----------------------------" << std::endl
+            << "Projects: "          << projects.size() << std::endl
+            << "Measurements: "      << total.storageBytes << " bytes" << std::endl
+            << "Index structures*: " << total.indexBytes << " bytes" << std::endl
+            << "Names*: "            << total.nameBytes << " bytes" << std::endl
+            << "Report cache: "      << cacheBytes << " bytes" << std::endl
+            << "Frozen layout: "     << frozenBytes << " bytes" << std::endl
+            << "Total*: "            << total.getTotal() + cacheBytes + frozenBytes << " bytes" << std::endl
+            << "Projects high-water mark*: " << this->peakProjectBytes << " bytes" << std::endl
+            << "Arena in use: "      << arena->getBytesInUse() << " of "
+                                     << arena->getBytesReserved() << " bytes reserved" << std::endl
+            << "-----------------------------" << std::endl;
+        return stringStream.str();
+    }
+
+    // set gauges of the dataset: measurements of every project and memory
+    // held by the dataset, now and at its peak
+    void publishMetrics(const std::string& dataset) {
+        std::string datasetLabel{Metrics::getLabel("dataset", dataset)};
+        // deleted projects go
+        Metrics::removeGauges("datahero_project_points", datasetLabel + ",");
+        std::vector<ProjectSharedPtr<T>> projects{this->fullDatabase.getProjects()};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            Metrics::setGauge("datahero_project_points", "Measurements of a project.",
+                              datasetLabel + "," + Metrics::getLabel("staff", (*it).get()->getStaffName()) + ","
+                              + Metrics::getLabel("project", (*it).get()->getProjectName()),
+                              static_cast<double>((*it).get()->getNoOfMeasurements()));
+        }
+        Metrics::setGauge("datahero_dataset_memory_bytes",
+                          "Memory held by the projects, report cache and frozen layout of a dataset.",
+                          datasetLabel, static_cast<double>(this->getMemoryUsage()));
+        Metrics::setGauge("datahero_dataset_project_memory_peak_bytes",
+                          "Largest memory held by the projects of a dataset so far.",
+                          datasetLabel, static_cast<double>(this->peakProjectBytes));
+    }
+
+    // convert loaded data into the read-optimised layout, used by all show
+    // and report functions until the data changes
+    void freeze() {
+        this->compact();
+        this->buildFrozen(this->frozenDatabase);
+    }
+
+    // rewrite every project into one compact series with prebuilt indices
+    void compact() {
+        std::vector<ProjectSharedPtr<T>> projects{this->fullDatabase.getProjects()};
+        for (auto it = projects.begin(); it != projects.end(); ++it) {
+            (*it).get()->compactMeasurements();
+        }
+        this->recountProjectBytes();
+    }
+
+    // go back to the mutable maps
+    void thaw() {
+        this->frozenDatabase.clear();
+    }
+
+    // return frozen layout statistics
+    bool isFrozen() const { 
+        return this->frozenDatabase.isFrozen(); 
+    }
+    std::string frozenShow() const { 
+        return this->frozenDatabase.show(); 
+    }
+
+    // copy projects before changing them if they are shared with
+    // snapshots, which may be read by other threads meanwhile
+    void setCopyOnWrite(const bool& copyOnWrite) {
+        this->fullDatabase.setCopyOnWrite(copyOnWrite);
+    }
+
+    // return project compacted for sharing with read-only snapshots, empty
+    // pointer if it does not exist; a project already shared with earlier
+    // snapshots is compact and is not touched
+    ProjectSharedPtr<T> shareProject(const std::string& staff, const std::string& project) {
+        std::size_t before{this->getFootprintTotal(staff, project)};
+        this->fullDatabase.compactUnshared(staff, project);
+        this->updateProjectBytes(before, this->getFootprintTotal(staff, project));
+        return this->fullDatabase.getProject(staff, project);
+    }
+
+    // return (key, value) pairs of the staff or project reference database
+    // in database order
+    std::vector<std::pair<std::string, std::string>> getReferenceEntries(const QueryScope& scope) const {
+        ProjectReferenceDbType pairs{scope == QueryScope::STAFF ? this->staffDatabase.getDatabase()
+                                                                : this->projectDatabase.getDatabase()};
+        return std::vector<std::pair<std::string, std::string>>(pairs.begin(), pairs.end());
     }
 
     // delete project from the map
     bool deleteEntry(const std::string& staff, const std::string& project) { 
-        return this->fullDatabase.deleteEntry(staff, project); 
+        InstrumentScope instrumentScope("DataManager::deleteEntry");
+        std::size_t before{this->getFootprintTotal(staff, project)};
+        bool success = this->fullDatabase.deleteEntry(staff, project); 
+        if (success) {
+            this->updateProjectBytes(before, 0);
+            this->frozenDatabase.erase(staff, project);
+            this->bumpVersion(staff, project);
+            this->reportCache.dropProject(std::make_pair(staff, project));
+        }
+        return success;
+    }
+
+    // remove project from the map without a message and return it, empty
+    // pointer if it does not exist; references to it expire
+    ProjectSharedPtr<T> takeProject(const std::string& staff, const std::string& project) {
+        ProjectSharedPtr<T> taken{this->fullDatabase.takeEntry(staff, project)};
+        if (taken) {
+            this->updateProjectBytes(this->getFootprint(*taken).getTotal(), 0);
+            this->frozenDatabase.erase(staff, project);
+            this->bumpVersion(staff, project);
+            this->reportCache.dropProject(std::make_pair(staff, project));
+        }
+        return taken;
     }
 
     // delete measurements from the map
     bool deleteMeasurementRange(const std::string& staff, const std::string& project, 
                                 const unsigned& startRange, const unsigned& endRange) {
-        return this->fullDatabase.deleteMeasurementRange(staff, project, startRange, endRange);
+        InstrumentScope instrumentScope("DataManager::deleteMeasurementRange");
+        std::size_t before{this->getFootprintTotal(staff, project)};
+        bool success = this->fullDatabase.deleteMeasurementRange(staff, project, startRange, endRange);
+        if (success) {
+            this->updateProjectBytes(before, this->getFootprintTotal(staff, project));
+            // the project may have been replaced by a copy
+            ProjectWeakPtr<T> weakProject = this->fullDatabase.getProject(staff, project);
+            this->staffDatabase.addEntry(staff, project, weakProject);
+            this->projectDatabase.addEntry(project, staff, weakProject);
+            this->frozenDatabase.thaw(staff, project);
+            this->bumpVersion(staff, project);
+        }
+        return success;
     }
 
-    // insert experiment
+    // insert copy of experiment
 	void insertExperiment(const Experiment<T>& userExperiment) {
-        // make shared pointers to experiments
-        auto experimentPointer = std::make_shared<Experiment<T>>(userExperiment);
+        this->insertExperiment(Experiment<T>(userExperiment));
+    }
+
+    // insert batch of experiments, same as inserting them one by one;
+    // experiments of one project are merged with each other first, so each
+    // project and its references are updated once per batch
+    void insertExperiments(std::vector<Experiment<T>>&& userExperiments) {
+        InstrumentScope instrumentScope("DataManager::insertExperiments");
+        TraceSpan traceSpan("DataManager::insertExperiments", "insert");
+        std::map<ProjectDbKeyType, std::size_t> firstOfProject;
+        // first experiment of every project, in batch order
+        std::vector<std::size_t> firsts;
+        for (std::size_t i{}; i < userExperiments.size(); ++i) {
+            auto key = std::make_pair(userExperiments[i].getStaffName(), userExperiments[i].getProjectName());
+            auto first = firstOfProject.find(key);
+            if (first == firstOfProject.end()) {
+                firstOfProject.insert(std::make_pair(key, i));
+                firsts.push_back(i);
+            } else {
+                userExperiments[first->second].mergeMeasurements(userExperiments[i]);
+            }
+        }
+        for (auto it = firsts.begin(); it != firsts.end(); ++it) {
+            this->insertExperiment(std::move(userExperiments[*it]));
+        }
+    }
+
+    // insert experiment, a new project takes over its measurements
+	void insertExperiment(Experiment<T>&& userExperiment) {
+        InstrumentScope instrumentScope("DataManager::insertExperiment");
+        TraceSpan traceSpan("DataManager::insertExperiment", "insert");
         // extract staff name
         std::string staffName = userExperiment.getStaffName();
         // extract project name
         std::string projectName = userExperiment.getProjectName();
+        std::size_t before{this->getFootprintTotal(staffName, projectName)};
         // add entry to full database, get weak pointer to updated project
-		auto updatedProject = fullDatabase.addEntry(staffName, projectName, experimentPointer);
+		auto updatedProject = fullDatabase.addEntry(staffName, projectName, std::move(userExperiment));
+        this->updateProjectBytes(before, this->getFootprint(*updatedProject).getTotal());
         // create weak pointer to project
         ProjectWeakPtr<T> weakProject = updatedProject;
         // add updated entry to staff database and project database
         staffDatabase.addEntry(staffName, projectName, weakProject);
 		projectDatabase.addEntry(projectName, staffName, weakProject);
+        // a merged project is thawed in place, a new one has no place in the
+        // frozen layout, so everything is thawed
+        if (this->frozenDatabase.contains(staffName, projectName)) {
+            this->frozenDatabase.thaw(staffName, projectName);
+        } else if (this->frozenDatabase.isFrozen()) {
+            this->frozenDatabase.clear();
+        }
+        // cached results using this project are now stale
+        this->bumpVersion(staffName, projectName);
 	}
 };
 
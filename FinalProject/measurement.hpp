@@ -3,7 +3,8 @@
 
 #include <iostream>  // std
 #include <complex>   // complex numbers
-#include "msg.hpp"   // classes managing message outputs
+#include "msg.hpp"        // classes managing message outputs
+#include "instrument.hpp" // allocation and copy accounting
 
 /* ------------------------------------------------------------------------
 * ABSTRACT MEASUREMENT BASE CLASS TEMPLATE
@@ -28,6 +29,7 @@ public:
     // copy constructor for deep copying
     BaseMeasurement(const BaseMeasurement& userMeasurement) {
         DebugMsg::print("[BASE-MEASUREMENT] Copy constructor for deep copying called\n");
+        Instrument::countCopy(InstrumentedType::MEASUREMENT);
         this->timestamp = userMeasurement.timestamp;
         this->dataPoint = userMeasurement.dataPoint;
     }
@@ -35,6 +37,7 @@ public:
     // move constructor
     BaseMeasurement(BaseMeasurement&& userMeasurement) {
         DebugMsg::print("[BASE-MEASUREMENT] Move constructor called\n");
+        Instrument::countMove(InstrumentedType::MEASUREMENT);
         // steal the data
         this->timestamp = userMeasurement.timestamp;
         this->dataPoint = userMeasurement.dataPoint;
@@ -58,6 +61,7 @@ public:
     // copy assignment operator
     BaseMeasurement& operator=(const BaseMeasurement& userMeasurement) {
         DebugMsg::print("[BASE-MEASUREMENT] Copy assignment operator called\n");
+        Instrument::countCopy(InstrumentedType::MEASUREMENT);
         if (&userMeasurement == this) { return *this; } // no self-assignment
         // first delete this object’s data
         this->timestamp = {};
@@ -71,6 +75,7 @@ public:
     // move assignment operator
     BaseMeasurement& operator=(BaseMeasurement&& userMeasurement) {
         DebugMsg::print("[BASE-MEASUREMENT] Move assignment operator called\n");
+        Instrument::countMove(InstrumentedType::MEASUREMENT);
         std::swap(this->timestamp, userMeasurement.timestamp);
         std::swap(this->dataPoint, userMeasurement.dataPoint);       
         return *this;
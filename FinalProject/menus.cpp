@@ -74,6 +74,16 @@ std::string ScreenReportInfo::description() {
     return "<s-report> - generate analysis report to screen";
 }
 
+std::string RangeDataInfo::description() { 
+    // returns 'show data in time range' command desciption
+    return "<r-data>   - show data within timestamp range";
+}
+
+std::string RangeReportInfo::description() { 
+    // returns 'report of time range' command desciption
+    return "<r-report> - generate analysis report of timestamp range";
+}
+
 std::string DelInfo::description() { 
     // returns 'delete project' command desciption
     return "<del>      - delete project";
@@ -84,6 +94,21 @@ std::string DelValInfo::description() {
     return "<del-val>  - delete particular measurement";
 }
 
+std::string CacheInfo::description() { 
+    // returns 'cache statistics' command desciption
+    return "<cache>    - show report cache statistics";
+}
+
+std::string MemoryInfo::description() { 
+    // returns 'memory footprint' command desciption
+    return "<memory>   - show memory used per project";
+}
+
+std::string FreezeInfo::description() { 
+    // returns 'freeze data' command desciption
+    return "<freeze>   - freeze data for fast repeated queries";
+}
+
 std::string ExitAnalysisInfo::description() { 
     // returns 'exit analysis mode' command desciption
     return "<exit>     - exit analysis mode";
@@ -137,16 +162,12 @@ std::string MainMenu::dataManageCmds() const {
     stringStream << std::endl
         << "------------------------------------------------------------" << std::endl
         << "DATA ANALYSIS MODE: press ENTER after each command!         " << std::endl
-        << "------------------------------------------------------------" << std::endl
-        << "   " << commands[8] ->description()                           << std::endl 
-        << "   " << commands[9] ->description()                           << std::endl 
-        << "   " << commands[10]->description()                           << std::endl
-        << "   " << commands[11]->description()                           << std::endl
-        << "   " << commands[12]->description()                           << std::endl
-        << "   " << commands[13]->description()                           << std::endl
-        << "   " << commands[14]->description()                           << std::endl
-        << "   " << commands[15]->description()                           << std::endl
-        << "   " << commands[16]->description()                           << std::endl
+        << "------------------------------------------------------------" << std::endl;
+    // analysis mode commands follow data input commands, exit is the last one
+    for (size_t i{8}; i < commands.size(); ++i) {
+        stringStream << "   " << commands[i]->description()               << std::endl;
+    }
+    stringStream
         << "------------------------------------------------------------" << std::endl; 
     return stringStream.str(); 
 }
@@ -235,6 +256,11 @@ std::string FileInputHelp::description() {
         << "     -- integer, e.g. 5                                     " << std::endl
         << "     -- complex double, e.g. (1.5, 4.7)                     " << std::endl
         << "                                                            " << std::endl
+        << "   - With data type <auto> the type of every file is        " << std::endl
+        << "     detected from its values, so one folder can mix types; " << std::endl
+        << "     a project with files of several types is kept as the   " << std::endl
+        << "     widest of them (int, then double, then complex double) " << std::endl
+        << "                                                            " << std::endl
         << "   - Real data (e.g. integer) file input format:            " << std::endl
         << "                                                            " << std::endl
         << "     Experimenter: YourName (as single word)                " << std::endl
@@ -349,6 +375,9 @@ std::string FunctionalityHelp::description() {
         << "   - You can exclude particular data sets from analysis     " << std::endl
         << "     by deleting particular values or whole projects        " << std::endl
         << "                                                            " << std::endl
+        << "   - DataHero can also run without prompts, e.g. in scripts:" << std::endl
+        << "     run <datahero --help> to see command line options      " << std::endl
+        << "                                                            " << std::endl
         << "------------------------------------------------------------" << std::endl
         << "Type <help> to see help options or exit help with <exit>    " << std::endl
         << "------------------------------------------------------------" << std::endl;
@@ -122,6 +122,18 @@ public:
     std::string description();
 };
 
+class RangeDataInfo : public Command {
+public:
+    // tell how to show data within time range
+    std::string description();
+};
+
+class RangeReportInfo : public Command {
+public:
+    // tell how to generate report of time range
+    std::string description();
+};
+
 class DelInfo : public Command {
 public:
     // tell how to delete project
@@ -134,6 +146,24 @@ public:
     std::string description();
 };
 
+class CacheInfo : public Command {
+public:
+    // tell how to show report cache statistics
+    std::string description();
+};
+
+class MemoryInfo : public Command {
+public:
+    // tell how to show memory used per project
+    std::string description();
+};
+
+class FreezeInfo : public Command {
+public:
+    // tell how to freeze data for repeated queries
+    std::string description();
+};
+
 class ExitAnalysisInfo : public Command {
 public:
     // tell how to exit analysis mode
@@ -0,0 +1,380 @@
+#include <sstream>   // stringstream
+#include <iomanip>   // setprecision
+#include <cmath>     // log2, pow
+#include <cstdio>    // rename, remove
+#include <stdexcept> // runtime_error
+#ifdef _WIN32
+#include <winsock2.h> // sockets, link with ws2_32
+#else
+#include <sys/socket.h> // sockets
+#include <sys/select.h> // select
+#include <netinet/in.h> // sockaddr_in
+#include <arpa/inet.h>  // htonl, htons
+#include <unistd.h>     // close
+#endif
+
+#include "metrics.hpp" // operational metrics
+#include "msg.hpp"     // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* DEFINE METRIC COUNTER CLASS
+* -----------------------------------------------------------------------*/
+
+const std::size_t MetricCounter::noOfStripes;
+
+// parametrised constructor
+MetricCounter::MetricCounter(const std::string& userHelp) : stripes(), help{userHelp} {
+    DebugMsg::print("[METRIC-COUNTER] Parametrised constructor called\n");
+}
+
+// threads take stripes in the order they first count something
+std::size_t MetricCounter::getThreadStripe() {
+    static std::atomic<std::size_t> noOfThreads{0};
+    static thread_local std::size_t threadStripe{noOfThreads++ % noOfStripes};
+    return threadStripe;
+}
+
+std::uint64_t MetricCounter::getValue() const {
+    std::uint64_t value{};
+    for (std::size_t i{}; i < noOfStripes; ++i) value += stripes[i].value.load(std::memory_order_relaxed);
+    return value;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE METRIC SUMMARY CLASS
+* -----------------------------------------------------------------------*/
+
+const std::size_t MetricSummary::noOfBuckets;
+const std::size_t MetricSummary::noOfStripes;
+
+// parametrised constructor
+MetricSummary::MetricSummary(const std::string& userHelp) : stripes(), help{userHelp} {
+    DebugMsg::print("[METRIC-SUMMARY] Parametrised constructor called\n");
+}
+
+double MetricSummary::getBucketStart(const std::size_t& bucket) {
+    return std::pow(2.0, bucket / 4.0);
+}
+
+void MetricSummary::record(const std::uint64_t& durationNs) {
+    std::size_t bucket{durationNs > 1 ? static_cast<std::size_t>(4 * std::log2(static_cast<double>(durationNs))) : 0};
+    if (bucket >= noOfBuckets) bucket = noOfBuckets - 1;
+    // stripes are taken as those of counters are
+    Stripe& stripe = stripes[MetricCounter::getThreadStripe() % noOfStripes];
+    stripe.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    stripe.totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+}
+
+std::uint64_t MetricSummary::getCount() const {
+    std::uint64_t count{};
+    for (std::size_t i{}; i < noOfStripes; ++i) {
+        for (std::size_t bucket{}; bucket < noOfBuckets; ++bucket) {
+            count += stripes[i].buckets[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+double MetricSummary::getSum() const {
+    std::uint64_t totalNs{};
+    for (std::size_t i{}; i < noOfStripes; ++i) totalNs += stripes[i].totalNs.load(std::memory_order_relaxed);
+    return totalNs / 1e9;
+}
+
+double MetricSummary::getQuantile(const double& quantile) const {
+    std::uint64_t counts[noOfBuckets]{};
+    std::uint64_t count{};
+    for (std::size_t bucket{}; bucket < noOfBuckets; ++bucket) {
+        for (std::size_t i{}; i < noOfStripes; ++i) {
+            counts[bucket] += stripes[i].buckets[bucket].load(std::memory_order_relaxed);
+        }
+        count += counts[bucket];
+    }
+    if (count == 0) return 0;
+    // rank of the quantile among all durations, counted from 1
+    double rank{quantile * (count - 1) + 1};
+    std::uint64_t below{};
+    for (std::size_t bucket{}; bucket < noOfBuckets; ++bucket) {
+        if (below + counts[bucket] >= rank) {
+            // durations of a bucket are taken as spread evenly over it on a
+            // logarithmic scale
+            double share{(rank - below - 0.5) / counts[bucket]};
+            if (share < 0) share = 0;
+            return getBucketStart(bucket) * std::pow(2.0, share / 4) / 1e9;
+        }
+        below += counts[bucket];
+    }
+    return getBucketStart(noOfBuckets) / 1e9;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE METRICS CLASS
+* -----------------------------------------------------------------------*/
+
+std::mutex Metrics::registryMutex;
+std::map<std::string, std::unique_ptr<MetricCounter>> Metrics::counters;
+std::map<std::string, std::unique_ptr<MetricSummary>> Metrics::summaries;
+std::map<std::string, Metrics::GaugeFamily> Metrics::gauges;
+
+MetricCounter& Metrics::getCounter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unique_ptr<MetricCounter>& counter = counters[name];
+    if (!counter) counter.reset(new MetricCounter(help));
+    return *counter;
+}
+
+MetricSummary& Metrics::getSummary(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::unique_ptr<MetricSummary>& summary = summaries[name];
+    if (!summary) summary.reset(new MetricSummary(help));
+    return *summary;
+}
+
+void Metrics::setGauge(const std::string& name, const std::string& help,
+                       const std::string& labels, const double& value) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    GaugeFamily& family = gauges[name];
+    family.help = help;
+    family.values[labels] = value;
+}
+
+void Metrics::removeGauges(const std::string& name, const std::string& labelPrefix) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto family = gauges.find(name);
+    if (family == gauges.end()) return;
+    std::map<std::string, double>& values = family->second.values;
+    // label sets starting with the prefix are next to each other
+    for (auto it = values.lower_bound(labelPrefix);
+         it != values.end() && it->first.compare(0, labelPrefix.size(), labelPrefix) == 0;) {
+        it = values.erase(it);
+    }
+}
+
+std::string Metrics::getLabel(const std::string& name, const std::string& value) {
+    std::string label{name + "=\""};
+    for (auto it = value.begin(); it != value.end(); ++it) {
+        if (*it == '\\') label += "\\\\";
+        else if (*it == '"') label += "\\\"";
+        else if (*it == '\n') label += "\\n";
+        else label += *it;
+    }
+    return label + "\"";
+}
+
+std::string Metrics::toText() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::ostringstream stringStream;
+    stringStream << std::setprecision(9);
+    for (auto it = counters.begin(); it != counters.end(); ++it) {
+        stringStream << "# HELP " << it->first << " " << it->second->help << "\n"
+                     << "# TYPE " << it->first << " counter\n"
+                     << it->first << " " << it->second->getValue() << "\n";
+    }
+    for (auto it = gauges.begin(); it != gauges.end(); ++it) {
+        stringStream << "# HELP " << it->first << " " << it->second.help << "\n"
+                     << "# TYPE " << it->first << " gauge\n";
+        for (auto value = it->second.values.begin(); value != it->second.values.end(); ++value) {
+            stringStream << it->first << "{" << value->first << "} " << value->second << "\n";
+        }
+    }
+    const double quantiles[]{0.5, 0.9, 0.99};
+    for (auto it = summaries.begin(); it != summaries.end(); ++it) {
+        stringStream << "# HELP " << it->first << " " << it->second->help << "\n"
+                     << "# TYPE " << it->first << " summary\n";
+        for (auto quantile = std::begin(quantiles); quantile != std::end(quantiles); ++quantile) {
+            stringStream << it->first << "{quantile=\"" << *quantile << "\"} "
+                         << it->second->getQuantile(*quantile) << "\n";
+        }
+        stringStream << it->first << "_sum " << it->second->getSum() << "\n"
+                     << it->first << "_count " << it->second->getCount() << "\n";
+    }
+    return stringStream.str();
+}
+
+bool Metrics::writeTextFile(const std::string& fileName) {
+    std::string temporaryFile{fileName + ".tmp"};
+    if (!FileMsg::print(toText(), temporaryFile)) return false;
+#ifdef _WIN32
+    // rename does not replace an existing file on Windows
+    std::remove(fileName.c_str());
+#endif
+    if (std::rename(temporaryFile.c_str(), fileName.c_str()) != 0) {
+        ErrorMsg::print("[METRICS] Exception renaming file '" + temporaryFile + "'\n");
+        std::remove(temporaryFile.c_str());
+        return false;
+    }
+    return true;
+}
+
+MetricCounter& Metrics::getFilesIngested() {
+    static MetricCounter& counter = getCounter("datahero_files_ingested_total", "Data files read.");
+    return counter;
+}
+
+MetricCounter& Metrics::getBytesParsed() {
+    static MetricCounter& counter = getCounter("datahero_parsed_bytes_total", "Bytes of data files parsed.");
+    return counter;
+}
+
+MetricCounter& Metrics::getPointsParsed() {
+    static MetricCounter& counter = getCounter("datahero_parsed_points_total", "Measurements parsed from data files.");
+    return counter;
+}
+
+MetricCounter& Metrics::getParseErrors() {
+    static MetricCounter& counter = getCounter("datahero_parse_errors_total",
+                                               "Data files which could not be opened or parsed to their end.");
+    return counter;
+}
+
+MetricCounter& Metrics::getReportCalls() {
+    static MetricCounter& counter = getCounter("datahero_report_calls_total", "Analysis report queries answered.");
+    return counter;
+}
+
+MetricSummary& Metrics::getReportLatency() {
+    static MetricSummary& summary = getSummary("datahero_report_latency_seconds",
+                                               "Time to answer an analysis report query.");
+    return summary;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE METRICS EXPORTER CLASS
+* -----------------------------------------------------------------------*/
+
+#ifdef _WIN32
+typedef SOCKET SocketType;
+static void closeSocket(const SocketType& socket) { closesocket(socket); }
+static const SocketType invalidSocket{INVALID_SOCKET};
+static const int sendFlags{0};
+#else
+typedef int SocketType;
+static void closeSocket(const SocketType& socket) { close(socket); }
+static const SocketType invalidSocket{-1};
+// a closed connection fails send instead of raising SIGPIPE
+static const int sendFlags{MSG_NOSIGNAL};
+#endif
+
+// wait up to 200 ms for socket to become readable, so that the server
+// thread sees a stop in time; return true if it did
+static bool waitReadable(const SocketType& socket) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval timeout{0, 200000};
+    return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+// waits of a connection for its request before it is closed unanswered
+static const unsigned maxRequestWaits{25};
+
+// return socket listening on port of 127.0.0.1, invalidSocket if it cannot be opened
+static SocketType openListener(const unsigned& port) {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return invalidSocket;
+#endif
+    SocketType listener{socket(AF_INET, SOCK_STREAM, 0)};
+    if (listener == invalidSocket) return invalidSocket;
+    int reuse{1};
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 8) != 0) {
+        closeSocket(listener);
+        return invalidSocket;
+    }
+    return listener;
+}
+
+// parametrised constructor
+MetricsExporter::MetricsExporter(const std::string& userFileName, const unsigned& userInterval,
+                                 const unsigned& userPort)
+    : fileName{userFileName}, interval{userInterval}, port{userPort}, stopping{false} {
+    DebugMsg::print("[METRICS-EXPORTER] Parametrised constructor called\n");
+    // metrics of DataHero are exported from the start, also while 0
+    Metrics::getFilesIngested();
+    Metrics::getBytesParsed();
+    Metrics::getPointsParsed();
+    Metrics::getParseErrors();
+    Metrics::getReportCalls();
+    Metrics::getReportLatency();
+    if (port > 0) {
+        SocketType listener{openListener(port)};
+        if (listener == invalidSocket) {
+            throw std::runtime_error("[METRICS] Cannot listen on port " + std::to_string(port) + "\n");
+        }
+        server = std::thread(&MetricsExporter::runServer, this, static_cast<std::intptr_t>(listener));
+    }
+    if (interval > 0 && !fileName.empty()) writer = std::thread(&MetricsExporter::runWriter, this);
+}
+
+// destructor
+MetricsExporter::~MetricsExporter() {
+    DebugMsg::print("[METRICS-EXPORTER] Destructor called\n");
+    this->stop();
+}
+
+void MetricsExporter::runWriter() {
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopped.wait_for(lock, std::chrono::seconds(interval), [this]() { return stopping; })) {
+        lock.unlock();
+        Metrics::writeTextFile(fileName);
+        lock.lock();
+    }
+}
+
+void MetricsExporter::runServer(const std::intptr_t& userListener) {
+    SocketType listener{static_cast<SocketType>(userListener)};
+    while (!this->isStopping()) {
+        // wake up now and then to see if the exporter stops
+        if (!waitReadable(listener)) continue;
+        SocketType connection{accept(listener, nullptr, nullptr)};
+        if (connection == invalidSocket) continue;
+        // a client that sends nothing is closed after a while, and sooner
+        // if the exporter stops
+        bool requested{false};
+        for (unsigned i{}; i < maxRequestWaits && !requested && !this->isStopping(); ++i) {
+            requested = waitReadable(connection);
+        }
+        if (!requested) {
+            closeSocket(connection);
+            continue;
+        }
+        // any request gets the metrics, its contents are not needed
+        char request[4096];
+        recv(connection, request, sizeof(request), 0);
+        std::string body{Metrics::toText()};
+        std::string response{"HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                             + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body};
+        for (std::size_t sent{}; sent < response.size();) {
+            int noOfBytes = send(connection, response.data() + sent, static_cast<int>(response.size() - sent), sendFlags);
+            if (noOfBytes <= 0) break;
+            sent += static_cast<std::size_t>(noOfBytes);
+        }
+        closeSocket(connection);
+    }
+    closeSocket(listener);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool MetricsExporter::isStopping() {
+    std::lock_guard<std::mutex> lock(stopMutex);
+    return stopping;
+}
+
+bool MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        if (stopping) return true;
+        stopping = true;
+    }
+    stopped.notify_all();
+    if (writer.joinable()) writer.join();
+    if (server.joinable()) server.join();
+    return fileName.empty() || Metrics::writeTextFile(fileName);
+}
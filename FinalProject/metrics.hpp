@@ -0,0 +1,185 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <string>  // string
+#include <map>     // map
+#include <memory>  // unique_ptr
+#include <atomic>  // atomic
+#include <mutex>   // mutex
+#include <thread>  // thread
+#include <condition_variable> // condition_variable
+#include <chrono>  // steady_clock
+#include <cstdint> // fixed width integers
+
+/* ------------------------------------------------------------------------
+* OPERATIONAL METRICS
+* -----------------------------------------------------------------------*/
+
+// Counters, gauges and latency summaries of DataHero in the Prometheus
+// text format, e.g.
+//   datahero --type double --input sim_double --report all --metrics datahero.prom
+// writes the file node_exporter's textfile collector reads, and
+// --metrics-port 9464 serves the same on http://127.0.0.1:9464/metrics
+// while batch mode runs.
+
+// Lock-free counter. Every thread adds to one of a few stripes on cache
+// lines of their own, so threads rarely touch the same line; reading sums
+// the stripes.
+class MetricCounter {
+private:
+    static const std::size_t noOfStripes{16};
+    struct Stripe {
+        std::atomic<std::uint64_t> value;
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+    Stripe stripes[noOfStripes];
+
+public:
+    const std::string help;
+
+    explicit MetricCounter(const std::string& userHelp);
+    MetricCounter(const MetricCounter&) = delete;
+    MetricCounter& operator=(const MetricCounter&) = delete;
+
+    // return stripe of the calling thread
+    static std::size_t getThreadStripe();
+    void add(const std::uint64_t& amount = 1) {
+        stripes[getThreadStripe()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    std::uint64_t getValue() const;
+};
+
+// Lock-free summary of durations: counts in buckets a quarter power of two
+// wide, so quantiles are read back within about 10%, over all recorded
+// durations rather than a sliding window. Like MetricCounter, every thread
+// adds to a stripe of its own.
+class MetricSummary {
+public:
+    // durations from 1 ns to about 18 minutes, longer ones go to the last
+    static const std::size_t noOfBuckets{160};
+
+private:
+    static const std::size_t noOfStripes{8};
+    struct Stripe {
+        std::atomic<std::uint64_t> buckets[noOfBuckets];
+        std::atomic<std::uint64_t> totalNs;
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+    Stripe stripes[noOfStripes];
+
+    // return lowest duration of bucket in nanoseconds
+    static double getBucketStart(const std::size_t& bucket);
+
+public:
+    const std::string help;
+
+    explicit MetricSummary(const std::string& userHelp);
+    MetricSummary(const MetricSummary&) = delete;
+    MetricSummary& operator=(const MetricSummary&) = delete;
+
+    void record(const std::uint64_t& durationNs);
+    std::uint64_t getCount() const;
+    // return sum of all durations in seconds
+    double getSum() const;
+    // return quantile in [0, 1] of all durations in seconds, 0 if none
+    double getQuantile(const double& quantile) const;
+};
+
+// records the lifetime of the scope into summary, nothing if it is null
+class MetricTimer {
+private:
+    MetricSummary* summary;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit MetricTimer(MetricSummary* userSummary)
+        : summary{userSummary}, start{std::chrono::steady_clock::now()} {}
+    ~MetricTimer() {
+        if (summary) {
+            summary->record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count()));
+        }
+    }
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+};
+
+// Registry of all metrics. Counters and summaries are created on first use
+// and live until DataHero exits; callers keep the returned reference, so
+// that the hot path does not look them up again. Gauges describe the data
+// rather than events, so their owner sets them from time to time, e.g.
+// DataManager::publishMetrics after every batch operation.
+class Metrics {
+private:
+    struct GaugeFamily {
+        std::string help;
+        // value by label set, e.g. dataset="double",staff="A"
+        std::map<std::string, double> values;
+    };
+    static std::mutex registryMutex;
+    static std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+    static std::map<std::string, std::unique_ptr<MetricSummary>> summaries;
+    static std::map<std::string, GaugeFamily> gauges;
+
+public:
+    // return counter or summary of name, registered with help text if it
+    // does not exist yet
+    static MetricCounter& getCounter(const std::string& name, const std::string& help);
+    static MetricSummary& getSummary(const std::string& name, const std::string& help);
+    // set gauge of name and label set, as made by getLabel
+    static void setGauge(const std::string& name, const std::string& help,
+                         const std::string& labels, const double& value);
+    // remove gauges of name whose label set starts with labelPrefix
+    static void removeGauges(const std::string& name, const std::string& labelPrefix);
+    // return label pair with the value escaped, e.g. staff="A"
+    static std::string getLabel(const std::string& name, const std::string& value);
+    // return all metrics in the Prometheus text format
+    static std::string toText();
+    // write all metrics to file through a temporary file, so that readers
+    // never see it half written; return false if it could not be written
+    static bool writeTextFile(const std::string& fileName);
+
+    // metrics counted by DataHero
+    static MetricCounter& getFilesIngested();
+    static MetricCounter& getBytesParsed();
+    static MetricCounter& getPointsParsed();
+    static MetricCounter& getParseErrors();
+    static MetricCounter& getReportCalls();
+    static MetricSummary& getReportLatency();
+};
+
+// Exports the metrics while it exists: writes the text file every interval
+// seconds (never if 0) and answers HTTP requests on a port of 127.0.0.1
+// (none if 0), each on a thread of its own. The file is written once more
+// when the exporter is destroyed.
+class MetricsExporter {
+private:
+    std::string fileName;
+    unsigned interval;
+    unsigned port;
+    bool stopping;
+    std::mutex stopMutex;
+    std::condition_variable stopped;
+    std::thread writer;
+    std::thread server;
+
+    // write file every interval seconds until stopped
+    void runWriter();
+    // answer requests on listening socket until stopped
+    void runServer(const std::intptr_t& listener);
+    // return true once stop has been called
+    bool isStopping();
+
+public:
+    // parametrised constructor - throws runtime_error if port cannot be opened
+    MetricsExporter(const std::string& userFileName, const unsigned& userInterval, const unsigned& userPort);
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    ~MetricsExporter();
+
+    // stop exporting and write the file a last time, return false if it
+    // could not be written; does nothing when called again
+    bool stop();
+};
+
+#endif /* METRICS_HPP */
@@ -0,0 +1,456 @@
+#include <sstream> // stringstream
+#include <list>    // list
+#include <utility> // pair, move
+
+#include "mixedDataManager.hpp" // dataset of int, double and complex series
+
+/* ------------------------------------------------------------------------
+* HELPER FUNCTIONS CONVERTING SERIES TYPES
+* -----------------------------------------------------------------------*/
+
+// return data type name of series type
+std::string getSeriesTypeName(const SeriesType& type) {
+    switch (type) {
+    case SeriesType::INT: return "int";
+    case SeriesType::DOUBLE: return "double";
+    default: return "complexdouble";
+    }
+}
+
+// complex numbers hold values of every type without loss
+template <typename T> static std::complex<double> toComplex(const T& value) {
+    return std::complex<double>(value);
+}
+static void fromComplex(const std::complex<double>& value, int& target) {
+    target = static_cast<int>(value.real());
+}
+static void fromComplex(const std::complex<double>& value, double& target) {
+    target = value.real();
+}
+static void fromComplex(const std::complex<double>& value, std::complex<double>& target) {
+    target = value;
+}
+
+// insert measurements of a project as type To, only called to widen them
+template <typename From, typename To>
+static void insertConverted(const ProjectDbKeyType& key, const std::list<Measurement<From>>& measurements,
+                            DataManager<To>& data) {
+    std::list<Measurement<To>> converted;
+    To dataPoint;
+    for (auto it = measurements.begin(); it != measurements.end(); ++it) {
+        fromComplex(toComplex(it->getDataPoint()), dataPoint);
+        converted.push_back(Measurement<To>(it->getTimestamp(), dataPoint));
+    }
+    data.insertExperiment(Experiment<To>(HeaderLine(key.first), HeaderLine(key.second), converted));
+}
+
+/* ------------------------------------------------------------------------
+* FUNCTIONS CALLED WITH THE MANAGER OF A SERIES TYPE
+* -----------------------------------------------------------------------*/
+
+// move project out of the visited manager into a manager of wider type
+template <typename To> struct WidenProject {
+    DataManager<To>& data;
+    const ProjectDbKeyType& key;
+    template <typename From> void operator()(DataManager<From>& from) {
+        ProjectSharedPtr<From> project{from.takeProject(key.first, key.second)};
+        insertConverted(key, project.get()->getMeasurements(), data);
+    }
+};
+
+// insert experiment into the visited manager of wider type
+template <typename From> struct WidenExperiment {
+    const Experiment<From>& experiment;
+    const ProjectDbKeyType& key;
+    template <typename To> void operator()(DataManager<To>& data) {
+        insertConverted(key, experiment.getMeasurements(), data);
+    }
+};
+
+// data table of a project; keys name the first column of the table header
+struct ShowProject {
+    const ProjectDbKeyType& key;
+    const std::string& keys;
+    const std::string& values;
+    const TimeRange& range;
+    std::string output;
+    template <typename T> void operator()(DataManager<T>& data) {
+        ProjectSharedPtr<T> project{data.getProject(key.first, key.second)};
+        std::list<Measurement<T>> measurements{range.isRange
+            ? project.get()->getMeasurements(range.startTime, range.endTime)
+            : project.get()->getMeasurements()};
+        if (range.isRange && measurements.empty()) return;
+        // staff and project tables are printed the other way round
+        output = keys == "Staff" ? FrozenDb<T>::showProject(keys, key.first, values, key.second, measurements)
+                                 : FrozenDb<T>::showProject(keys, key.second, values, key.first, measurements);
+    }
+};
+
+// reports of the projects of one type among the pairs of a query, computed
+// together by its manager and put in the place of their pair
+struct ReportProjects {
+    const std::vector<ProjectDbKeyType>& keys;
+    const std::vector<const SeriesType*>& types;
+    const SeriesType& type;
+    const TimeRange& range;
+    std::vector<std::string>& outputs;
+    template <typename T> void operator()(DataManager<T>& data) {
+        std::vector<ProjectDbKeyType> typeKeys;
+        std::vector<std::size_t> places;
+        for (std::size_t i{}; i < keys.size(); ++i) {
+            if (types[i] && *types[i] == type) {
+                typeKeys.push_back(keys[i]);
+                places.push_back(i);
+            }
+        }
+        if (typeKeys.empty()) return;
+        std::vector<std::string> reports{data.getProjectReports(typeKeys, range)};
+        for (std::size_t j{}; j < reports.size(); ++j) outputs[places[j]] = std::move(reports[j]);
+    }
+};
+
+// statistics of the visited manager
+struct ShowStatistics {
+    std::string command;
+    std::string output;
+    template <typename T> void operator()(DataManager<T>& data) {
+        if (command == "CACHE") {
+            output = data.reportCacheShow();
+        } else if (command == "STORAGE") {
+            output = data.storageShow();
+        } else if (command == "MEMORY") {
+            output = data.memoryShow();
+        } else if (command == "FREEZE") {
+            data.freeze();
+        } else {
+            output = data.frozenShow();
+        }
+    }
+};
+
+// delete project or measurements of the visited manager
+struct DeleteProject {
+    const std::string& staff;
+    const std::string& project;
+    TimeRange range;
+    bool success;
+    template <typename T> void operator()(DataManager<T>& data) {
+        success = range.isRange ? data.deleteMeasurementRange(staff, project, range.startTime, range.endTime)
+                                : data.deleteEntry(staff, project);
+    }
+};
+
+/* ------------------------------------------------------------------------
+* DEFINE MIXED DATA MANAGER CLASS
+* -----------------------------------------------------------------------*/
+
+// return manager of type T
+template <> DataManager<int>& MixedDataManager::getData<int>() { return intData; }
+template <> DataManager<double>& MixedDataManager::getData<double>() { return doubleData; }
+template <> DataManager<std::complex<double>>& MixedDataManager::getData<std::complex<double>>() {
+    return complexData;
+}
+
+// call function with the manager of type
+template <typename Function> void MixedDataManager::visit(const SeriesType& type, Function& function) {
+    switch (type) {
+    case SeriesType::INT: function(intData); break;
+    case SeriesType::DOUBLE: function(doubleData); break;
+    default: function(complexData);
+    }
+}
+
+// insert experiment of type T, widening it or its project if their types differ
+template <typename T> void MixedDataManager::insertSeries(Experiment<T>&& userExperiment, const SeriesType& type) {
+    ProjectDbKeyType key{userExperiment.getStaffName(), userExperiment.getProjectName()};
+    auto existing = seriesTypes.find(key);
+    if (existing == seriesTypes.end()) {
+        seriesTypes.insert(std::make_pair(key, type));
+        this->getData<T>().insertExperiment(std::move(userExperiment));
+    } else if (existing->second < type) {
+        DebugMsg::print("[MIXED-DATA-MANAGER] Project widened to " + getSeriesTypeName(type) + "\n");
+        WidenProject<T> widen{this->getData<T>(), key};
+        this->visit(existing->second, widen);
+        existing->second = type;
+        this->getData<T>().insertExperiment(std::move(userExperiment));
+    } else if (type < existing->second) {
+        DebugMsg::print("[MIXED-DATA-MANAGER] Experiment widened to " + getSeriesTypeName(existing->second) + "\n");
+        WidenExperiment<T> widen{userExperiment, key};
+        this->visit(existing->second, widen);
+    } else {
+        this->getData<T>().insertExperiment(std::move(userExperiment));
+    }
+    this->addReferences(key.first, key.second);
+}
+
+// add staff and project references of a pair unless they exist
+void MixedDataManager::addReferences(const std::string& staffName, const std::string& projectName) {
+    auto ret = staffReferences.equal_range(staffName);
+    for (auto it = ret.first; it != ret.second; ++it) {
+        if (it->second == projectName) return;
+    }
+    staffReferences.insert(std::make_pair(staffName, projectName));
+    projectReferences.insert(std::make_pair(projectName, staffName));
+}
+
+// return table of all pairs of a reference database, same as ProjectReferenceDb::show
+std::string MixedDataManager::showReferences(const std::multimap<std::string, std::string>& references,
+                                             const std::string& keys, const std::string& values) const {
+    std::ostringstream stringStream;
+    stringStream << std::endl
+         << "-----------------------------" << std::endl
+         << keys << "\t" << values          << std::endl
+         << "-----------------------------" << std::endl;
+    for (auto it = references.begin(); it != references.end(); ++it) {
+        stringStream << it->first << "\t" << it->second << std::endl;
+    }
+    return stringStream.str();
+}
+
+// return query output, same as DataManager::runQuery
+std::string MixedDataManager::runQuery(const QueryKey& query) {
+    MetricTimer reportTimer(query.view == QueryView::REPORT ? &Metrics::getReportLatency() : nullptr);
+    if (query.view == QueryView::REPORT) Metrics::getReportCalls().add();
+    // pairs covered by query in printing order
+    std::vector<ProjectDbKeyType> keys;
+    std::string tableKeys{"Staff"}, tableValues{"Project"};
+    switch (query.scope) {
+    case QueryScope::ALL:
+        for (auto it = seriesTypes.begin(); it != seriesTypes.end(); ++it) keys.push_back(it->first);
+        break;
+    case QueryScope::STAFF: {
+        auto ret = staffReferences.equal_range(query.staffName);
+        if (ret.first == ret.second) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        for (auto it = ret.first; it != ret.second; ++it) keys.push_back(std::make_pair(it->first, it->second));
+        break;
+    }
+    case QueryScope::PROJECT: {
+        auto ret = projectReferences.equal_range(query.projectName);
+        if (ret.first == ret.second) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        for (auto it = ret.first; it != ret.second; ++it) keys.push_back(std::make_pair(it->second, it->first));
+        std::swap(tableKeys, tableValues);
+        break;
+    }
+    default:
+        keys.push_back(std::make_pair(query.staffName, query.projectName));
+        if (seriesTypes.find(keys[0]) == seriesTypes.end()) {
+            ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+            return "";
+        }
+    }
+    // type of every pair, none if its project was deleted
+    std::vector<const SeriesType*> types;
+    std::size_t noOfExisting{};
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+        auto type = seriesTypes.find(*it);
+        types.push_back(type == seriesTypes.end() ? nullptr : &type->second);
+        if (types.back()) ++noOfExisting;
+    }
+    std::vector<std::string> outputs(keys.size());
+    if (query.view == QueryView::DATA) {
+        bool isReference{query.scope == QueryScope::STAFF || query.scope == QueryScope::PROJECT};
+        for (std::size_t i{}; i < keys.size(); ++i) {
+            if (!types[i]) {
+                // only references outlive their project, the table is left empty
+                if (query.range.isRange) continue;
+                const std::string& keyName = tableKeys == "Staff" ? keys[i].first : keys[i].second;
+                const std::string& valueName = tableKeys == "Staff" ? keys[i].second : keys[i].first;
+                outputs[i] = FrozenDb<int>::showProject(tableKeys, keyName, tableValues, valueName,
+                                                        std::list<Measurement<int>>{})
+                           + "[PROJECT-REF-DB] Data has expired!\n";
+                continue;
+            }
+            ShowProject show{keys[i], tableKeys, tableValues, query.range, ""};
+            this->visit(*types[i], show);
+            // tables of reference databases end with an empty line
+            if (isReference && !show.output.empty()) show.output += "\n";
+            outputs[i] = std::move(show.output);
+        }
+    } else {
+        for (SeriesType type : {SeriesType::INT, SeriesType::DOUBLE, SeriesType::COMPLEXDOUBLE}) {
+            ReportProjects report{keys, types, type, query.range, outputs};
+            this->visit(type, report);
+        }
+    }
+    std::ostringstream stringStream;
+    for (auto it = outputs.begin(); it != outputs.end(); ++it) stringStream << *it;
+    std::string output{stringStream.str()};
+    if (output.empty() && query.range.isRange && noOfExisting > 0) {
+        ErrorMsg::print("\n[DATA-MANAGER] No measurements found in specified time range\n");
+    }
+    return output;
+}
+
+// default constructor
+MixedDataManager::MixedDataManager() {
+    DebugMsg::print("[MIXED-DATA-MANAGER] Default constructor called\n");
+}
+
+// destructor
+MixedDataManager::~MixedDataManager() {
+    DebugMsg::print("[MIXED-DATA-MANAGER] Default destructor called\n");
+}
+
+// insert experiment of any supported type
+void MixedDataManager::insertExperiment(Experiment<int>&& userExperiment) {
+    this->insertSeries(std::move(userExperiment), SeriesType::INT);
+}
+void MixedDataManager::insertExperiment(Experiment<double>&& userExperiment) {
+    this->insertSeries(std::move(userExperiment), SeriesType::DOUBLE);
+}
+void MixedDataManager::insertExperiment(Experiment<std::complex<double>>&& userExperiment) {
+    this->insertSeries(std::move(userExperiment), SeriesType::COMPLEXDOUBLE);
+}
+
+// return number of existing projects of type
+std::size_t MixedDataManager::getNoOfProjects(const SeriesType& type) const {
+    std::size_t noOfProjects{};
+    for (auto it = seriesTypes.begin(); it != seriesTypes.end(); ++it) {
+        if (it->second == type) ++noOfProjects;
+    }
+    return noOfProjects;
+}
+
+// printing functions
+std::string MixedDataManager::fullDatabaseShow() {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", TimeRange{}});
+}
+std::string MixedDataManager::fullDatabaseShow(const std::string& staffName, const std::string& projectName) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName, TimeRange{}});
+}
+std::string MixedDataManager::staffDatabaseShow() const {
+    return this->showReferences(staffReferences, "Staff", "Project");
+}
+std::string MixedDataManager::staffDatabaseShow(const std::string& staffName) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "", TimeRange{}});
+}
+std::string MixedDataManager::projectDatabaseShow() const {
+    return this->showReferences(projectReferences, "Project", "Staff");
+}
+std::string MixedDataManager::projectDatabaseShow(const std::string& projectName) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName, TimeRange{}});
+}
+
+// printing functions restricted to timestamps in [startTime, endTime]
+std::string MixedDataManager::fullDatabaseRangeShow(const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::fullDatabaseRangeShow(const std::string& staffName, const std::string& projectName,
+                                                    const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName,
+                                   TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::staffDatabaseRangeShow(const std::string& staffName,
+                                                     const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "",
+                                   TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::projectDatabaseRangeShow(const std::string& projectName,
+                                                       const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName,
+                                   TimeRange{startTime, endTime}});
+}
+
+// report functions
+std::string MixedDataManager::getReport() {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", TimeRange{}});
+}
+std::string MixedDataManager::getReport(const std::string& staffName, const std::string& projectName) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName, TimeRange{}});
+}
+std::string MixedDataManager::getStaffReport(const std::string& staffName) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "", TimeRange{}});
+}
+std::string MixedDataManager::getProjectReport(const std::string& projectName) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName, TimeRange{}});
+}
+
+// report functions restricted to timestamps in [startTime, endTime]
+std::string MixedDataManager::getRangeReport(const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::getRangeReport(const std::string& staffName, const std::string& projectName,
+                                             const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName,
+                                   TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::getStaffRangeReport(const std::string& staffName,
+                                                  const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "",
+                                   TimeRange{startTime, endTime}});
+}
+std::string MixedDataManager::getProjectRangeReport(const std::string& projectName,
+                                                    const unsigned& startTime, const unsigned& endTime) {
+    return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName,
+                                   TimeRange{startTime, endTime}});
+}
+
+// return statistics of the managers holding projects, one section per type
+std::string MixedDataManager::showStatistics(const std::string& command) {
+    std::string output;
+    for (SeriesType type : {SeriesType::INT, SeriesType::DOUBLE, SeriesType::COMPLEXDOUBLE}) {
+        if (this->getNoOfProjects(type) == 0) continue;
+        ShowStatistics show{command, ""};
+        this->visit(type, show);
+        output += "\nSeries of type " + getSeriesTypeName(type) + ":\n" + show.output;
+    }
+    return output;
+}
+
+// statistics of the managers holding projects
+std::string MixedDataManager::reportCacheShow() {
+    return this->showStatistics("CACHE");
+}
+std::string MixedDataManager::storageShow() {
+    return this->showStatistics("STORAGE");
+}
+std::string MixedDataManager::memoryShow() {
+    return this->showStatistics("MEMORY");
+}
+
+// compact the projects of every type
+void MixedDataManager::freeze() {
+    this->showStatistics("FREEZE");
+}
+std::string MixedDataManager::frozenShow() {
+    return this->showStatistics("FROZEN");
+}
+
+// set gauges of the managers, one dataset per type
+void MixedDataManager::publishMetrics() {
+    intData.publishMetrics(getSeriesTypeName(SeriesType::INT));
+    doubleData.publishMetrics(getSeriesTypeName(SeriesType::DOUBLE));
+    complexData.publishMetrics(getSeriesTypeName(SeriesType::COMPLEXDOUBLE));
+}
+
+// delete project of any type
+bool MixedDataManager::deleteEntry(const std::string& staff, const std::string& project) {
+    auto type = seriesTypes.find(std::make_pair(staff, project));
+    if (type == seriesTypes.end()) {
+        ErrorMsg::print("\n[PROJECT-DB] No project found!\n");
+        return false;
+    }
+    DeleteProject remove{staff, project, TimeRange{}, false};
+    this->visit(type->second, remove);
+    if (remove.success) seriesTypes.erase(type);
+    return remove.success;
+}
+
+// delete measurements of a project of any type
+bool MixedDataManager::deleteMeasurementRange(const std::string& staff, const std::string& project,
+                                              const unsigned& startRange, const unsigned& endRange) {
+    auto type = seriesTypes.find(std::make_pair(staff, project));
+    if (type == seriesTypes.end()) {
+        ErrorMsg::print("\n[PROJECT-DB] No project found\n");
+        return false;
+    }
+    DeleteProject remove{staff, project, TimeRange{startRange, endRange}, false};
+    this->visit(type->second, remove);
+    return remove.success;
+}
@@ -0,0 +1,132 @@
+#ifndef MIXED_DATA_MANAGER_HPP
+#define MIXED_DATA_MANAGER_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <vector>   // vector
+#include <map>      // map, multimap
+#include <complex>  // complex numbers
+
+#include "msg.hpp"         // classes managing outputs
+#include "maps.hpp"        // classes managing databases
+#include "reportCache.hpp" // query keys and time ranges
+
+/* ------------------------------------------------------------------------
+* SERIES TYPES
+* -----------------------------------------------------------------------*/
+
+// type of the values of a series, from the narrowest to the widest; values
+// of a narrower type are kept without loss by a wider one
+enum class SeriesType { INT, DOUBLE, COMPLEXDOUBLE };
+
+// return data type name of series type, e.g. "complexdouble"
+std::string getSeriesTypeName(const SeriesType& type);
+
+/* ------------------------------------------------------------------------
+* MIXED DATA MANAGER CLASS
+* -----------------------------------------------------------------------*/
+
+// Dataset holding int, double and complex series side by side. Every
+// project is tagged with the type of its values and kept by the DataManager
+// of that type, so reports run the kernels of that type and go through its
+// report cache. Staff and project references are kept here, so show and
+// report functions print projects of all types in one order, the same as a
+// DataManager holding them all would. A project given values of a wider
+// type than it has is moved to the manager of that type, e.g. an int
+// project merged with a double file becomes a double project; values of a
+// narrower type are stored as the wider type of the project.
+class MixedDataManager {
+private:
+    DataManager<int> intData;
+    DataManager<double> doubleData;
+    DataManager<std::complex<double>> complexData;
+    // type of every existing project
+    std::map<ProjectDbKeyType, SeriesType> seriesTypes;
+    // staff and project references in the order they were added, kept
+    // after their project is deleted
+    std::multimap<std::string, std::string> staffReferences, projectReferences;
+
+    // return manager of type T
+    template <typename T> DataManager<T>& getData();
+    // call function with the manager of type
+    template <typename Function> void visit(const SeriesType& type, Function& function);
+    // insert experiment of type T, widening it or its project if their types differ
+    template <typename T> void insertSeries(Experiment<T>&& userExperiment, const SeriesType& type);
+    // add staff and project references of a pair unless they exist
+    void addReferences(const std::string& staffName, const std::string& projectName);
+    // return table of all pairs of a reference database
+    std::string showReferences(const std::multimap<std::string, std::string>& references,
+                               const std::string& keys, const std::string& values) const;
+    // return query output, same as DataManager::runQuery
+    std::string runQuery(const QueryKey& query);
+    // return CACHE, STORAGE, MEMORY or FROZEN statistics of the managers holding
+    // projects, one section per type; FREEZE freezes them
+    std::string showStatistics(const std::string& command);
+
+public:
+    // default constructor
+    MixedDataManager();
+    // datasets are not copied
+    MixedDataManager(const MixedDataManager&) = delete;
+    MixedDataManager& operator=(const MixedDataManager&) = delete;
+    // destructor
+    ~MixedDataManager();
+
+    // insert experiment of any supported type
+    void insertExperiment(Experiment<int>&& userExperiment);
+    void insertExperiment(Experiment<double>&& userExperiment);
+    void insertExperiment(Experiment<std::complex<double>>&& userExperiment);
+
+    // return number of existing projects of type
+    std::size_t getNoOfProjects(const SeriesType& type) const;
+
+    // printing functions
+    std::string fullDatabaseShow();
+    std::string fullDatabaseShow(const std::string& staffName, const std::string& projectName);
+    std::string staffDatabaseShow() const;
+    std::string staffDatabaseShow(const std::string& staffName);
+    std::string projectDatabaseShow() const;
+    std::string projectDatabaseShow(const std::string& projectName);
+
+    // printing functions restricted to timestamps in [startTime, endTime]
+    std::string fullDatabaseRangeShow(const unsigned& startTime, const unsigned& endTime);
+    std::string fullDatabaseRangeShow(const std::string& staffName, const std::string& projectName,
+                                      const unsigned& startTime, const unsigned& endTime);
+    std::string staffDatabaseRangeShow(const std::string& staffName,
+                                       const unsigned& startTime, const unsigned& endTime);
+    std::string projectDatabaseRangeShow(const std::string& projectName,
+                                         const unsigned& startTime, const unsigned& endTime);
+
+    // report functions
+    std::string getReport();
+    std::string getReport(const std::string& staffName, const std::string& projectName);
+    std::string getStaffReport(const std::string& staffName);
+    std::string getProjectReport(const std::string& projectName);
+
+    // report functions restricted to timestamps in [startTime, endTime]
+    std::string getRangeReport(const unsigned& startTime, const unsigned& endTime);
+    std::string getRangeReport(const std::string& staffName, const std::string& projectName,
+                               const unsigned& startTime, const unsigned& endTime);
+    std::string getStaffRangeReport(const std::string& staffName,
+                                    const unsigned& startTime, const unsigned& endTime);
+    std::string getProjectRangeReport(const std::string& projectName,
+                                      const unsigned& startTime, const unsigned& endTime);
+
+    // statistics of the managers holding projects, one section per type
+    std::string reportCacheShow();
+    std::string storageShow();
+    std::string memoryShow();
+    // compact the projects of every type; queries still look pairs up
+    // here, so frozenShow only tells how each type was laid out
+    void freeze();
+    std::string frozenShow();
+    // set gauges of the managers, one dataset per type
+    void publishMetrics();
+
+    // delete project or measurements of any type
+    bool deleteEntry(const std::string& staff, const std::string& project);
+    bool deleteMeasurementRange(const std::string& staff, const std::string& project,
+                                const unsigned& startRange, const unsigned& endRange);
+};
+
+#endif /* MIXED_DATA_MANAGER_HPP */
@@ -1,4 +1,6 @@
-#include "msg.hpp" // classes managing outputs
+#include "msg.hpp"        // classes managing outputs
+#include "instrument.hpp" // allocation and copy accounting
+#include "trace.hpp"      // hot path tracing
 
 /* ------------------------------------------------------------------------
 * DERIVED CLASSES FOR OUTPUT MESSAGES: DEBUG MESSAGE CLASS
@@ -18,29 +20,42 @@ void DebugMsg::print(const std::string& message) {
     }
 }
 
+// print debug message to screen, without building a string when debug
+// mode is off
+void DebugMsg::print(const char* message) {
+    if (getIfDebug()) {
+    	std::cout << message;
+    }
+}
+
 /* ------------------------------------------------------------------------
 * DERIVED CLASSES FOR OUTPUT MESSAGES: ERROR MESSAGE CLASS
 * -----------------------------------------------------------------------*/
 
 void ErrorMsg::print(const std::string& message) {
-    // print message
-    std::cout << message;
+    // print message to error stream, so that it does not mix with data output
+    std::cerr << message;
 }
 
 /* ------------------------------------------------------------------------
 * DERIVED CLASSES FOR OUTPUT MESSAGES: SCREEN MESSAGE CLASS
 * -----------------------------------------------------------------------*/
 
+// quiet mode is off by default
+bool ScreenMsg::quietMode{false};
+
 void ScreenMsg::print(const std::string& message) {
     // print message
-	std::cout << message;
+	if (!quietMode) std::cout << message;
 }
 
 /* ------------------------------------------------------------------------
 * DERIVED CLASSES FOR OUTPUT MESSAGES: FILE MESSAGE CLASS
 * -----------------------------------------------------------------------*/
 
-void FileMsg::print(const std::string& message, const std::string& fileName) {
+bool FileMsg::print(const std::string& message, const std::string& fileName) {
+    InstrumentScope instrumentScope("FileMsg::print");
+    TraceSpan traceSpan("FileMsg::print", "write");
     try {
         // check if file can be opened
         std::ofstream outFile(fileName);
@@ -50,7 +65,9 @@ void FileMsg::print(const std::string& message, const std::string& fileName) {
         ScreenMsg::print("[FILE-MSG] File '" + fileName + "' created\n");
         outFile.close();
     } 
-	catch (const std::ios_base::failure) {
+	catch (const std::ios_base::failure&) {
         ErrorMsg::print("[FILE-MSG] Exception opening/writing/closing file '" + fileName + "'\n");
+        return false;
     }
+    return true;
 }
\ No newline at end of file
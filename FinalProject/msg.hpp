@@ -28,6 +28,7 @@ public:
     static bool getIfDebug();
     // print debug message to screen
     static void print(const std::string& userMessage);
+    static void print(const char* userMessage);
 };
 
 /* ------------------------------------------------------------------------
@@ -46,6 +47,8 @@ public:
 
 class ScreenMsg : public Msg { 
 public: 
+    // quiet mode on/off, in quiet mode screen messages are not printed
+    static bool quietMode;
     // print message to screen
     static void print(const std::string& userMessage);
 };
@@ -56,8 +59,8 @@ public:
 
 class FileMsg : public Msg {
 public:
-    // print message to file
-    static void print(const std::string& message, const std::string& fileName);
+    // print message to file, return false if file could not be written
+    static bool print(const std::string& message, const std::string& fileName);
 };
 
 #endif /* MSG_HPP */
@@ -0,0 +1,96 @@
+#include <algorithm> // sort, stable_sort, find
+#include <numeric>   // iota
+#include <stdexcept> // invalid_argument
+
+#include "perfectHash.hpp" // name lookup of a fixed set of keys
+
+/* ------------------------------------------------------------------------
+* DEFINE PERFECT HASH CLASS
+* -----------------------------------------------------------------------*/
+
+const std::size_t PerfectHash::notFound{static_cast<std::size_t>(-1)};
+
+// default constructor
+PerfectHash::PerfectHash() {
+    DebugMsg::print("[PERFECT-HASH] Default constructor called\n");
+}
+
+// FNV-1a over the key, started from the seed and mixed at the end so that
+// every bit of the result depends on every bit of the key
+std::uint64_t PerfectHash::hash(const std::string& key, const std::uint64_t& seed) {
+    std::uint64_t value{14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL)};
+    for (auto it = key.begin(); it != key.end(); ++it) {
+        value ^= static_cast<unsigned char>(*it);
+        value *= 1099511628211ULL;
+    }
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// build table over distinct keys
+void PerfectHash::build(const std::vector<std::string>& userKeys) {
+    // equal keys would collide for every seed
+    std::vector<std::string> sortedKeys{userKeys};
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+    auto duplicate = std::adjacent_find(sortedKeys.begin(), sortedKeys.end());
+    if (duplicate != sortedKeys.end()) {
+        throw std::invalid_argument("[PERFECT-HASH] Duplicate key '" + *duplicate + "'\n");
+    }
+    keys = userKeys;
+    // about two keys per bucket and a fifth of the slots left free
+    std::size_t noOfBuckets{keys.size() / 2 + 1};
+    std::size_t noOfSlots{keys.size() + keys.size() / 4 + 1};
+    seeds.assign(noOfBuckets, 0);
+    slots.assign(noOfSlots, notFound);
+    std::vector<std::vector<std::size_t>> buckets(noOfBuckets);
+    for (std::size_t i{}; i < keys.size(); ++i) {
+        buckets[hash(keys[i], 0) % noOfBuckets].push_back(i);
+    }
+    // place the largest buckets first, while most slots are still free
+    std::vector<std::size_t> order(noOfBuckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](const std::size_t& a, const std::size_t& b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+    std::vector<std::size_t> bucketSlots;
+    for (auto it = order.begin(); it != order.end() && !buckets[*it].empty(); ++it) {
+        const std::vector<std::size_t>& bucket = buckets[*it];
+        // try seeds until all keys of the bucket land in distinct free slots
+        for (std::uint32_t seed{1};; ++seed) {
+            bucketSlots.clear();
+            for (auto key = bucket.begin(); key != bucket.end(); ++key) {
+                std::size_t slot{hash(keys[*key], seed) % noOfSlots};
+                if (slots[slot] != notFound
+                    || std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end()) break;
+                bucketSlots.push_back(slot);
+            }
+            if (bucketSlots.size() == bucket.size()) {
+                seeds[*it] = seed;
+                for (std::size_t k{}; k < bucket.size(); ++k) slots[bucketSlots[k]] = bucket[k];
+                break;
+            }
+        }
+    }
+}
+
+// return index of key, notFound if missing
+std::size_t PerfectHash::find(const std::string& key) const {
+    if (keys.empty()) return notFound;
+    std::uint32_t seed{seeds[hash(key, 0) % seeds.size()]};
+    if (seed == 0) return notFound;
+    std::size_t index{slots[hash(key, seed) % slots.size()]};
+    if (index == notFound || keys[index] != key) return notFound;
+    return index;
+}
+
+// approximate heap memory held by the table in bytes
+std::size_t PerfectHash::getMemoryUsage() const {
+    std::size_t bytes{seeds.capacity() * sizeof(std::uint32_t) + slots.capacity() * sizeof(std::size_t)
+                      + keys.capacity() * sizeof(std::string)};
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+        if (it->capacity() > 15) bytes += it->capacity() + 1;
+    }
+    return bytes;
+}
@@ -0,0 +1,53 @@
+#ifndef PERFECT_HASH_HPP
+#define PERFECT_HASH_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <vector>   // vector
+#include <cstdint>  // fixed width integers
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* PERFECT HASH CLASS: NAME LOOKUP OF A FIXED SET OF KEYS
+* -----------------------------------------------------------------------*/
+
+// Collision-free hash table over a set of keys that does not change after
+// build() (hash and displace). Keys are spread over small buckets by a
+// first hash; every bucket then gets its own seed for a second hash that
+// sends all its keys to free slots. A lookup computes two hashes, reads
+// one slot and compares one string, however many keys there are.
+class PerfectHash {
+private:
+    // keys in the order they were given
+    std::vector<std::string> keys;
+    // second hash seed of every bucket
+    std::vector<std::uint32_t> seeds;
+    // key index held by every slot, notFound if the slot is free
+    std::vector<std::size_t> slots;
+
+    // hash of key, different for every seed
+    static std::uint64_t hash(const std::string& key, const std::uint64_t& seed);
+
+public:
+    // returned by find for keys which are not in the table
+    static const std::size_t notFound;
+
+    // default constructor - empty table
+    PerfectHash();
+
+    // build table over distinct keys
+    void build(const std::vector<std::string>& userKeys);
+
+    // return index of key in the keys given to build, notFound if missing
+    std::size_t find(const std::string& key) const;
+
+    // access functions
+    std::size_t getSize() const { return this->keys.size(); }
+    const std::string& getKey(const std::size_t& index) const { return this->keys[index]; }
+
+    // approximate heap memory held by the table in bytes
+    std::size_t getMemoryUsage() const;
+};
+
+#endif /* PERFECT_HASH_HPP */
@@ -0,0 +1,147 @@
+#ifndef PERSISTENT_MAP_HPP
+#define PERSISTENT_MAP_HPP
+
+#include <iostream>   // std
+#include <memory>     // shared pointer
+#include <functional> // less
+#include <utility>    // move
+
+/* ------------------------------------------------------------------------
+* PERSISTENT MAP CLASS TEMPLATE: SORTED MAP SHARING UNCHANGED ENTRIES
+* -----------------------------------------------------------------------*/
+
+// Sorted map whose copies share every entry they have in common. It is a
+// treap of nodes that are never changed once built: insert and erase
+// build new nodes for the O(log N) entries on the path to the key and
+// link them to the untouched subtrees, so the old tree stays as it was.
+// Copying a map copies its root pointer only. A copy can be read by many
+// threads while another thread changes its own copy, as long as the last
+// copy holding a node is destroyed by one thread at a time. Priorities
+// come from a pseudo-random sequence of every map, which keeps the tree
+// balanced in expectation whatever the order of the keys.
+template <typename Key, typename Value, typename Compare = std::less<Key>> class PersistentMap {
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    struct Node {
+        Key key;
+        Value value;
+        unsigned long long priority;
+        NodePtr left, right;
+
+        Node(const Key& userKey, const Value& userValue, const unsigned long long& userPriority,
+             const NodePtr& userLeft, const NodePtr& userRight)
+            : key(userKey), value(userValue), priority{userPriority}, left(userLeft), right(userRight) {}
+    };
+
+    NodePtr root;
+    std::size_t size;
+    // state of the priority sequence
+    unsigned long long seed;
+
+    // copy of node with other children
+    static NodePtr relink(const Node& node, const NodePtr& left, const NodePtr& right) {
+        return std::make_shared<const Node>(node.key, node.value, node.priority, left, right);
+    }
+
+    // return tree with key set to value, added tells whether key is new
+    NodePtr insert(const NodePtr& node, const Key& key, const Value& value, bool& added) {
+        if (!node) {
+            added = true;
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            return std::make_shared<const Node>(key, value, seed, NodePtr{}, NodePtr{});
+        }
+        Compare less;
+        if (less(key, node->key)) {
+            NodePtr left{this->insert(node->left, key, value, added)};
+            // rotate a new entry of higher priority up
+            if (left->priority > node->priority) {
+                return relink(*left, left->left, relink(*node, left->right, node->right));
+            }
+            return relink(*node, left, node->right);
+        }
+        if (less(node->key, key)) {
+            NodePtr right{this->insert(node->right, key, value, added)};
+            if (right->priority > node->priority) {
+                return relink(*right, relink(*node, node->left, right->left), right->right);
+            }
+            return relink(*node, node->left, right);
+        }
+        return std::make_shared<const Node>(node->key, value, node->priority, node->left, node->right);
+    }
+
+    // return tree of the entries of both trees, all keys of left are smaller
+    static NodePtr join(const NodePtr& left, const NodePtr& right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (left->priority > right->priority) return relink(*left, left->left, join(left->right, right));
+        return relink(*right, join(left, right->left), right->right);
+    }
+
+    // return tree without key, removed tells whether it was found
+    static NodePtr erase(const NodePtr& node, const Key& key, bool& removed) {
+        if (!node) return node;
+        Compare less;
+        if (less(key, node->key)) {
+            NodePtr left{erase(node->left, key, removed)};
+            return removed ? relink(*node, left, node->right) : node;
+        }
+        if (less(node->key, key)) {
+            NodePtr right{erase(node->right, key, removed)};
+            return removed ? relink(*node, node->left, right) : node;
+        }
+        removed = true;
+        return join(node->left, node->right);
+    }
+
+    // call function(key, value) for the entries of a subtree in key order
+    template <typename Function> static void forEach(const Node* node, Function& function) {
+        while (node) {
+            forEach(node->left.get(), function);
+            function(node->key, node->value);
+            node = node->right.get();
+        }
+    }
+
+public:
+    // default constructor - empty map
+    PersistentMap() : size{}, seed{0x9E3779B97F4A7C15ULL} {}
+
+    // access function
+    std::size_t getSize() const { return this->size; }
+
+    // return value of key, nullptr if it is not in the map; valid for as
+    // long as the map or a copy sharing the entry exists
+    const Value* find(const Key& key) const {
+        Compare less;
+        const Node* node{root.get()};
+        while (node) {
+            if (less(key, node->key)) node = node->left.get();
+            else if (less(node->key, key)) node = node->right.get();
+            else return &node->value;
+        }
+        return nullptr;
+    }
+
+    // set value of key, copies share the old value
+    void insert(const Key& key, const Value& value) {
+        bool added{false};
+        root = this->insert(root, key, value, added);
+        if (added) ++size;
+    }
+
+    // remove key, returns false if it is not in the map
+    bool erase(const Key& key) {
+        bool removed{false};
+        root = erase(root, key, removed);
+        if (removed) --size;
+        return removed;
+    }
+
+    // call function(key, value) for every entry in key order
+    template <typename Function> void forEach(Function function) const {
+        forEach(root.get(), function);
+    }
+};
+
+#endif /* PERSISTENT_MAP_HPP */
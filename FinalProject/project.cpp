@@ -17,12 +17,14 @@ HeaderLine::HeaderLine(const std::string& userName) : name(userName) {
 // copy constructor for deep copying
 HeaderLine::HeaderLine(const HeaderLine& userHeaderLine) {
     DebugMsg::print("[HEADER-LINE] Copy constructor called\n");
+    Instrument::countCopy(InstrumentedType::HEADER_LINE);
     this->name = userHeaderLine.name;
 }
 
 // move constructor
 HeaderLine::HeaderLine(HeaderLine&& userHeaderLine) {
     DebugMsg::print("[HEADER-LINE] Move constructor called\n");
+    Instrument::countMove(InstrumentedType::HEADER_LINE);
     // steal the data
     this->name = userHeaderLine.name;
     // delete user object's data
@@ -45,6 +47,7 @@ std::string HeaderLine::getName() const {
 // copy assignment operator
 HeaderLine& HeaderLine::operator=(const HeaderLine& userHeaderLine) {
     DebugMsg::print("[HEADER-LINE] Copy assignment operator called\n");
+    Instrument::countCopy(InstrumentedType::HEADER_LINE);
     if (&userHeaderLine == this) { return *this; } // no self-assignment
     // first delete this object’s data
     this->name = "";
@@ -56,6 +59,7 @@ HeaderLine& HeaderLine::operator=(const HeaderLine& userHeaderLine) {
 // move assignment operator
 HeaderLine& HeaderLine::operator=(HeaderLine &&userHeaderLine) {
     DebugMsg::print("[HEADER-LINE] Move assignment operator called\n");
+    Instrument::countMove(InstrumentedType::HEADER_LINE);
     std::swap(this->name, userHeaderLine.name);
     return *this;
 }
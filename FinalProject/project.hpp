@@ -14,9 +14,14 @@
 #include <iomanip>   // setprecision
 #include <utility>   // move
 
-#include "msg.hpp"         // classes managing output messages
-#include "userInput.hpp"   // basic user input template function
-#include "measurement.hpp" // classes containing measurements
+#include "msg.hpp"          // classes managing output messages
+#include "userInput.hpp"    // basic user input template function
+#include "measurement.hpp"  // classes containing measurements
+#include "timeSeries.hpp"   // measurements in time-ordered blocks
+#include "binaryFormat.hpp" // binary data files
+#include "instrument.hpp"   // allocation and copy accounting
+#include "trace.hpp"        // hot path tracing
+#include "metrics.hpp"      // operational metrics
 
 /* ------------------------------------------------------------------------
 * DECLARE PROJECT HEADER LINE CLASS
@@ -54,7 +59,9 @@ template <typename T> class Experiment {
 protected:
 	HeaderLine staffName;
 	HeaderLine projectName;
-	std::list<Measurement<T>> measurements;
+	// measurements are kept sorted by timestamp, in blocks
+	TimeSeries<T> measurements;
+
 public:
 
 	// default constructor
@@ -62,30 +69,47 @@ public:
 		DebugMsg::print("[EXPERIMENT] Default constructor called\n");
 	}
 
+	// parametrised constructor - empty experiment storing its measurements
+	// in the arena of a dataset
+	Experiment(const std::shared_ptr<Arena>& arena) : measurements{arena} {
+		DebugMsg::print("[EXPERIMENT] Parametrised constructor called\n");
+	}
+
+	// parametrised constructor - experiment of staff member and project
+	// without measurements, e.g. filled by the load generator
+	Experiment(const HeaderLine& userStaffName, const HeaderLine& userProjectName) {
+		DebugMsg::print("[EXPERIMENT] Parametrised constructor called\n");
+		this->staffName = userStaffName;
+		this->projectName = userProjectName;
+	}
+
 	// parametrised constructor
 	Experiment(const HeaderLine& userStaffName, const HeaderLine& userProjectName,
 		const std::list<Measurement<T>>& userMeasurements) {
 		DebugMsg::print("[EXPERIMENT] Parametrised constructor called\n");
 		this->staffName = userStaffName;
 		this->projectName = userProjectName;
-		this->measurements = userMeasurements;
+		for (auto iter = userMeasurements.begin(); iter != userMeasurements.end(); ++iter) {
+			this->measurements.push_back(*iter);
+		}
+		this->sortMeasurements();
 	}
 
-	// copy constructor for deep copying
-	Experiment(const Experiment& userExperiment) {
+	// copy constructor for deep copying, the copy shares the arena
+	Experiment(const Experiment& userExperiment) : measurements{userExperiment.measurements} {
 		DebugMsg::print("[EXPERIMENT] Copy constructor for deep copying called\n");
+		Instrument::countCopy(InstrumentedType::EXPERIMENT);
 		this->staffName = userExperiment.staffName;
 		this->projectName = userExperiment.projectName;
-		this->measurements = userExperiment.measurements;
 	}
 
 	// move constructor
-	Experiment(Experiment&& userExperiment) {
+	Experiment(Experiment&& userExperiment) : measurements{std::move(userExperiment.measurements)} {
 		DebugMsg::print("[EXPERIMENT] Move constructor called\n");
+		Instrument::countMove(InstrumentedType::EXPERIMENT);
 		// steal the data
-		this->stafName = move(userExperiment.staffName);
-		this->projectName = move(userExperiment.projectName);
-		this->measurements = move(userExperiment.measurements);
+		this->staffName = std::move(userExperiment.staffName);
+		this->projectName = std::move(userExperiment.projectName);
 	}
 
 	// default destructor
@@ -96,6 +120,7 @@ public:
 	// copy assignment operator
 	Experiment& operator=(const Experiment& userExperiment) {
 		DebugMsg::print("[EXPERIMENT] Copy assignment operator called\n");
+		Instrument::countCopy(InstrumentedType::EXPERIMENT);
 		if (&userExperiment == this) { return *this; } // no self-assignment
 		// first delete this object’s data
 		this->staffName = {};
@@ -111,44 +136,153 @@ public:
 	// move assignment operator
 	Experiment& operator=(Experiment&& userExperiment) {
 		DebugMsg::print("[EXPERIMENT] Move assignment operator called\n");
+		Instrument::countMove(InstrumentedType::EXPERIMENT);
 		std::swap(this->staffName, userExperiment.staffName);
 		std::swap(this->projectName, userExperiment.projectName);
 		std::swap(this->measurements, userExperiment.measurements);
 		return *this;
 	}
 
+	// append measurement, in any timestamp order until sortMeasurements
+	// is called
+	void addMeasurement(const unsigned& timestamp, const T& value) {
+		this->measurements.push_back(timestamp, value);
+	}
+
+	// sort measurements by timestamp after they were read in or added
+	void sortMeasurements() {
+		// stable, so measurements with equal timestamps keep their order
+		this->measurements.sort();
+	}
+
+	// rewrite measurements into their most compact form for reading
+	void compactMeasurements() {
+		this->measurements.compact();
+	}
+
+	// merge measurements of a later experiment of the same project, for
+	// equal timestamps the ones of this experiment come first
+	void mergeMeasurements(const Experiment& userExperiment) {
+		this->measurements.merge(userExperiment.measurements);
+	}
+
 	// access functions
 	std::string getStaffName() const { return this->staffName.getName(); }
 	std::string getProjectName() const { return this->projectName.getName(); }
-	std::list<Measurement<T>> getMeasurements() const { return this->measurements; }
-	size_t getNoOfMeasurements() const { return this->measurements.size(); }
+	std::list<Measurement<T>> getMeasurements() const { return this->measurements.getMeasurements(); }
+	const TimeSeries<T>& getSeries() const { return this->measurements; }
+	size_t getNoOfMeasurements() const { return this->measurements.getSize(); }
+
+	// return measurements with timestamps in [startTime, endTime]
+	std::list<Measurement<T>> getMeasurements(const unsigned& startTime, const unsigned& endTime) const {
+		return this->measurements.getMeasurements(startTime, endTime);
+	}
+
+	// return measurements with values in [lowValue, highValue], complex
+	// values are compared by magnitude
+	std::list<Measurement<T>> getMeasurementsByValue(const double& lowValue, const double& highValue) const {
+		return this->measurements.getMeasurementsByValue(lowValue, highValue);
+	}
 
-	// reading from file function
-	void readFromFile(const std::string& userFile) {
+	// reading from file function, return false if the file cannot be opened
+	bool readFromFile(const std::string& userFile) {
+		InstrumentScope instrumentScope("Experiment::readFromFile");
+		TraceSpan traceSpan("Experiment::readFromFile", "read");
 		DebugMsg::print("[EXPERIMENT] Reading from file '" + userFile + "'\n");
-		std::ifstream inFile(userFile);
+		// binary mode, so that binary data files are read as they are
+		std::ifstream inFile(userFile, std::ios::binary);
 		try {
 			if (!inFile.is_open()) throw std::ifstream::failure("[EXPERIMENT] Exception opening file '" + userFile + "'\n");
 			else {
-				// declare temporary string for skipping explanatory string in header
-				// and horizontal line
-				std::string temporary;
-				// read from file
-				inFile >> temporary >> staffName;
-				inFile >> temporary >> projectName;
-				inFile >> temporary;
-				// declare new Measurement class object
-				Measurement<T> measurement;
-				// while input is readable, push back to measurements list
-				while (inFile >> measurement) {
-					measurements.push_back(measurement);
-				}
+				this->readFromStream(inFile);
+				Metrics::getFilesIngested().add();
 			}
 		}
 		catch (const std::ifstream::failure& e) {
 			ErrorMsg::print(e.what());
+			Metrics::getParseErrors().add();
+			return false;
 		}
 		inFile.close();
+		return true;
+	}
+
+	// reading function for contents of a text or binary data file, e.g.
+	// already read into memory
+	void readFromStream(std::istream& inStream) {
+		InstrumentScope instrumentScope("Experiment::readFromStream");
+		TraceSpan traceSpan("Experiment::readFromStream", "parse");
+		// binary data files start with a magic number
+		std::istream::pos_type start{inStream.tellg()};
+		std::size_t noOfPoints{this->measurements.getSize()};
+		char magic[4]{};
+		if (inStream.read(magic, 4) && std::string(magic, 4) == BinaryFormat::getMagic()) {
+			bool parsed{this->readFromBinary(inStream)};
+			this->countParse(inStream, start, noOfPoints, parsed);
+			return;
+		}
+		inStream.clear();
+		inStream.seekg(start);
+		// declare temporary string for skipping explanatory string in header
+		// and horizontal line
+		std::string temporary;
+		// read from stream
+		inStream >> temporary >> staffName;
+		inStream >> temporary >> projectName;
+		inStream >> temporary;
+		// declare new Measurement class object
+		Measurement<T> measurement;
+		// while input is readable, push back to measurements list
+		while (inStream >> measurement) {
+			measurements.push_back(measurement);
+		}
+		this->sortMeasurements();
+		// reading stops early at anything that is not a measurement
+		this->countParse(inStream, start, noOfPoints, inStream.eof());
+	}
+
+	// add parsed stream from start on to the metrics, given the number of
+	// measurements before and whether the stream was parsed to its end
+	void countParse(std::istream& inStream, const std::istream::pos_type& start,
+					const std::size_t& noOfPoints, const bool& parsed) {
+		Metrics::getPointsParsed().add(this->measurements.getSize() - noOfPoints);
+		if (!parsed) Metrics::getParseErrors().add();
+		inStream.clear();
+		std::istream::pos_type end{inStream.seekg(0, std::ios::end).tellg()};
+		if (start != std::istream::pos_type(-1) && end != std::istream::pos_type(-1)) {
+			Metrics::getBytesParsed().add(static_cast<std::uint64_t>(end - start));
+		}
+	}
+
+	// reading function for a binary data file following its magic number,
+	// return false if it ended early
+	bool readFromBinary(std::istream& inStream) {
+		unsigned char typeCode{};
+		std::string staff, project;
+		std::uint64_t noOfMeasurements{};
+		if (!BinaryFormat::read(inStream, typeCode) || !BinaryFormat::readName(inStream, staff)
+			|| !BinaryFormat::readName(inStream, project) || !BinaryFormat::read(inStream, noOfMeasurements)) {
+			ErrorMsg::print("[EXPERIMENT] Binary data file header could not be read\n");
+			return false;
+		}
+		if (typeCode != BinaryFormat::getTypeCode(T())) {
+			ErrorMsg::print("[EXPERIMENT] Binary data file of project '" + project + "' holds another data type\n");
+			return false;
+		}
+		staffName = HeaderLine(staff);
+		projectName = HeaderLine(project);
+		std::uint32_t timestamp{};
+		T dataPoint{};
+		bool parsed{true};
+		for (std::uint64_t i{}; i < noOfMeasurements; ++i) {
+			if (!BinaryFormat::read(inStream, timestamp) || !BinaryFormat::readValue(inStream, dataPoint)) {
+				parsed = false;
+				break;
+			}
+			measurements.push_back(timestamp, dataPoint);
+		}
+		this->sortMeasurements();
+		return parsed;
 	}
 
 	// reading from screen function
@@ -168,6 +302,7 @@ public:
 		}
 		std::cin.clear(); // clear rubbish!
 		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // ignore rubbish!
+		this->sortMeasurements();
 		if (!measurements.empty()) {
 			ScreenMsg::print("[EXPERIMENT] Data was successfuly stored\n");
 		}
@@ -178,76 +313,81 @@ public:
 		}
 	}
 
+	// aggregate of all measurements, from block headers
+	Aggregate<T> getAggregate() const {
+		return this->measurements.getAggregate();
+	}
+
+	// aggregate of measurements with timestamps in [startTime, endTime],
+	// reading only the two boundary blocks
+	Aggregate<T> getAggregate(const unsigned& startTime, const unsigned& endTime) const {
+		return this->measurements.getAggregate(startTime, endTime);
+	}
+
+	// aggregate of measurements with values in [lowValue, highValue],
+	// skipping blocks by their value ranges
+	Aggregate<T> getValueAggregate(const double& lowValue, const double& highValue) const {
+		return this->measurements.getValueAggregate(lowValue, highValue);
+	}
+
 	// compute mean of data
 	T getMean() const {
-		T sum{};
-		// iterate and sum over all elements
-		for (auto it = measurements.begin(); it != measurements.end(); ++it) {
-			sum += it->getDataPoint();
-		}
-		T measurementCount = this->getNoOfMeasurements();
-		// return mean
-		return sum / measurementCount;
+		return this->getAggregate().getMean();
 	}
 
 	// compute standard deviation
 	T getStandardDeviation() const {
-		T sum{};
-		// iterate and sum over all elements minus means squared
-		for (auto it = measurements.begin(); it != measurements.end(); ++it) {
-			sum += (it->getDataPoint() - this->getMean()) * (it->getDataPoint() - this->getMean());
-		}
-		T measurementCount = this->getNoOfMeasurements() - 1;
-		T sumOverCount = sum / measurementCount;
-		// return standard deviation
-		// cast to T, as returns double, but if T is int, then we want int!
-		T standardDeviation = (T)std::sqrt(sumOverCount);
-		return standardDeviation;
+		return this->getAggregate().getStandardDeviation();
 	}
 
 	// compute error in mean
 	T getErrorInMean() const {
-		T measurementCount = this->getNoOfMeasurements();
-		// cast to T, as returns double, but if T is int, then we want int!
-		T standardError = (T)(this->getStandardDeviation() / std::sqrt(measurementCount));
-		return standardError;
+		return this->getAggregate().getErrorInMean();
 	}
 
 	// return analysis report
 	std::string getReport() const {
+		TraceSpan traceSpan("Experiment::getReport", "report");
+		return this->formatReport("", this->getAggregate());
+	}
+
+	// return analysis report of measurements with timestamps in [startTime, endTime],
+	// empty if there are none
+	std::string getReport(const unsigned& startTime, const unsigned& endTime) const {
+		TraceSpan traceSpan("Experiment::getReport", "report");
+		Aggregate<T> aggregate{ this->getAggregate(startTime, endTime) };
+		if (aggregate.count == 0) return "";
+		std::ostringstream rangeLine;
+		rangeLine << "Time range: " << startTime << " - " << endTime << std::endl;
+		return this->formatReport(rangeLine.str(), aggregate);
+	}
+
+	// return analysis report of aggregate with an optional extra header line
+	std::string formatReport(const std::string& extraHeaderLine, const Aggregate<T>& aggregate) const {
+		TraceSpan traceSpan("Experiment::formatReport", "format");
 		int prec{ 5 }; // pick precision value
 		std::ostringstream stringStream;
 		stringStream << std::endl
 			<< "Staff: " << this->staffName.getName() << std::endl
 			<< "Project: " << this->projectName.getName() << std::endl
+			<< extraHeaderLine
 			<< "-----------------------------" << std::endl
 			<< "Number of measurements: " << std::setprecision(prec)
-			<< this->getNoOfMeasurements() << std::endl
+			<< aggregate.count << std::endl
 			<< "Mean: " << std::setprecision(prec)
-			<< this->getMean() << std::endl
+			<< aggregate.getMean() << std::endl
 			<< "Standard Deviation: " << std::setprecision(prec)
-			<< this->getStandardDeviation() << std::endl
+			<< aggregate.getStandardDeviation() << std::endl
 			<< "Error in the mean: " << std::setprecision(prec)
-			<< this->getErrorInMean() << std::endl
+			<< aggregate.getErrorInMean() << std::endl
 			<< "-----------------------------" << std::endl;
 		return stringStream.str();
 	}
 
 	// delete measurement range
 	bool deleteMeasurementRange(const unsigned& startTime, const unsigned& endTime) {
-		// not values matching the range found by default
-		bool foundValues{ false };
-		auto it = measurements.begin();
-		// iterate through the list of measurements
-		while (it != measurements.end()) {
-			// if timestamp is within start-end times, erase
-			if (it->getTimestamp() >= startTime && it->getTimestamp() <= endTime) {
-				measurements.erase(it++);
-				foundValues = true;
-			}
-			else ++it;
-		}
-		if (!foundValues) {
+		// blocks inside the range are dropped whole, boundary blocks trimmed
+		if (this->measurements.erase(startTime, endTime) == 0) {
 			// no values found
 			ErrorMsg::print("\n[EXPERIMENT] Specified range does not exist\n");
 			return false;
@@ -276,17 +416,31 @@ public:
 		DebugMsg::print("[PROJECT] Parametrised constructor called\n");
 		this->staffName = HeaderLine{ userExperimentPtr.get()->getStaffName() };
 		this->projectName = HeaderLine{ userExperimentPtr.get()->getProjectName() };
-		this->measurements = userExperimentPtr.get()->getMeasurements();
+		this->measurements = userExperimentPtr.get()->getSeries();
+	}
+
+	// parametrised constructor - project of a single experiment, stored in
+	// the same arena
+	Project(const Experiment<T>& userExperiment) : Experiment<T>(userExperiment) {
+		DebugMsg::print("[PROJECT] Parametrised constructor called\n");
+	}
+
+	// parametrised constructor - project taking over the blocks of a single
+	// experiment without copying them
+	Project(Experiment<T>&& userExperiment) : Experiment<T>(std::move(userExperiment)) {
+		DebugMsg::print("[PROJECT] Parametrised constructor called\n");
 	}
 
 	// copy constructor for deep copying - calling base class copy constructor
 	Project(const Project& userProject) : Experiment<T>(userProject) {
 		DebugMsg::print("[PROJECT] Copy constructor for deep copying called\n");
+		Instrument::countCopy(InstrumentedType::PROJECT);
 	}
 
 	// move constructor - calling base class move constructor
 	Project(Project&& userProject) : Experiment<T>(userProject) {
 		DebugMsg::print("[PROJECT] Move constructor called\n");
+		Instrument::countMove(InstrumentedType::PROJECT);
 	}
 
 	// default destructor
@@ -297,6 +451,7 @@ public:
 	// copy assignment operator - calling base class assignment operator
 	Project& operator=(const Project& userProject) {
 		DebugMsg::print("[PROJECT] Copy assignment operator called\n");
+		Instrument::countCopy(InstrumentedType::PROJECT);
 		Experiment<T>::operator=(userProject);
 		return *this;
 	}
@@ -304,19 +459,23 @@ public:
 	// move assignment operator - calling base class move assignment operator
 	Project& operator=(Project&& userProject) {
 		DebugMsg::print("[PROJECT] Move assignment operator called\n");
+		Instrument::countMove(InstrumentedType::PROJECT);
 		Experiment<T>::operator=(userProject);
 		return *this;
 	}
 
 	// merge experiments if they belong to the same project
 	void mergeExperiment(const Experiment<T>& userExperiment) {
+		InstrumentScope instrumentScope("Project::mergeExperiment");
+		TraceSpan traceSpan("Project::mergeExperiment", "merge");
 		try {
 			if (userExperiment.getProjectName() != this->getProjectName()
 				|| userExperiment.getStaffName() != this->getStaffName()) {
 				throw std::invalid_argument("[PROJECT] Cannot merge different projects!");
 			}
 			else {
-				this->measurements.merge(userExperiment.getMeasurements());
+				// both series are sorted by timestamp, so they can be merged
+				this->measurements.merge(userExperiment.getSeries());
 			}
 		}
 		catch (const std::invalid_argument& e) {
@@ -0,0 +1,198 @@
+#include <sstream>  // stringstream
+#include <iomanip>  // setprecision
+#include <tuple>    // tie
+
+#include "reportCache.hpp" // versioned report cache
+
+/* ------------------------------------------------------------------------
+* DEFINE TIME RANGE
+* -----------------------------------------------------------------------*/
+
+// default constructor - all timestamps
+TimeRange::TimeRange() : isRange{false}, startTime{}, endTime{} {}
+
+// parametrised constructor
+TimeRange::TimeRange(const unsigned& userStartTime, const unsigned& userEndTime)
+                    : isRange{true}, startTime{userStartTime}, endTime{userEndTime} {}
+
+// comparison operator
+bool TimeRange::operator<(const TimeRange& otherRange) const {
+    return std::tie(isRange, startTime, endTime)
+         < std::tie(otherRange.isRange, otherRange.startTime, otherRange.endTime);
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE QUERY KEY
+* -----------------------------------------------------------------------*/
+
+// comparison operator
+bool QueryKey::operator<(const QueryKey& otherKey) const {
+    return std::tie(view, scope, staffName, projectName, range)
+         < std::tie(otherKey.view, otherKey.scope, otherKey.staffName,
+                    otherKey.projectName, otherKey.range);
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE VERSIONED REPORT CACHE
+* -----------------------------------------------------------------------*/
+
+// default constructor
+ReportCache::ReportCache() : queryBytes{}, noOfRangeFragments{}, queryHits{}, queryMisses{}, fragmentHits{}, fragmentMisses{} {
+    DebugMsg::print("[REPORT-CACHE] Default constructor called\n");
+}
+
+// look up query output
+bool ReportCache::findQuery(const QueryKey& query, const ProjectVersionList& dependencies,
+                            std::string& output) {
+    auto it = queries.find(query);
+    // valid only if computed from exactly the same project versions
+    if (it != queries.end() && it->second.dependencies == dependencies) {
+        ++queryHits;
+        output = it->second.output;
+        return true;
+    }
+    ++queryMisses;
+    return false;
+}
+
+// store query output
+void ReportCache::storeQuery(const QueryKey& query, const ProjectVersionList& dependencies,
+                             const std::string& output) {
+    // an older output of the query is replaced in any case
+    auto it = queries.find(query);
+    if (it != queries.end()) {
+        queryBytes -= it->second.output.size();
+        queries.erase(it);
+    }
+    if (output.size() > maxQueryOutputBytes) {
+        DebugMsg::print("[REPORT-CACHE] Query output too large, not cached\n");
+        return;
+    }
+    // keep the cache bounded, fragments survive so rebuilding is cheap
+    if (queries.size() >= maxQueries || queryBytes + output.size() > maxQueryBytes) {
+        DebugMsg::print("[REPORT-CACHE] Query cache full, clearing\n");
+        queries.clear();
+        queryBytes = 0;
+    }
+    QueryEntry& entry = queries[query];
+    entry.dependencies = dependencies;
+    entry.output = output;
+    queryBytes += output.size();
+}
+
+// look up project report
+bool ReportCache::findFragment(const CachedProjectKeyType& project, const TimeRange& range,
+                               const unsigned long& version, std::string& report) {
+    auto it = fragments.find(std::make_pair(project, range));
+    if (it != fragments.end() && it->second.version == version) {
+        ++fragmentHits;
+        report = it->second.report;
+        return true;
+    }
+    ++fragmentMisses;
+    return false;
+}
+
+// store project report
+void ReportCache::storeFragment(const CachedProjectKeyType& project, const TimeRange& range,
+                                const unsigned long& version, const std::string& report) {
+    // fragments of older versions can never be used again; fragments of
+    // one project are adjacent in the map
+    auto it = fragments.lower_bound(std::make_pair(project, TimeRange{}));
+    while (it != fragments.end() && it->first.first == project) {
+        if (it->second.version < version) {
+            if (it->first.second.isRange) --noOfRangeFragments;
+            fragments.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    auto key = std::make_pair(project, range);
+    // keep the cache bounded, whole project fragments survive so reports
+    // of all data stay cached
+    if (range.isRange && noOfRangeFragments >= maxRangeFragments && fragments.find(key) == fragments.end()) {
+        DebugMsg::print("[REPORT-CACHE] Range fragment cache full, clearing\n");
+        for (auto it = fragments.begin(); it != fragments.end();) {
+            if (it->first.second.isRange) fragments.erase(it++);
+            else ++it;
+        }
+        noOfRangeFragments = 0;
+    }
+    auto inserted = fragments.insert(std::make_pair(key, FragmentEntry{version, report}));
+    if (inserted.second) {
+        if (range.isRange) ++noOfRangeFragments;
+    } else {
+        inserted.first->second.version = version;
+        inserted.first->second.report = report;
+    }
+}
+
+// forget all fragments of a deleted project
+void ReportCache::dropProject(const CachedProjectKeyType& project) {
+    // fragments of one project are adjacent in the map
+    auto it = fragments.lower_bound(std::make_pair(project, TimeRange{}));
+    while (it != fragments.end() && it->first.first == project) {
+        if (it->first.second.isRange) --noOfRangeFragments;
+        fragments.erase(it++);
+    }
+}
+
+// forget everything
+void ReportCache::clear() {
+    queries.clear();
+    queryBytes = 0;
+    fragments.clear();
+    noOfRangeFragments = 0;
+}
+
+// access functions
+unsigned long ReportCache::getHits() const { return queryHits + fragmentHits; }
+unsigned long ReportCache::getMisses() const { return queryMisses + fragmentMisses; }
+
+// fraction of lookups answered from the cache
+double ReportCache::getHitRate() const {
+    unsigned long lookups{this->getHits() + this->getMisses()};
+    if (lookups == 0) return 0;
+    return static_cast<double>(this->getHits()) / lookups;
+}
+
+// approximate heap memory held by the cache
+std::size_t ReportCache::getMemoryUsage() const {
+    // red-black tree node: colour, parent, left and right pointers
+    const std::size_t nodeOverhead{4 * sizeof(void*)};
+    std::size_t bytes{};
+    for (auto it = queries.begin(); it != queries.end(); ++it) {
+        bytes += nodeOverhead + sizeof(*it)
+               + it->first.staffName.capacity() + it->first.projectName.capacity()
+               + it->second.output.capacity();
+        for (auto dep = it->second.dependencies.begin(); dep != it->second.dependencies.end(); ++dep) {
+            bytes += dep->first.first.capacity() + dep->first.second.capacity();
+        }
+        bytes += it->second.dependencies.capacity() * sizeof(ProjectVersionList::value_type);
+    }
+    for (auto it = fragments.begin(); it != fragments.end(); ++it) {
+        bytes += nodeOverhead + sizeof(*it)
+               + it->first.first.first.capacity() + it->first.first.second.capacity()
+               + it->second.report.capacity();
+    }
+    return bytes;
+}
+
+// return cache statistics table
+std::string ReportCache::show() const {
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "-----------------------------" << std::endl
+        << "Report cache"                  << std::endl
+        << "-----------------------------" << std::endl
+        << "Cached queries: "   << queries.size()   << std::endl
+        << "Cached projects: "  << fragments.size() << std::endl
+        << "Query hits: "       << queryHits        << std::endl
+        << "Query misses: "     << queryMisses      << std::endl
+        << "Project hits: "     << fragmentHits     << std::endl
+        << "Project misses: "   << fragmentMisses   << std::endl
+        << "Hit rate: "         << std::setprecision(3) << 100 * this->getHitRate() << "%" << std::endl
+        << "Memory: "           << this->getMemoryUsage() << " bytes" << std::endl
+        << "-----------------------------" << std::endl;
+    return stringStream.str();
+}
@@ -0,0 +1,127 @@
+#ifndef REPORT_CACHE_HPP
+#define REPORT_CACHE_HPP
+
+#include <iostream> // std
+#include <string>   // string
+#include <map>      // map
+#include <vector>   // vector
+#include <utility>  // pair
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* DEFINE SOME TYPES
+* -----------------------------------------------------------------------*/
+
+// cached project key is a pair of staff and project (same as ProjectDbKeyType)
+using CachedProjectKeyType = std::pair<std::string, std::string>;
+// projects a query result was computed from, together with their versions
+using ProjectVersionList = std::vector<std::pair<CachedProjectKeyType, unsigned long>>;
+
+// which projects a query covers
+enum class QueryScope { ALL, STAFF, PROJECT, PAIR };
+// what a query returns
+enum class QueryView { REPORT, DATA };
+
+/* ------------------------------------------------------------------------
+* TIME RANGE OF A QUERY
+* -----------------------------------------------------------------------*/
+
+struct TimeRange {
+    // false if query covers all timestamps
+    bool isRange;
+    unsigned startTime;
+    unsigned endTime;
+    // default constructor - all timestamps
+    TimeRange();
+    // parametrised constructor - timestamps in [startTime, endTime]
+    TimeRange(const unsigned& userStartTime, const unsigned& userEndTime);
+    // comparison operator
+    bool operator<(const TimeRange& otherRange) const;
+};
+
+/* ------------------------------------------------------------------------
+* KEY OF A CACHED QUERY
+* -----------------------------------------------------------------------*/
+
+struct QueryKey {
+    QueryView view;
+    QueryScope scope;
+    std::string staffName;
+    std::string projectName;
+    TimeRange range;
+    // comparison operator
+    bool operator<(const QueryKey& otherKey) const;
+};
+
+/* ------------------------------------------------------------------------
+* VERSIONED REPORT CACHE
+* -----------------------------------------------------------------------*/
+
+// Keeps rendered query outputs and per-project report fragments. Each result
+// remembers the versions of the projects it was computed from and is only
+// reused while all of them are unchanged.
+class ReportCache {
+private:
+    // whole query output
+    struct QueryEntry {
+        ProjectVersionList dependencies;
+        std::string output;
+    };
+    // report of a single project
+    struct FragmentEntry {
+        unsigned long version;
+        std::string report;
+    };
+    std::map<QueryKey, QueryEntry> queries;
+    // characters of all cached query outputs
+    std::size_t queryBytes;
+    std::map<std::pair<CachedProjectKeyType, TimeRange>, FragmentEntry> fragments;
+    // fragments of time ranges rather than whole projects
+    std::size_t noOfRangeFragments;
+    // hit and miss counters
+    unsigned long queryHits, queryMisses, fragmentHits, fragmentMisses;
+
+public:
+    // maximum number of whole query outputs kept at a time
+    static const std::size_t maxQueries{256};
+    // maximum characters of all cached query outputs, and of one of them;
+    // larger outputs, e.g. data views of big datasets, are not cached
+    static const std::size_t maxQueryBytes{64 << 20};
+    static const std::size_t maxQueryOutputBytes{16 << 20};
+    // maximum number of time range fragments kept at a time; there is at
+    // most one whole project fragment per project
+    static const std::size_t maxRangeFragments{4096};
+
+    // default constructor
+    ReportCache();
+
+    // look up query output, true if found and still valid
+    bool findQuery(const QueryKey& query, const ProjectVersionList& dependencies,
+                   std::string& output);
+    // store query output unless it is larger than maxQueryOutputBytes
+    void storeQuery(const QueryKey& query, const ProjectVersionList& dependencies,
+                    const std::string& output);
+    // look up project report, true if found for this project version
+    bool findFragment(const CachedProjectKeyType& project, const TimeRange& range,
+                      const unsigned long& version, std::string& report);
+    // store project report, replacing reports of older project versions
+    void storeFragment(const CachedProjectKeyType& project, const TimeRange& range,
+                       const unsigned long& version, const std::string& report);
+    // forget all fragments of a deleted project
+    void dropProject(const CachedProjectKeyType& project);
+    // forget everything
+    void clear();
+
+    // access functions
+    unsigned long getHits() const;
+    unsigned long getMisses() const;
+    // fraction of lookups answered from the cache
+    double getHitRate() const;
+    // approximate heap memory held by the cache in bytes
+    std::size_t getMemoryUsage() const;
+    // return cache statistics table
+    std::string show() const;
+};
+
+#endif /* REPORT_CACHE_HPP */
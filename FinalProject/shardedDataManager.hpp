@@ -0,0 +1,519 @@
+#ifndef SHARDED_DATA_MANAGER_HPP
+#define SHARDED_DATA_MANAGER_HPP
+
+#include <iostream>   // std
+#include <string>     // string
+#include <vector>     // vector
+#include <list>       // list
+#include <sstream>    // stringstream
+#include <iomanip>    // setprecision
+#include <algorithm>  // sort
+#include <functional> // hash
+#include <utility>    // pair, move
+#include <memory>     // unique pointer
+#include <thread>     // thread
+#include <mutex>      // mutex, lock_guard, unique_lock
+#include <chrono>     // steady_clock
+
+#include "msg.hpp"         // classes managing outputs
+#include "maps.hpp"        // classes managing databases
+#include "threadPool.hpp"  // work-stealing thread pool
+#include "reportCache.hpp" // query keys and time ranges
+#include "metrics.hpp"     // operational metrics
+
+/* ------------------------------------------------------------------------
+* SHARDED DATA MANAGER CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// DataManager for many producer threads inserting at once. The project
+// database is split into shards by staff/project hash, the staff and
+// project reference databases into shards by name hash, and every shard
+// has its own lock, so inserts into different projects rarely wait for
+// each other even when a few staff members get most of them. A project is
+// only read or changed while its shard is locked.
+//
+// Locks are always taken in the order project shards (by index), staff
+// shards, project name shards, so no two threads wait for each other in a
+// cycle. An insert holds its project shard while updating the references,
+// so references never point to a replaced project. Reports over all data
+// run shard by shard in parallel; staff and project data views lock all
+// project shards for a moment. Output is the same as that of DataManager.
+// Batch mode loads it with --shards, from files, from the parser threads
+// of --producers or from the load generator, and queries it like a
+// DataManager; it has no report cache, frozen layout or arena.
+//
+// Shards allocate from the heap rather than an arena, because project
+// control blocks are released from reference shards under other locks.
+template <typename T> class ShardedDataManager {
+private:
+    // projects of one shard
+    struct ProjectShard {
+        std::mutex shardMutex;
+        ProjectDb<T> database;
+    };
+    // staff or project references of one shard
+    struct ReferenceShard {
+        std::mutex shardMutex;
+        ProjectReferenceDb<T> database;
+        ReferenceShard(const std::string& mapFrom, const std::string& mapTo) : database{mapFrom, mapTo} {}
+    };
+
+    std::vector<std::unique_ptr<ProjectShard>> projectShards;
+    std::vector<std::unique_ptr<ReferenceShard>> staffShards;
+    std::vector<std::unique_ptr<ReferenceShard>> projectNameShards;
+
+    // index of the shard of a staff/project pair
+    std::size_t getProjectShardIndex(const std::string& staffName, const std::string& projectName) const {
+        std::size_t hash{std::hash<std::string>()(staffName) * 31 + std::hash<std::string>()(projectName)};
+        // mix, so that pairs sharing a staff name spread over all shards
+        hash ^= hash >> 15;
+        hash *= 0x2C1B3C6DU;
+        hash ^= hash >> 12;
+        return hash % projectShards.size();
+    }
+
+    // shard of a staff/project pair
+    ProjectShard& getProjectShard(const std::string& staffName, const std::string& projectName) {
+        return *projectShards[this->getProjectShardIndex(staffName, projectName)];
+    }
+
+    // shard of a staff or project name
+    static ReferenceShard& getReferenceShard(std::vector<std::unique_ptr<ReferenceShard>>& shards,
+                                             const std::string& name) {
+        return *shards[std::hash<std::string>()(name) % shards.size()];
+    }
+
+    // add references of the batch items of one reference shard in batch
+    // order; keys holds the names of every item, projectFirst tells whether
+    // the shard is keyed by project name
+    static void addReferences(ReferenceShard& shard, const std::vector<std::size_t>& items,
+                              const std::vector<ProjectDbKeyType>& keys,
+                              const std::vector<ProjectWeakPtr<T>>& weakProjects, const bool& projectFirst) {
+        std::lock_guard<std::mutex> lock(shard.shardMutex);
+        for (auto it = items.begin(); it != items.end(); ++it) {
+            const std::string& name = projectFirst ? keys[*it].second : keys[*it].first;
+            const std::string& otherName = projectFirst ? keys[*it].first : keys[*it].second;
+            // a project deleted since its insert leaves the reference to a
+            // newer project of the pair as it is
+            if (weakProjects[*it].expired() && shard.database.contains(name, otherName)) continue;
+            shard.database.addEntry(name, otherName, weakProjects[*it]);
+        }
+    }
+
+    // return report of a project, optionally only within time range
+    static std::string getProjectReport(const Project<T>& project, const TimeRange& range) {
+        if (range.isRange) return project.getReport(range.startTime, range.endTime);
+        return project.getReport();
+    }
+
+    // return per-project output of all projects in staff/project order;
+    // every shard is locked and turned into output on its own worker
+    template <typename Function> std::string fanOut(Function projectOutput, bool& found) {
+        // (key, output) of every project, sorted per shard
+        std::vector<std::vector<std::pair<ProjectDbKeyType, std::string>>> shardOutputs(projectShards.size());
+        WorkStealingPool::getSharedPool().parallelFor(projectShards.size(), [&](std::size_t s) {
+            ProjectShard& shard = *projectShards[s];
+            std::lock_guard<std::mutex> lock(shard.shardMutex);
+            std::vector<ProjectSharedPtr<T>> projects{shard.database.getProjects()};
+            shardOutputs[s].reserve(projects.size());
+            for (auto it = projects.begin(); it != projects.end(); ++it) {
+                Project<T>& project = *(*it).get();
+                shardOutputs[s].push_back(std::make_pair(
+                    std::make_pair(project.getStaffName(), project.getProjectName()),
+                    projectOutput(shard, project)));
+            }
+        });
+        // merge shards back into the order of one database
+        std::vector<const std::pair<ProjectDbKeyType, std::string>*> outputs;
+        for (auto shard = shardOutputs.begin(); shard != shardOutputs.end(); ++shard) {
+            for (auto it = shard->begin(); it != shard->end(); ++it) outputs.push_back(&*it);
+        }
+        found = !outputs.empty();
+        std::sort(outputs.begin(), outputs.end(), [](const std::pair<ProjectDbKeyType, std::string>* a,
+                                                     const std::pair<ProjectDbKeyType, std::string>* b) {
+            return a->first < b->first;
+        });
+        std::ostringstream stringStream;
+        for (auto it = outputs.begin(); it != outputs.end(); ++it) stringStream << (*it)->second;
+        return stringStream.str();
+    }
+
+    // return report of the projects referred to by one staff or project name
+    std::string getReferenceReport(std::vector<std::unique_ptr<ReferenceShard>>& shards,
+                                   const std::string& name, const TimeRange& range, bool& found) {
+        std::vector<ProjectSharedPtr<T>> projects;
+        {
+            ReferenceShard& shard = getReferenceShard(shards, name);
+            std::lock_guard<std::mutex> lock(shard.shardMutex);
+            if (!shard.database.contains(name)) {
+                ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+                found = false;
+                return "";
+            }
+            projects = shard.database.getProjects(name);
+        }
+        found = !projects.empty();
+        // each report is computed while the shard of its project is locked
+        std::vector<std::string> reports(projects.size());
+        WorkStealingPool::getSharedPool().parallelFor(projects.size(), [&](std::size_t i) {
+            Project<T>& project = *projects[i].get();
+            ProjectShard& shard = this->getProjectShard(project.getStaffName(), project.getProjectName());
+            std::lock_guard<std::mutex> lock(shard.shardMutex);
+            reports[i] = getProjectReport(project, range);
+        });
+        std::ostringstream stringStream;
+        for (auto it = reports.begin(); it != reports.end(); ++it) stringStream << *it;
+        return stringStream.str();
+    }
+
+    // return data of the projects referred to by one staff or project name
+    std::string showReference(std::vector<std::unique_ptr<ReferenceShard>>& shards,
+                              const std::string& name, const TimeRange& range, bool& found) {
+        // projects of one name are spread over all project shards
+        std::vector<std::unique_lock<std::mutex>> locks;
+        for (auto it = projectShards.begin(); it != projectShards.end(); ++it) {
+            locks.push_back(std::unique_lock<std::mutex>((*it)->shardMutex));
+        }
+        ReferenceShard& shard = getReferenceShard(shards, name);
+        std::lock_guard<std::mutex> lock(shard.shardMutex);
+        found = !shard.database.getProjects(name).empty();
+        return shard.database.show(name, range);
+    }
+
+    // return merged table of all pairs of the reference shards
+    std::string showNames(std::vector<std::unique_ptr<ReferenceShard>>& shards,
+                          const std::string& keys, const std::string& values) {
+        std::vector<std::pair<std::string, std::string>> entries;
+        for (auto it = shards.begin(); it != shards.end(); ++it) {
+            std::lock_guard<std::mutex> lock((*it)->shardMutex);
+            ProjectReferenceDbType pairs{(*it)->database.getDatabase()};
+            entries.insert(entries.end(), pairs.begin(), pairs.end());
+        }
+        // all pairs of a name are in one shard, in insertion order
+        std::stable_sort(entries.begin(), entries.end(), [](const std::pair<std::string, std::string>& a,
+                                                            const std::pair<std::string, std::string>& b) {
+            return a.first < b.first;
+        });
+        ProjectReferenceDb<T> merged(keys, values);
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            merged.addEntry(it->first, it->second, ProjectWeakPtr<T>{});
+        }
+        return merged.show();
+    }
+
+public:
+    // parametrised constructor - noOfShards shards for each database
+    ShardedDataManager(const std::size_t& noOfShards = 16) {
+        DebugMsg::print("[SHARDED-DATA-MANAGER] Parametrised constructor called\n");
+        std::size_t shards{noOfShards > 0 ? noOfShards : 1};
+        for (std::size_t i{}; i < shards; ++i) {
+            projectShards.push_back(std::unique_ptr<ProjectShard>(new ProjectShard()));
+            staffShards.push_back(std::unique_ptr<ReferenceShard>(new ReferenceShard("Staff", "Project")));
+            projectNameShards.push_back(std::unique_ptr<ReferenceShard>(new ReferenceShard("Project", "Staff")));
+        }
+    }
+
+    // shards hold mutexes, so the manager is neither copied nor moved
+    ShardedDataManager(const ShardedDataManager&) = delete;
+    ShardedDataManager& operator=(const ShardedDataManager&) = delete;
+
+    // default destructor
+    ~ShardedDataManager() {
+        DebugMsg::print("[SHARDED-DATA-MANAGER] Default destructor called\n");
+    }
+
+    // access function
+    std::size_t getNoOfShards() const { return this->projectShards.size(); }
+
+    // insert experiment, a new project takes over its measurements;
+    // experiments must allocate from the heap
+    void insertExperiment(Experiment<T>&& userExperiment) {
+        std::string staffName = userExperiment.getStaffName();
+        std::string projectName = userExperiment.getProjectName();
+        ProjectShard& shard = this->getProjectShard(staffName, projectName);
+        std::lock_guard<std::mutex> lock(shard.shardMutex);
+        ProjectWeakPtr<T> weakProject = shard.database.addEntry(staffName, projectName, std::move(userExperiment));
+        {
+            ReferenceShard& staffShard = getReferenceShard(staffShards, staffName);
+            std::lock_guard<std::mutex> staffLock(staffShard.shardMutex);
+            staffShard.database.addEntry(staffName, projectName, weakProject);
+        }
+        ReferenceShard& projectShard = getReferenceShard(projectNameShards, projectName);
+        std::lock_guard<std::mutex> projectLock(projectShard.shardMutex);
+        projectShard.database.addEntry(projectName, staffName, weakProject);
+    }
+
+    // insert copy of experiment
+    void insertExperiment(const Experiment<T>& userExperiment) {
+        this->insertExperiment(Experiment<T>(userExperiment));
+    }
+
+    // insert batch of experiments, same as inserting them one by one in
+    // batch order; every project shard inserts its experiments on a worker
+    // of its own, then every reference shard adds their references
+    void insertExperiments(std::vector<Experiment<T>>&& userExperiments) {
+        std::vector<ProjectDbKeyType> keys;
+        keys.reserve(userExperiments.size());
+        // batch items of every shard, in batch order
+        std::vector<std::vector<std::size_t>> projectItems(projectShards.size());
+        std::vector<std::vector<std::size_t>> staffItems(staffShards.size());
+        std::vector<std::vector<std::size_t>> projectNameItems(projectNameShards.size());
+        std::hash<std::string> hash;
+        for (std::size_t i{}; i < userExperiments.size(); ++i) {
+            keys.push_back(std::make_pair(userExperiments[i].getStaffName(), userExperiments[i].getProjectName()));
+            projectItems[this->getProjectShardIndex(keys[i].first, keys[i].second)].push_back(i);
+            staffItems[hash(keys[i].first) % staffShards.size()].push_back(i);
+            projectNameItems[hash(keys[i].second) % projectNameShards.size()].push_back(i);
+        }
+        std::vector<ProjectWeakPtr<T>> weakProjects(userExperiments.size());
+        WorkStealingPool::getSharedPool().parallelFor(projectShards.size(), [&](std::size_t s) {
+            if (projectItems[s].empty()) return;
+            ProjectShard& shard = *projectShards[s];
+            std::lock_guard<std::mutex> lock(shard.shardMutex);
+            for (auto it = projectItems[s].begin(); it != projectItems[s].end(); ++it) {
+                weakProjects[*it] = shard.database.addEntry(keys[*it].first, keys[*it].second,
+                                                            std::move(userExperiments[*it]));
+            }
+        });
+        WorkStealingPool::getSharedPool().parallelFor(staffShards.size() + projectNameShards.size(),
+                                                      [&](std::size_t s) {
+            if (s < staffShards.size()) {
+                if (!staffItems[s].empty()) addReferences(*staffShards[s], staffItems[s], keys, weakProjects, false);
+                return;
+            }
+            s -= staffShards.size();
+            if (!projectNameItems[s].empty()) {
+                addReferences(*projectNameShards[s], projectNameItems[s], keys, weakProjects, true);
+            }
+        });
+    }
+
+    // delete project
+    bool deleteEntry(const std::string& staff, const std::string& project) {
+        ProjectShard& shard = this->getProjectShard(staff, project);
+        std::lock_guard<std::mutex> lock(shard.shardMutex);
+        return shard.database.deleteEntry(staff, project);
+    }
+
+    // delete measurements
+    bool deleteMeasurementRange(const std::string& staff, const std::string& project,
+                                const unsigned& startRange, const unsigned& endRange) {
+        ProjectShard& shard = this->getProjectShard(staff, project);
+        std::lock_guard<std::mutex> lock(shard.shardMutex);
+        return shard.database.deleteMeasurementRange(staff, project, startRange, endRange);
+    }
+
+    // return query output, same as the DataManager show and report functions
+    std::string runQuery(const QueryKey& query) {
+        const TimeRange& range = query.range;
+        std::string output;
+        // true if the query covers an existing project
+        bool found{true};
+        if (query.scope == QueryScope::ALL) {
+            if (query.view == QueryView::DATA) {
+                output = this->fanOut([&range](ProjectShard& shard, const Project<T>& project) {
+                    return shard.database.show(project.getStaffName(), project.getProjectName(), range);
+                }, found);
+            } else {
+                output = this->fanOut([&range](ProjectShard&, const Project<T>& project) {
+                    return getProjectReport(project, range);
+                }, found);
+            }
+        } else if (query.scope == QueryScope::STAFF) {
+            output = query.view == QueryView::DATA
+                   ? this->showReference(staffShards, query.staffName, range, found)
+                   : this->getReferenceReport(staffShards, query.staffName, range, found);
+        } else if (query.scope == QueryScope::PROJECT) {
+            output = query.view == QueryView::DATA
+                   ? this->showReference(projectNameShards, query.projectName, range, found)
+                   : this->getReferenceReport(projectNameShards, query.projectName, range, found);
+        } else {
+            ProjectShard& shard = this->getProjectShard(query.staffName, query.projectName);
+            std::lock_guard<std::mutex> lock(shard.shardMutex);
+            ProjectSharedPtr<T> project{shard.database.getProject(query.staffName, query.projectName)};
+            if (!project) {
+                ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+                return "";
+            }
+            if (query.view == QueryView::DATA) {
+                output = shard.database.show(query.staffName, query.projectName, range);
+            } else {
+                output = getProjectReport(*project.get(), range);
+            }
+        }
+        if (found && output.empty() && range.isRange) {
+            ErrorMsg::print("\n[DATA-MANAGER] No measurements found in specified time range\n");
+        }
+        return output;
+    }
+
+    // return arena of the dataset, none, so new experiments allocate from
+    // the heap
+    const std::shared_ptr<Arena>& getArena() const {
+        static const std::shared_ptr<Arena> noArena;
+        return noArena;
+    }
+
+    // printing functions, same as those of DataManager
+    std::string fullDatabaseShow() {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", TimeRange{}});
+    }
+    std::string fullDatabaseShow(const std::string& staffName, const std::string& projectName) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName, TimeRange{}});
+    }
+    std::string staffDatabaseShow() {
+        return this->showNames(staffShards, "Staff", "Project");
+    }
+    std::string staffDatabaseShow(const std::string& staffName) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "", TimeRange{}});
+    }
+    std::string projectDatabaseShow() {
+        return this->showNames(projectNameShards, "Project", "Staff");
+    }
+    std::string projectDatabaseShow(const std::string& projectName) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName, TimeRange{}});
+    }
+
+    // printing functions restricted to timestamps in [startTime, endTime]
+    std::string fullDatabaseRangeShow(const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::ALL, "", "", TimeRange{startTime, endTime}});
+    }
+    std::string fullDatabaseRangeShow(const std::string& staffName, const std::string& projectName,
+                                      const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PAIR, staffName, projectName,
+                                       TimeRange{startTime, endTime}});
+    }
+    std::string staffDatabaseRangeShow(const std::string& staffName,
+                                       const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::STAFF, staffName, "",
+                                       TimeRange{startTime, endTime}});
+    }
+    std::string projectDatabaseRangeShow(const std::string& projectName,
+                                         const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::DATA, QueryScope::PROJECT, "", projectName,
+                                       TimeRange{startTime, endTime}});
+    }
+
+    // report functions
+    std::string getReport() {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", TimeRange{}});
+    }
+    std::string getReport(const std::string& staffName, const std::string& projectName) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName, TimeRange{}});
+    }
+    std::string getStaffReport(const std::string& staffName) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "", TimeRange{}});
+    }
+    std::string getProjectReport(const std::string& projectName) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName, TimeRange{}});
+    }
+
+    // report functions restricted to timestamps in [startTime, endTime]
+    std::string getRangeReport(const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::ALL, "", "", TimeRange{startTime, endTime}});
+    }
+    std::string getRangeReport(const std::string& staffName, const std::string& projectName,
+                               const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PAIR, staffName, projectName,
+                                       TimeRange{startTime, endTime}});
+    }
+    std::string getStaffRangeReport(const std::string& staffName,
+                                    const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::STAFF, staffName, "",
+                                       TimeRange{startTime, endTime}});
+    }
+    std::string getProjectRangeReport(const std::string& projectName,
+                                      const unsigned& startTime, const unsigned& endTime) {
+        return this->runQuery(QueryKey{QueryView::REPORT, QueryScope::PROJECT, "", projectName,
+                                       TimeRange{startTime, endTime}});
+    }
+
+    // set measurement gauges of every project of the dataset, shard by shard
+    void publishMetrics(const std::string& dataset) {
+        std::string datasetLabel{Metrics::getLabel("dataset", dataset)};
+        // deleted projects go
+        Metrics::removeGauges("datahero_project_points", datasetLabel + ",");
+        for (auto shard = projectShards.begin(); shard != projectShards.end(); ++shard) {
+            std::lock_guard<std::mutex> lock((*shard)->shardMutex);
+            std::vector<ProjectSharedPtr<T>> projects{(*shard)->database.getProjects()};
+            for (auto it = projects.begin(); it != projects.end(); ++it) {
+                Metrics::setGauge("datahero_project_points", "Measurements of a project.",
+                                  datasetLabel + "," + Metrics::getLabel("staff", (*it).get()->getStaffName()) + ","
+                                  + Metrics::getLabel("project", (*it).get()->getProjectName()),
+                                  static_cast<double>((*it).get()->getNoOfMeasurements()));
+            }
+        }
+    }
+
+    // measure insert throughput of 1 to maxThreads producer threads, each
+    // inserting experimentsPerThread experiments of 16 measurements, into
+    // one shard (a single lock) and into noOfShards shards; staff members
+    // are picked with Zipf-distributed skew, projects uniformly from the
+    // ones of the thread, so that every project grows in time order as if
+    // read from its own files
+    static std::string benchmarkInserts(const unsigned& maxThreads, const std::size_t& noOfShards = 16,
+                                        const std::size_t& experimentsPerThread = 50000) {
+        const std::size_t noOfStaff{64}, projectsPerStaff{8}, measurementsPerExperiment{16};
+        // staff k is picked with probability proportional to 1 / (k + 1)
+        std::vector<double> cumulative;
+        double total{};
+        for (std::size_t k{}; k < noOfStaff; ++k) cumulative.push_back(total += 1.0 / (k + 1));
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Concurrent inserts"            << std::endl
+            << "-----------------------------" << std::endl
+            << "Threads\t1 lock/s\t" << noOfShards << " shards/s\tSpeedup" << std::endl;
+        double singleRate{};
+        for (unsigned noOfThreads{1}; noOfThreads <= maxThreads; ++noOfThreads) {
+            double rates[2]{};
+            std::size_t shardCounts[2]{1, noOfShards};
+            for (int run{}; run < 2; ++run) {
+                // experiments are made up front, so only inserting is timed
+                std::vector<std::vector<Experiment<T>>> experiments(noOfThreads);
+                for (unsigned t{}; t < noOfThreads; ++t) {
+                    unsigned long long next{t + 1};
+                    experiments[t].reserve(experimentsPerThread);
+                    for (std::size_t e{}; e < experimentsPerThread; ++e) {
+                        next = next * 6364136223846793005ULL + 1442695040888963407ULL;
+                        double pick{static_cast<double>(next >> 11) / 9007199254740992.0 * total};
+                        std::size_t staff{static_cast<std::size_t>(
+                            std::lower_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin())};
+                        if (staff >= noOfStaff) staff = noOfStaff - 1;
+                        std::size_t project{static_cast<std::size_t>(next >> 40) % projectsPerStaff};
+                        std::list<Measurement<T>> measurements;
+                        for (std::size_t m{}; m < measurementsPerExperiment; ++m) {
+                            unsigned timestamp{static_cast<unsigned>(e * measurementsPerExperiment + m)};
+                            measurements.push_back(Measurement<T>(timestamp, T(static_cast<int>(m))));
+                        }
+                        experiments[t].push_back(Experiment<T>(HeaderLine("STAFF" + std::to_string(staff)),
+                                                               HeaderLine("P" + std::to_string(t) + "-" + std::to_string(project)),
+                                                               measurements));
+                    }
+                }
+                ShardedDataManager data(shardCounts[run]);
+                std::vector<std::thread> producers;
+                auto start = std::chrono::steady_clock::now();
+                for (unsigned t{}; t < noOfThreads; ++t) {
+                    producers.push_back(std::thread([&, t]() {
+                        for (auto it = experiments[t].begin(); it != experiments[t].end(); ++it) {
+                            data.insertExperiment(std::move(*it));
+                        }
+                    }));
+                }
+                for (auto it = producers.begin(); it != producers.end(); ++it) it->join();
+                double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+                rates[run] = noOfThreads * experimentsPerThread / seconds;
+            }
+            if (noOfThreads == 1) singleRate = rates[1];
+            stringStream << noOfThreads << "\t" << std::fixed << std::setprecision(0) << rates[0] << "\t\t"
+                         << rates[1] << "\t\t" << std::setprecision(2)
+                         << (singleRate > 0 ? rates[1] / singleRate : 0) << std::endl;
+            stringStream.unsetf(std::ios::fixed);
+        }
+        stringStream << "-----------------------------" << std::endl;
+        return stringStream.str();
+    }
+};
+
+#endif /* SHARDED_DATA_MANAGER_HPP */
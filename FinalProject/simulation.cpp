@@ -1,52 +1,662 @@
-#include "simulation.hpp" // simulation class
+#include <cstdio>    // snprintf
+#include <climits>   // UINT_MAX
+#include <cmath>     // log, sqrt, cos, pow, lround
+#include <fstream>   // ofstream
+#include <iomanip>   // setprecision
+#include <stdexcept> // invalid_argument, runtime_error
+#include <algorithm> // sort, swap_ranges, upper_bound, transform
+#include <iterator>  // back_inserter
+#include <map>       // map
+#include <mutex>     // mutex, lock_guard
+#include <exception> // exception_ptr
+
+#include "simulation.hpp"   // simulation class
+#include "binaryFormat.hpp" // binary data files
+#include "ingestQueue.hpp"  // lock-free queue between producers and data owner
+#include "filePath.hpp"     // join directory and file names
+
+/* ------------------------------------------------------------------------
+* DEFINE SIMULATION CONFIGURATION AND STATISTICS
+* -----------------------------------------------------------------------*/
+
+// return profile of name
+WorkloadProfile WorkloadProfile::get(const std::string& name) {
+    std::string lowerName{name};
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+    // every file alike: the old simulation
+    WorkloadProfile profile{lowerName, 0, 0, 1, 0, 1, 0, ValueDistribution::UNIFORM, 50, 100};
+    if (lowerName == "skewed") {
+        profile.zipfExponent = 1.1;
+    } else if (lowerName == "giant") {
+        profile.giantShare = 0.01;
+        profile.giantFactor = 100;
+    } else if (lowerName == "bursty") {
+        profile.disorderShare = 0.02;
+        profile.burstLength = 64;
+    } else if (lowerName == "duplicates") {
+        profile.duplicateShare = 0.05;
+    } else if (lowerName == "realistic") {
+        profile.zipfExponent = 1.1;
+        profile.giantShare = 0.01;
+        profile.giantFactor = 50;
+        profile.disorderShare = 0.01;
+        profile.burstLength = 32;
+        profile.duplicateShare = 0.02;
+        profile.values = ValueDistribution::NORMAL;
+    } else if (lowerName != "uniform") {
+        throw std::invalid_argument("[SIMULATION] Workload profile '" + name + "' not supported\n");
+    }
+    return profile;
+}
+
+// return value distribution of name
+ValueDistribution WorkloadProfile::getValueDistribution(const std::string& name) {
+    std::string lowerName{name};
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+    if (lowerName == "uniform") return ValueDistribution::UNIFORM;
+    if (lowerName == "normal") return ValueDistribution::NORMAL;
+    if (lowerName == "exponential") return ValueDistribution::EXPONENTIAL;
+    if (lowerName == "spiky") return ValueDistribution::SPIKY;
+    throw std::invalid_argument("[SIMULATION] Value distribution '" + name + "' not supported\n");
+}
+
+// default constructor
+SimulationConfig::SimulationConfig()
+    : dataType{"double"}, outputPath{}, noOfStaff{2}, noOfProjects{2}, noOfFiles{1}, minPoints{5},
+      maxPoints{10}, profile(WorkloadProfile::get("uniform")), pointsPerSecond{0}, seed{0},
+      format{SimulationFormat::TEXT},
+      noOfThreads{std::thread::hardware_concurrency()}, startTime{1462033286} {
+    DebugMsg::print("[SIMULATION-CONFIG] Default constructor called\n");
+}
+
+// return statistics table
+std::string SimulationStats::show() const {
+    std::ostringstream stringStream;
+    stringStream << std::endl
+        << "-----------------------------" << std::endl
+        << "Simulation"                    << std::endl
+        << "-----------------------------" << std::endl
+        << "Threads: "      << noOfThreads << std::endl
+        << "Files: "        << noOfFiles   << std::endl
+        << "Duplicate files: " << noOfDuplicates << std::endl
+        << "Measurements: " << noOfPoints  << std::endl
+        << "Bytes: "        << noOfBytes   << std::endl
+        << "Time: "         << std::fixed << std::setprecision(3) << seconds << " s" << std::endl
+        << "Throughput: "   << std::setprecision(0)
+        << (seconds > 0 ? noOfPoints / seconds : 0) << " measurements/s, "
+        << std::setprecision(1) << (seconds > 0 ? noOfBytes / seconds / 1048576 : 0) << " MB/s" << std::endl
+        << "-----------------------------" << std::endl;
+    return stringStream.str();
+}
 
 /* ------------------------------------------------------------------------
 * CLASS SIMULATING INPUT DATA
 * -----------------------------------------------------------------------*/
 
-void Simulation::simulateData(const std::string& dataHeroPath, const unsigned& noOfFiles, const std::string& dataType) {
-
-	ScreenMsg::print("[SIMULATION] Simulating data...\n");
-
-	// declare some variables
-	std::vector<std::string> staff{"Staff1", "Staff2"};
-	std::vector<std::string> projects{"A", "B"};
-
-	// initialize random seed
-	std::mt19937_64 eng{std::random_device{}()};
-	// files wll contain 5-10 measurements
-	std::uniform_int_distribution<> randNoOfValues{5, 10};
-	// files will contain values from 50 to 100
-	std::uniform_real_distribution<> randValuesReal{50, 100};
-	std::uniform_int_distribution<> randValuesInt{50, 100};	
-	// datastams will be simulated by making loop to sleep for some random time
-	std::uniform_int_distribution<> randSleepTime{100, 1000};
-
-	// simulate data
-  	for (unsigned n{}; n < noOfFiles; ++n) {
-	  	for (size_t k{}; k < staff.size(); ++k) {
-	  		for (size_t l{}; l < projects.size(); ++l) {
-			    std::ostringstream stringStream;
-			    // print table header
-			    stringStream << "Staff: "   << staff[k]     	<< std::endl 
-							 << "Project: " << projects[l]   	<< std::endl
-							 << "-----------------------------" << std::endl;
-				int noOfPoints{randNoOfValues(eng)}; 
-				for (int i{0}; i < noOfPoints; ++i) {
-					std::time_t time_now = std::time(NULL);
-					stringStream << time_now; // timestamp
-					if (dataType == "double" || dataType == "int") { 
-						stringStream << " " << (dataType == "double" ? randValuesReal(eng) : randValuesInt(eng));
-					}
-					if (dataType == "complexdouble") { 
-						stringStream << " (" << randValuesReal(eng) << ", " << randValuesReal(eng) << ")";
-					}				 
-					stringStream << std::endl;
-					std::this_thread::sleep_for(std::chrono::milliseconds{randSleepTime(eng)}); // sleep
-				}
-				std::string fileName = dataHeroPath + "sim_" + dataType + "\\" + staff[k] + "_" + projects[l] + std::to_string(n) + ".txt";
-				FileMsg::print(stringStream.str(), fileName);
-			}
-		}	
-	}
-}
\ No newline at end of file
+// return name of staff member of index, e.g. "Staff1"
+std::string Simulation::getStaffName(const unsigned& index) {
+    return "Staff" + std::to_string(index + 1);
+}
+
+// return name of project of index: "A" to "Z", then "AA", "AB", ...
+std::string Simulation::getProjectName(const unsigned& index) {
+    std::string name;
+    unsigned long long remaining{index + 1ULL};
+    while (remaining > 0) {
+        --remaining;
+        name.insert(name.begin(), static_cast<char>('A' + remaining % 26));
+        remaining /= 26;
+    }
+    return name;
+}
+
+// append unsigned value to text buffer
+void Simulation::appendText(std::string& buffer, const unsigned& value) {
+    char digits[10];
+    char* end{digits + sizeof(digits)};
+    char* begin{end};
+    unsigned remaining{value};
+    do {
+        *--begin = static_cast<char>('0' + remaining % 10);
+        remaining /= 10;
+    } while (remaining > 0);
+    buffer.append(begin, end);
+}
+
+// append int value to text buffer
+void Simulation::appendText(std::string& buffer, const int& value) {
+    if (value < 0) buffer.push_back('-');
+    appendText(buffer, value < 0 ? 0U - static_cast<unsigned>(value) : static_cast<unsigned>(value));
+}
+
+// append double value to text buffer, as a stream would print it
+void Simulation::appendText(std::string& buffer, const double& value) {
+    char text[32];
+    int length{std::snprintf(text, sizeof(text), "%g", value)};
+    buffer.append(text, length);
+}
+
+// append complex value to text buffer, as a stream would print it
+void Simulation::appendText(std::string& buffer, const std::complex<double>& value) {
+    char text[64];
+    int length{std::snprintf(text, sizeof(text), "(%g, %g)", value.real(), value.imag())};
+    buffer.append(text, length);
+}
+
+// draw random value of the distribution of profile
+double Simulation::drawReal(RandomStream& stream, const WorkloadProfile& profile) {
+    const double pi{3.14159265358979323846};
+    double low{profile.valueLow}, high{profile.valueHigh};
+    switch (profile.values) {
+    case ValueDistribution::NORMAL: {
+        // Box-Muller, 1 - u keeps the logarithm finite
+        double radius{std::sqrt(-2 * std::log(1 - stream.nextDouble()))};
+        return (low + high) / 2 + (high - low) / 6 * radius * std::cos(2 * pi * stream.nextDouble());
+    }
+    case ValueDistribution::EXPONENTIAL:
+        return low - (high - low) / 4 * std::log(1 - stream.nextDouble());
+    case ValueDistribution::SPIKY: {
+        double value{stream.nextReal(low, high)};
+        return stream.nextDouble() < 0.01 ? 10 * value : value;
+    }
+    default:
+        return stream.nextReal(low, high);
+    }
+}
+
+// draw random value of the distribution of profile, ints are rounded
+void Simulation::drawValue(RandomStream& stream, const WorkloadProfile& profile, int& value) {
+    value = static_cast<int>(std::lround(drawReal(stream, profile)));
+}
+void Simulation::drawValue(RandomStream& stream, const WorkloadProfile& profile, double& value) {
+    value = drawReal(stream, profile);
+}
+void Simulation::drawValue(RandomStream& stream, const WorkloadProfile& profile,
+                           std::complex<double>& value) {
+    double real{drawReal(stream, profile)};
+    value = std::complex<double>(real, drawReal(stream, profile));
+}
+
+// return number of files of every pair, shared out by popularity
+std::vector<unsigned long long> Simulation::getFileCounts(const SimulationConfig& config) {
+    std::size_t noOfPairs{static_cast<std::size_t>(config.noOfStaff) * config.noOfProjects};
+    std::vector<unsigned long long> fileCounts(noOfPairs, config.noOfFiles);
+    if (config.profile.zipfExponent <= 0) return fileCounts;
+    // popularity rank of every pair, shuffled so that Staff1 A is not always first
+    std::vector<std::size_t> pairs(noOfPairs);
+    for (std::size_t i{}; i < noOfPairs; ++i) pairs[i] = i;
+    RandomStream stream(config.seed, ~0ULL);
+    for (std::size_t i{noOfPairs - 1}; i > 0; --i) {
+        std::swap(pairs[i], pairs[static_cast<std::size_t>(stream.nextDouble() * (i + 1))]);
+    }
+    std::vector<double> weights(noOfPairs);
+    double totalWeight{};
+    for (std::size_t rank{}; rank < noOfPairs; ++rank) {
+        weights[rank] = 1 / std::pow(rank + 1.0, config.profile.zipfExponent);
+        totalWeight += weights[rank];
+    }
+    // shares rounded down, the files left over go to the largest remainders
+    unsigned long long noOfFiles{static_cast<unsigned long long>(noOfPairs) * config.noOfFiles};
+    unsigned long long noOfShared{};
+    std::vector<std::pair<double, std::size_t>> remainders(noOfPairs);
+    for (std::size_t rank{}; rank < noOfPairs; ++rank) {
+        double share{noOfFiles * weights[rank] / totalWeight};
+        fileCounts[pairs[rank]] = static_cast<unsigned long long>(share);
+        noOfShared += fileCounts[pairs[rank]];
+        remainders[rank] = std::make_pair(fileCounts[pairs[rank]] - share, rank);
+    }
+    std::sort(remainders.begin(), remainders.end());
+    for (std::size_t i{}; noOfShared < noOfFiles && i < noOfPairs; ++i, ++noOfShared) {
+        ++fileCounts[pairs[remainders[i].second]];
+    }
+    return fileCounts;
+}
+
+// return pairs holding giant projects
+std::vector<bool> Simulation::getGiants(const SimulationConfig& config) {
+    std::size_t noOfPairs{static_cast<std::size_t>(config.noOfStaff) * config.noOfProjects};
+    std::vector<bool> giants(noOfPairs, false);
+    if (config.profile.giantShare <= 0) return giants;
+    std::size_t noOfGiants{static_cast<std::size_t>(std::ceil(config.profile.giantShare * noOfPairs))};
+    if (noOfGiants > noOfPairs) noOfGiants = noOfPairs;
+    // first pairs of a shuffle
+    std::vector<std::size_t> pairs(noOfPairs);
+    for (std::size_t i{}; i < noOfPairs; ++i) pairs[i] = i;
+    RandomStream stream(config.seed, ~0ULL - 1);
+    for (std::size_t i{}; i < noOfGiants; ++i) {
+        std::swap(pairs[i], pairs[i + static_cast<std::size_t>(stream.nextDouble() * (noOfPairs - i))]);
+        giants[pairs[i]] = true;
+    }
+    return giants;
+}
+
+// fill timestamps of the next measurements of a file
+void Simulation::fillTimestamps(std::vector<unsigned>& timestamps, const unsigned& firstTimestamp,
+                                RandomStream& stream, const WorkloadProfile& profile) {
+    for (std::size_t i{}; i < timestamps.size(); ++i) timestamps[i] = firstTimestamp + static_cast<unsigned>(i);
+    if (profile.disorderShare <= 0) return;
+    unsigned size{static_cast<unsigned>(timestamps.size())};
+    unsigned length{profile.burstLength < size / 2 ? profile.burstLength : size / 2};
+    if (length == 0) return;
+    // every swap puts two bursts out of order, a fraction of a swap is
+    // made with that probability
+    double noOfSwaps{profile.disorderShare * size / (2.0 * length)};
+    unsigned noOfWholeSwaps{static_cast<unsigned>(noOfSwaps)};
+    if (stream.nextDouble() < noOfSwaps - noOfWholeSwaps) ++noOfWholeSwaps;
+    for (unsigned i{}; i < noOfWholeSwaps; ++i) {
+        // a later burst swapped with one up to three bursts before it
+        unsigned later{stream.nextUnsigned(length, size - length)};
+        unsigned earlier{later - stream.nextUnsigned(length, later < 4 * length ? later : 4 * length)};
+        std::swap_ranges(timestamps.begin() + earlier, timestamps.begin() + earlier + length,
+                         timestamps.begin() + later);
+    }
+}
+
+// check configuration and return its layout
+Simulation::Layout Simulation::getLayout(const SimulationConfig& config) {
+    const WorkloadProfile& profile = config.profile;
+    if (config.dataType != "double" && config.dataType != "int" && config.dataType != "complexdouble"
+        && config.dataType != "auto") {
+        throw std::invalid_argument("[SIMULATION] Data type '" + config.dataType + "' not supported\n");
+    }
+    if (config.noOfStaff == 0 || config.noOfProjects == 0 || config.noOfFiles == 0) {
+        throw std::invalid_argument("[SIMULATION] Numbers of staff, projects and files should be positive\n");
+    }
+    if (config.minPoints == 0 || config.minPoints > config.maxPoints) {
+        throw std::invalid_argument("[SIMULATION] Measurements per file should be 1 <= MIN <= MAX\n");
+    }
+    if (profile.zipfExponent < 0 || profile.giantShare < 0 || profile.giantShare > 1 || profile.giantFactor == 0
+        || profile.disorderShare < 0 || profile.disorderShare > 1 || profile.burstLength == 0
+        || profile.duplicateShare < 0 || profile.duplicateShare > 1 || !(profile.valueLow <= profile.valueHigh)) {
+        throw std::invalid_argument("[SIMULATION] Workload profile '" + profile.name + "' is not valid\n");
+    }
+    // most measurements of a file
+    unsigned long long stride{config.maxPoints};
+    if (profile.giantShare > 0) stride *= profile.giantFactor;
+    std::vector<unsigned long long> fileCounts{getFileCounts(config)};
+    unsigned long long maxFileCount{*std::max_element(fileCounts.begin(), fileCounts.end())};
+    if (stride > UINT_MAX || config.startTime + maxFileCount * stride > UINT_MAX) {
+        throw std::invalid_argument("[SIMULATION] Timestamps of " + std::to_string(maxFileCount)
+                                    + " files of up to " + std::to_string(stride)
+                                    + " measurements do not fit after " + std::to_string(config.startTime) + "\n");
+    }
+    Layout layout{std::vector<unsigned long long>{0}, getGiants(config)};
+    for (auto it = fileCounts.begin(); it != fileCounts.end(); ++it) {
+        layout.firstFiles.push_back(layout.firstFiles.back() + *it);
+    }
+    return layout;
+}
+
+// return file of task
+Simulation::FileTask Simulation::getTask(const SimulationConfig& config, const Layout& layout,
+                                         const std::size_t& task) {
+    std::size_t pair{static_cast<std::size_t>(
+        std::upper_bound(layout.firstFiles.begin(), layout.firstFiles.end(), task) - layout.firstFiles.begin() - 1)};
+    std::uint64_t noOfPairs{layout.giants.size()};
+    unsigned fileIndex{static_cast<unsigned>(task - layout.firstFiles[pair])};
+    std::string dataType{config.dataType};
+    if (dataType == "auto") {
+        // every pair keeps its type over all of its files
+        const char* types[]{"int", "double", "complexdouble"};
+        dataType = types[pair % 3];
+    }
+    // random stream of file n of pair, the same for any popularity
+    return FileTask{fileIndex * noOfPairs + pair, fileIndex,
+                    getStaffName(static_cast<unsigned>(pair / config.noOfProjects)),
+                    getProjectName(static_cast<unsigned>(pair % config.noOfProjects)),
+                    dataType, layout.giants[pair]};
+}
+
+// output of drawFile writing a data file and its duplicate
+template <typename T> class Simulation::FileOutput {
+private:
+    const SimulationConfig& config;
+    std::string& buffer;
+    Progress& progress;
+    std::vector<std::string> fileNames;
+    std::vector<std::ofstream> outFiles;
+
+    // write buffer to every file and empty it
+    void flush() {
+        for (std::size_t i{}; i < outFiles.size(); ++i) {
+            if (!outFiles[i].write(buffer.data(), buffer.size())) {
+                throw std::runtime_error("[SIMULATION] Exception writing file '" + fileNames[i] + "'\n");
+            }
+            progress.noOfBytes += buffer.size();
+        }
+        buffer.clear();
+    }
+
+public:
+    // parametrised constructor - buffer is reused between files of a thread
+    FileOutput(const SimulationConfig& userConfig, std::string& userBuffer, Progress& userProgress)
+              : config(userConfig), buffer(userBuffer), progress(userProgress) {}
+
+    // open file and its duplicate and start them with their header
+    void begin(const FileTask& file, const unsigned& noOfPoints, const bool& duplicate) {
+        bool binary{config.format == SimulationFormat::BINARY};
+        std::string extension{binary ? ".bin" : ".txt"};
+        std::string fileName{joinPath(config.outputPath, file.staffName + "_" + file.projectName
+                                                              + std::to_string(file.fileIndex))};
+        fileNames.push_back(fileName + extension);
+        // a duplicate holds the same measurements under another name
+        if (duplicate) fileNames.push_back(fileName + "_copy" + extension);
+        for (auto it = fileNames.begin(); it != fileNames.end(); ++it) {
+            outFiles.emplace_back(*it, std::ios::binary);
+            if (!outFiles.back().is_open()) {
+                throw std::runtime_error("[SIMULATION] Exception opening file '" + *it + "'\n");
+            }
+        }
+        // a failed file leaves the buffer of its thread half filled
+        buffer.clear();
+        if (binary) {
+            BinaryFormat::appendHeader<T>(buffer, file.staffName, file.projectName, noOfPoints);
+        } else {
+            buffer.append("Staff: " + file.staffName + "\nProject: " + file.projectName
+                          + "\n-----------------------------\n");
+        }
+    }
+
+    // append measurement
+    void add(const unsigned& timestamp, const T& value) {
+        if (config.format == SimulationFormat::BINARY) {
+            BinaryFormat::append(buffer, static_cast<std::uint32_t>(timestamp));
+            BinaryFormat::appendValue(buffer, value);
+        } else {
+            appendText(buffer, timestamp);
+            buffer.push_back(' ');
+            appendText(buffer, value);
+            buffer.push_back('\n');
+        }
+        if (buffer.size() >= (1 << 20)) this->flush();
+    }
+
+    // make the measurements so far visible, while throttled
+    void sync() {
+        this->flush();
+        for (auto& outFile : outFiles) outFile.flush();
+    }
+
+    // write the rest and close the files
+    void end() {
+        this->flush();
+        for (std::size_t i{}; i < outFiles.size(); ++i) {
+            outFiles[i].close();
+            if (!outFiles[i]) throw std::runtime_error("[SIMULATION] Exception closing file '" + fileNames[i] + "'\n");
+        }
+        progress.noOfFiles += outFiles.size();
+        progress.noOfDuplicates += outFiles.size() - 1;
+    }
+};
+
+// output of drawFile building an experiment and its duplicate
+template <typename T> class Simulation::ExperimentOutput {
+private:
+    std::vector<Experiment<T>>& experiments;
+    Progress& progress;
+    bool duplicate;
+
+public:
+    // parametrised constructor
+    ExperimentOutput(std::vector<Experiment<T>>& userExperiments, Progress& userProgress)
+                    : experiments(userExperiments), progress(userProgress), duplicate{false} {}
+
+    // start experiment of file
+    void begin(const FileTask& file, const unsigned&, const bool& userDuplicate) {
+        experiments.push_back(Experiment<T>(HeaderLine(file.staffName), HeaderLine(file.projectName)));
+        duplicate = userDuplicate;
+    }
+
+    // append measurement
+    void add(const unsigned& timestamp, const T& value) {
+        experiments.back().addMeasurement(timestamp, value);
+    }
+
+    // measurements are seen once the experiment is inserted
+    void sync() {}
+
+    // sort measurements, as reading the file would, and copy the duplicate
+    void end() {
+        experiments.back().sortMeasurements();
+        if (duplicate) experiments.push_back(experiments.back());
+        progress.noOfFiles += experiments.size();
+        progress.noOfDuplicates += experiments.size() - 1;
+    }
+};
+
+// draw the measurements of file of type T and hand them to output
+template <typename T, typename Output> void Simulation::drawFile(const SimulationConfig& config,
+                                                                 const FileTask& file, Output& output,
+                                                                 Progress& progress) {
+    const std::size_t chunkSize{4096};
+    const WorkloadProfile& profile = config.profile;
+    RandomStream stream(config.seed, file.fileNo);
+    unsigned noOfPoints{stream.nextUnsigned(config.minPoints, config.maxPoints)};
+    unsigned stride{config.maxPoints};
+    if (profile.giantShare > 0) stride *= profile.giantFactor;
+    if (file.giant) noOfPoints *= profile.giantFactor;
+    bool duplicate{profile.duplicateShare > 0 && stream.nextDouble() < profile.duplicateShare};
+    output.begin(file, noOfPoints, duplicate);
+    // files of a pair hold consecutive, non-overlapping timestamps
+    unsigned firstTimestamp{config.startTime + file.fileIndex * stride};
+    std::vector<unsigned> timestamps;
+    T value;
+    for (unsigned i{}; i < noOfPoints; i += static_cast<unsigned>(timestamps.size())) {
+        timestamps.resize(noOfPoints - i < chunkSize ? noOfPoints - i : chunkSize);
+        fillTimestamps(timestamps, firstTimestamp + i, stream, profile);
+        for (auto it = timestamps.begin(); it != timestamps.end(); ++it) {
+            drawValue(stream, profile, value);
+            output.add(*it, value);
+            if (config.pointsPerSecond > 0) {
+                output.sync();
+                // wait until the measurements drawn so far by all threads are due
+                unsigned long long noOfDrawn{++progress.noOfPoints};
+                std::this_thread::sleep_until(progress.start
+                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(noOfDrawn / config.pointsPerSecond)));
+            }
+        }
+    }
+    if (config.pointsPerSecond <= 0) progress.noOfPoints += noOfPoints;
+    output.end();
+}
+
+// write file of type T
+template <typename T> void Simulation::writeFile(const SimulationConfig& config, const FileTask& file,
+                                                 std::string& buffer, Progress& progress) {
+    FileOutput<T> output(config, buffer, progress);
+    drawFile<T>(config, file, output, progress);
+}
+
+// generate experiments of file of type T
+template <typename T> void Simulation::simulateFile(const SimulationConfig& config, const FileTask& file,
+                                                    SimulatedFile& experiments, Progress& progress) {
+    ExperimentOutput<T> output(getExperiments(experiments, T()), progress);
+    drawFile<T>(config, file, output, progress);
+}
+
+// return experiments of type T
+std::vector<Experiment<int>>& Simulation::getExperiments(SimulatedFile& experiments, const int&) {
+    return experiments.intExperiments;
+}
+std::vector<Experiment<double>>& Simulation::getExperiments(SimulatedFile& experiments, const double&) {
+    return experiments.doubleExperiments;
+}
+std::vector<Experiment<std::complex<double>>>& Simulation::getExperiments(SimulatedFile& experiments,
+                                                                          const std::complex<double>&) {
+    return experiments.complexExperiments;
+}
+
+// insert experiments of files in file order, a batch at a time
+template <template <typename> class Data, typename T> void Simulation::insertFiles(Data<T>& data,
+                                                                                   std::vector<SimulatedFile>& files) {
+    std::vector<Experiment<T>> batch;
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        std::vector<Experiment<T>>& experiments = getExperiments(*it, T());
+        std::move(experiments.begin(), experiments.end(), std::back_inserter(batch));
+    }
+    data.insertExperiments(std::move(batch));
+}
+void Simulation::insertFiles(MixedDataManager& data, std::vector<SimulatedFile>& files) {
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        // a file holds experiments of one type
+        for (auto& experiment : it->intExperiments) data.insertExperiment(std::move(experiment));
+        for (auto& experiment : it->doubleExperiments) data.insertExperiment(std::move(experiment));
+        for (auto& experiment : it->complexExperiments) data.insertExperiment(std::move(experiment));
+    }
+}
+
+// write files of configuration
+SimulationStats Simulation::generate(const SimulationConfig& config) {
+    Layout layout{getLayout(config)};
+    ScreenMsg::print("[SIMULATION] Simulating data...\n");
+    Progress progress;
+    progress.noOfFiles = 0;
+    progress.noOfDuplicates = 0;
+    progress.noOfPoints = 0;
+    progress.noOfBytes = 0;
+    progress.start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(config.noOfThreads);
+    pool.parallelFor(layout.firstFiles.back(), [&](std::size_t task) {
+        // every thread keeps its buffer between files
+        static thread_local std::string buffer;
+        FileTask file{getTask(config, layout, task)};
+        if (file.dataType == "int") writeFile<int>(config, file, buffer, progress);
+        else if (file.dataType == "double") writeFile<double>(config, file, buffer, progress);
+        else writeFile<std::complex<double>>(config, file, buffer, progress);
+    });
+    double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - progress.start).count()};
+    return SimulationStats{static_cast<unsigned>(pool.getNoOfThreads()), progress.noOfFiles.load(),
+                           progress.noOfDuplicates.load(), progress.noOfPoints.load(),
+                           progress.noOfBytes.load(), seconds};
+}
+
+// generate experiments of configuration into data: producer threads draw
+// the experiments of files and pass them through an IngestQueue to the
+// calling thread, which alone touches the data and inserts them in file
+// order, as DataInput::readFromFileQueued does
+template <typename Data> SimulationStats Simulation::generateExperiments(const SimulationConfig& config,
+                                                                         Data& data, const bool& writeFiles) {
+    Layout layout{getLayout(config)};
+    // the files are written from the same random streams
+    std::thread writer;
+    std::exception_ptr writerException;
+    SimulationStats writerStats{0, 0, 0, 0, 0, 0};
+    if (writeFiles) {
+        writer = std::thread([&]() {
+            try {
+                writerStats = generate(config);
+            }
+            catch (...) {
+                writerException = std::current_exception();
+            }
+        });
+    }
+    ScreenMsg::print("[SIMULATION] Simulating data into memory...\n");
+    Progress progress;
+    progress.noOfFiles = 0;
+    progress.noOfDuplicates = 0;
+    progress.noOfPoints = 0;
+    progress.noOfBytes = 0;
+    progress.start = std::chrono::steady_clock::now();
+    // file task travels with its experiments
+    typedef std::pair<std::size_t, SimulatedFile> IngestItem;
+    IngestQueue<IngestItem> queue;
+    std::size_t noOfTasks{static_cast<std::size_t>(layout.firstFiles.back())};
+    unsigned noOfProducers{config.noOfThreads > 0 ? config.noOfThreads : 1};
+    std::atomic<std::size_t> nextTask{0};
+    std::atomic<unsigned> noOfRunning{noOfProducers};
+    std::exception_ptr producerException;
+    std::mutex exceptionMutex;
+    std::vector<std::thread> producers;
+    for (unsigned p{}; p < noOfProducers; ++p) {
+        producers.push_back(std::thread([&]() {
+            for (std::size_t i{nextTask++}; i < noOfTasks; i = nextTask++) {
+                SimulatedFile experiments;
+                try {
+                    FileTask file{getTask(config, layout, i)};
+                    if (file.dataType == "int") simulateFile<int>(config, file, experiments, progress);
+                    else if (file.dataType == "double") simulateFile<double>(config, file, experiments, progress);
+                    else simulateFile<std::complex<double>>(config, file, experiments, progress);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!producerException) producerException = std::current_exception();
+                }
+                // an empty item keeps the file order going
+                queue.push(IngestItem(i, std::move(experiments)));
+            }
+            if (--noOfRunning == 0) queue.close();
+        }));
+    }
+    // files which arrived ahead of an earlier one
+    std::map<std::size_t, SimulatedFile> pending;
+    std::size_t nextInsert{};
+    while (!queue.isDone()) {
+        std::size_t drained{queue.drain([&](std::vector<IngestItem>& items) {
+            for (auto it = items.begin(); it != items.end(); ++it) {
+                pending.insert(std::make_pair(it->first, std::move(it->second)));
+            }
+            std::vector<SimulatedFile> batch;
+            for (auto it = pending.begin(); it != pending.end() && it->first == nextInsert; it = pending.erase(it)) {
+                batch.push_back(std::move(it->second));
+                ++nextInsert;
+            }
+            insertFiles(data, batch);
+        })};
+        if (drained == 0) std::this_thread::yield();
+    }
+    for (auto it = producers.begin(); it != producers.end(); ++it) it->join();
+    double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - progress.start).count()};
+    if (writer.joinable()) writer.join();
+    if (producerException) std::rethrow_exception(producerException);
+    if (writerException) std::rethrow_exception(writerException);
+    // bytes are those written to disk
+    return SimulationStats{noOfProducers, progress.noOfFiles.load(), progress.noOfDuplicates.load(),
+                           progress.noOfPoints.load(), writerStats.noOfBytes, seconds};
+}
+
+// check that data type of configuration is the type of a dataset
+void Simulation::checkDataType(const SimulationConfig& config, const std::string& dataType) {
+    if (config.dataType != dataType) {
+        throw std::invalid_argument("[SIMULATION] Data type '" + config.dataType
+                                    + "' cannot be generated into a dataset of " + dataType + "\n");
+    }
+}
+
+// generate experiments of configuration straight into data
+SimulationStats Simulation::generateInto(const SimulationConfig& config, DataManager<int>& data,
+                                         const bool& writeFiles) {
+    checkDataType(config, "int");
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config, DataManager<double>& data,
+                                         const bool& writeFiles) {
+    checkDataType(config, "double");
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config,
+                                         DataManager<std::complex<double>>& data, const bool& writeFiles) {
+    checkDataType(config, "complexdouble");
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config, MixedDataManager& data,
+                                         const bool& writeFiles) {
+    // projects of every type
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config, ShardedDataManager<int>& data,
+                                         const bool& writeFiles) {
+    checkDataType(config, "int");
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config, ShardedDataManager<double>& data,
+                                         const bool& writeFiles) {
+    checkDataType(config, "double");
+    return generateExperiments(config, data, writeFiles);
+}
+SimulationStats Simulation::generateInto(const SimulationConfig& config,
+                                         ShardedDataManager<std::complex<double>>& data, const bool& writeFiles) {
+    checkDataType(config, "complexdouble");
+    return generateExperiments(config, data, writeFiles);
+}
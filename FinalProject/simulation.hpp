@@ -3,17 +3,309 @@
 
 #include <iostream> // std
 #include <sstream>  // stringstream
-#include <random>   // random number generator
+#include <random>   // random_device
 #include <thread>   // sleeping thread
+#include <chrono>   // steady_clock
 #include <ctime>    // time
 #include <vector>   // vector
+#include <string>   // string
+#include <cstdint>  // fixed width integers
+#include <complex>  // complex numbers
+#include <atomic>   // atomic
+#include <fstream>  // ofstream
 
-#include "msg.hpp"  // classes managing outputs
+#include "msg.hpp"              // classes managing outputs
+#include "maps.hpp"             // classes managing databases
+#include "mixedDataManager.hpp" // dataset of int, double and complex series
+#include "shardedDataManager.hpp" // dataset for concurrent inserts
+#include "threadPool.hpp"       // threads generating files
 
+/* ------------------------------------------------------------------------
+* COUNTER-BASED RANDOM NUMBER STREAM
+* -----------------------------------------------------------------------*/
+
+// Random numbers of one stream, the i-th being a hash of the stream key and
+// i (the SplitMix64 output function). Streams keyed by a seed and a stream
+// number are independent of each other and of the order they are drawn in,
+// so every generated file gets its own stream and comes out the same
+// whichever thread writes it. Ranges are mapped without the standard
+// distributions, whose results differ between libraries.
+class RandomStream {
+private:
+    std::uint64_t key;
+    std::uint64_t counter;
+
+    // SplitMix64 output function
+    static std::uint64_t mix(std::uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+public:
+    // parametrised constructor - stream number of a seed
+    RandomStream(const std::uint64_t& seed, const std::uint64_t& streamNo)
+                : key{mix(mix(seed) ^ (streamNo * 0x9e3779b97f4a7c15ULL + 0x632be59bd9b4e019ULL))}, counter{} {}
+
+    // return next 64 random bits
+    std::uint64_t next() { return mix(key + 0x9e3779b97f4a7c15ULL * ++counter); }
+    // return next value uniform in [0, 1)
+    double nextDouble() { return (this->next() >> 11) * (1.0 / 9007199254740992.0); }
+    // return next value uniform in [low, high]
+    unsigned nextUnsigned(const unsigned& low, const unsigned& high) {
+        unsigned long long range{static_cast<unsigned long long>(high) - low + 1};
+        return low + static_cast<unsigned>((this->next() >> 32) * range >> 32);
+    }
+    // return next value uniform in [low, high)
+    double nextReal(const double& low, const double& high) { return low + (high - low) * this->nextDouble(); }
+};
+
+/* ------------------------------------------------------------------------
+* SIMULATION CONFIGURATION AND STATISTICS
+* -----------------------------------------------------------------------*/
+
+// format of generated data files
+enum class SimulationFormat { TEXT, BINARY };
+
+// distribution of generated values over [valueLow, valueHigh]: UNIFORM;
+// NORMAL around the middle with a sixth of the range as standard
+// deviation; EXPONENTIAL from valueLow with a quarter of the range as mean
+// and a long tail beyond valueHigh; SPIKY uniform with one value in a
+// hundred ten times as high
+enum class ValueDistribution { UNIFORM, NORMAL, EXPONENTIAL, SPIKY };
+
+// shape of a generated workload, so that ingest, merge and report paths
+// can be run against realistic worst cases
+struct WorkloadProfile {
+    std::string name;
+    // Zipf exponent of project popularity: files of all projects are
+    // shared out in proportion to 1 / rank^zipfExponent, so that a few
+    // projects get most of them and some none; 0 gives every project the
+    // same number
+    double zipfExponent;
+    // share of projects whose files hold giantFactor times more
+    // measurements, at least one project if the share is above 0
+    double giantShare;
+    unsigned giantFactor;
+    // share of measurements written out of timestamp order, in bursts of
+    // burstLength swapped with an earlier block of the same file
+    double disorderShare;
+    unsigned burstLength;
+    // share of files written a second time under another name
+    double duplicateShare;
+    ValueDistribution values;
+    double valueLow;
+    double valueHigh;
+
+    // return profile of name: uniform, skewed, giant, bursty, duplicates or
+    // realistic, which combines them; throws invalid_argument otherwise
+    static WorkloadProfile get(const std::string& name);
+    // return value distribution of name, e.g. "normal"
+    static ValueDistribution getValueDistribution(const std::string& name);
+};
+
+// what the load generator writes
+struct SimulationConfig {
+    // double, int, complexdouble or auto, which takes the three types in
+    // turn over the staff and project pairs
+    std::string dataType;
+    // existing directory the files are written to
+    std::string outputPath;
+    // staff members, projects of every staff member and files of every pair
+    unsigned noOfStaff;
+    unsigned noOfProjects;
+    unsigned noOfFiles;
+    // measurements per file, drawn uniformly from [minPoints, maxPoints]
+    // and multiplied for giant projects
+    unsigned minPoints;
+    unsigned maxPoints;
+    WorkloadProfile profile;
+    // measurements written per second, 0 writes as fast as possible
+    double pointsPerSecond;
+    // same seed and configuration give the same files
+    std::uint64_t seed;
+    SimulationFormat format;
+    // threads writing files, the files do not depend on it
+    unsigned noOfThreads;
+    // first timestamp; file n of a pair holds timestamps from
+    // startTime + n * (most measurements of a file) on
+    unsigned startTime;
+
+    // default constructor - 2 staff members, 2 projects, 1 file of 5-10
+    // doubles of the uniform profile from timestamp 1462033286 on, seed 0,
+    // one thread per core
+    SimulationConfig();
+};
+
+// what the load generator wrote
+struct SimulationStats {
+    unsigned noOfThreads;
+    unsigned long long noOfFiles;
+    unsigned long long noOfDuplicates;
+    unsigned long long noOfPoints;
+    unsigned long long noOfBytes;
+    double seconds;
+
+    // return statistics table
+    std::string show() const;
+};
+
+/* ------------------------------------------------------------------------
+* CLASS SIMULATING INPUT DATA
+* -----------------------------------------------------------------------*/
+
+// Load generator writing data files of any number of staff members,
+// projects, files and measurements, as text or binary, or handing the same
+// experiments straight to a dataset. Files are shared out over a pool of
+// threads, each drawing from the random stream of its file, so the same
+// seed gives the same files for any number of threads. A file is built in
+// a buffer that goes to disk a megabyte at a time, values are formatted
+// without streams, and the generator only sleeps to keep a requested rate.
 class Simulation {
+private:
+    // counters shared by the threads generating files
+    struct Progress {
+        std::atomic<unsigned long long> noOfFiles;
+        std::atomic<unsigned long long> noOfDuplicates;
+        std::atomic<unsigned long long> noOfPoints;
+        std::atomic<unsigned long long> noOfBytes;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // files of a configuration: files of pair p are tasks firstFiles[p] to
+    // firstFiles[p + 1] - 1
+    struct Layout {
+        std::vector<unsigned long long> firstFiles;
+        std::vector<bool> giants;
+    };
+
+    // one file of a layout
+    struct FileTask {
+        // number of its random stream
+        std::uint64_t fileNo;
+        // file number within its pair
+        unsigned fileIndex;
+        std::string staffName;
+        std::string projectName;
+        std::string dataType;
+        bool giant;
+    };
+
+    // experiments of one file generated in memory, the file and its duplicate
+    struct SimulatedFile {
+        std::vector<Experiment<int>> intExperiments;
+        std::vector<Experiment<double>> doubleExperiments;
+        std::vector<Experiment<std::complex<double>>> complexExperiments;
+    };
+
+    // output of drawFile writing a data file and its duplicate
+    template <typename T> class FileOutput;
+    // output of drawFile building an experiment and its duplicate
+    template <typename T> class ExperimentOutput;
+
+    // return name of staff member or project of index, e.g. "Staff1", "AB"
+    static std::string getStaffName(const unsigned& index);
+    static std::string getProjectName(const unsigned& index);
+    // append value to text buffer
+    static void appendText(std::string& buffer, const unsigned& value);
+    static void appendText(std::string& buffer, const int& value);
+    static void appendText(std::string& buffer, const double& value);
+    static void appendText(std::string& buffer, const std::complex<double>& value);
+    // draw random value of the distribution of profile
+    static double drawReal(RandomStream& stream, const WorkloadProfile& profile);
+    static void drawValue(RandomStream& stream, const WorkloadProfile& profile, int& value);
+    static void drawValue(RandomStream& stream, const WorkloadProfile& profile, double& value);
+    static void drawValue(RandomStream& stream, const WorkloadProfile& profile, std::complex<double>& value);
+    // return number of files of every pair, shared out by popularity
+    static std::vector<unsigned long long> getFileCounts(const SimulationConfig& config);
+    // return pairs holding giant projects
+    static std::vector<bool> getGiants(const SimulationConfig& config);
+    // check configuration and return its layout, throws invalid_argument
+    // if it cannot be generated
+    static Layout getLayout(const SimulationConfig& config);
+    // return file of task
+    static FileTask getTask(const SimulationConfig& config, const Layout& layout, const std::size_t& task);
+    // fill timestamps of the next measurements of a file, swapping bursts
+    // of them out of order
+    static void fillTimestamps(std::vector<unsigned>& timestamps, const unsigned& firstTimestamp,
+                               RandomStream& stream, const WorkloadProfile& profile);
+    // draw the measurements of file of type T and hand them to output
+    template <typename T, typename Output> static void drawFile(const SimulationConfig& config,
+                                                                const FileTask& file, Output& output,
+                                                                Progress& progress);
+    // write file of type T; buffer is reused between files of a thread
+    template <typename T> static void writeFile(const SimulationConfig& config, const FileTask& file,
+                                                std::string& buffer, Progress& progress);
+    // generate experiments of file of type T
+    template <typename T> static void simulateFile(const SimulationConfig& config, const FileTask& file,
+                                                   SimulatedFile& experiments, Progress& progress);
+    // return experiments of type T
+    static std::vector<Experiment<int>>& getExperiments(SimulatedFile& experiments, const int&);
+    static std::vector<Experiment<double>>& getExperiments(SimulatedFile& experiments, const double&);
+    static std::vector<Experiment<std::complex<double>>>& getExperiments(SimulatedFile& experiments,
+                                                                        const std::complex<double>&);
+    // insert experiments of files in file order, Data is a DataManager or
+    // a ShardedDataManager
+    template <template <typename> class Data, typename T> static void insertFiles(Data<T>& data,
+                                                                                 std::vector<SimulatedFile>& files);
+    static void insertFiles(MixedDataManager& data, std::vector<SimulatedFile>& files);
+    // generate experiments of configuration into data, Data is a
+    // DataManager, a MixedDataManager or a ShardedDataManager
+    template <typename Data> static SimulationStats generateExperiments(const SimulationConfig& config,
+                                                                        Data& data, const bool& writeFiles);
+    // check that data type of configuration is the type of a dataset
+    static void checkDataType(const SimulationConfig& config, const std::string& dataType);
+
 public:
-    // generate simulation data
-	static void simulateData(const std::string& dataHeroPath, const unsigned& noOfFiles, const std::string& dataType);
+    // write files of configuration, throws invalid_argument if it cannot be
+    // generated and runtime_error if a file cannot be written
+    static SimulationStats generate(const SimulationConfig& config);
+    // generate the experiments the files of configuration hold straight
+    // into data, in file order, values unrounded by text; if writeFiles,
+    // another thread writes the files meanwhile. Throws as generate does,
+    // and invalid_argument if data has another type
+    static SimulationStats generateInto(const SimulationConfig& config, DataManager<int>& data,
+                                        const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config, DataManager<double>& data,
+                                        const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config,
+                                        DataManager<std::complex<double>>& data, const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config, MixedDataManager& data,
+                                        const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config, ShardedDataManager<int>& data,
+                                        const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config, ShardedDataManager<double>& data,
+                                        const bool& writeFiles);
+    static SimulationStats generateInto(const SimulationConfig& config,
+                                        ShardedDataManager<std::complex<double>>& data, const bool& writeFiles);
+    // generate simulation data of 2 staff members and 2 projects into data
+    // and write it to 'sim_<dataType>' in the background, returns false if
+    // it could not be generated
+    template <typename T> static bool simulateData(DataManager<T>& data, const std::string& dataHeroPath,
+                                                   const unsigned& noOfFiles, const std::string& dataType);
 };
 
-#endif /* SIMULATION_HPP */
\ No newline at end of file
+/* ------------------------------------------------------------------------
+* DEFINE SIMULATION TEMPLATE FUNCTIONS
+* -----------------------------------------------------------------------*/
+
+// generate simulation data into data
+template <typename T> bool Simulation::simulateData(DataManager<T>& data, const std::string& dataHeroPath,
+                                                    const unsigned& noOfFiles, const std::string& dataType) {
+    SimulationConfig config;
+    config.dataType = dataType;
+    config.outputPath = dataHeroPath + "sim_" + dataType;
+    config.noOfFiles = noOfFiles;
+    config.seed = std::random_device{}();
+    config.startTime = static_cast<unsigned>(std::time(NULL));
+    try {
+        ScreenMsg::print(generateInto(config, data, true).show());
+    }
+    catch (const std::exception& e) {
+        ErrorMsg::print(e.what());
+        return false;
+    }
+    return true;
+}
+
+#endif /* SIMULATION_HPP */
@@ -0,0 +1,472 @@
+#ifndef SNAPSHOT_DATA_MANAGER_HPP
+#define SNAPSHOT_DATA_MANAGER_HPP
+
+#include <iostream>  // std
+#include <string>    // string
+#include <vector>    // vector
+#include <list>      // list
+#include <sstream>   // stringstream
+#include <iomanip>   // setprecision
+#include <utility>   // pair, move
+#include <memory>    // unique pointer
+#include <thread>    // thread, sleep_for
+#include <mutex>     // mutex, lock_guard
+#include <atomic>    // atomic
+#include <chrono>    // steady_clock
+#include <set>       // set
+#include <algorithm> // find
+
+#include "msg.hpp"           // classes managing outputs
+#include "maps.hpp"          // classes managing databases
+#include "frozenDb.hpp"      // table layout of project data
+#include "persistentMap.hpp" // maps sharing unchanged entries between snapshots
+#include "epochManager.hpp"  // safe reclamation of shared snapshots
+
+/* ------------------------------------------------------------------------
+* SNAPSHOT DATABASE CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// Immutable view of a DataManager published by SnapshotDataManager. Its
+// maps are persistent, so the view after a write shares every entry but
+// the written one with the view before it. Reference databases map a name
+// to the names paired with it in the order the pairs were first inserted,
+// same as ProjectReferenceDb, and pairs whose project was deleted expire.
+// Const functions neither change the view nor touch reference counts, so
+// a published view can be read from many threads.
+template <typename T> class SnapshotDb {
+private:
+    using NameList = std::vector<std::string>;
+    using ReferenceMap = PersistentMap<std::string, std::shared_ptr<const NameList>>;
+    PersistentMap<ProjectDbKeyType, ProjectSharedPtr<T>> projects;
+    ReferenceMap staffReference;
+    ReferenceMap projectReference;
+
+    // add value to the names paired with key unless it is there already
+    static void addReference(ReferenceMap& reference, const std::string& key, const std::string& value) {
+        const std::shared_ptr<const NameList>* names{reference.find(key)};
+        if (names && std::find((*names)->begin(), (*names)->end(), value) != (*names)->end()) return;
+        std::shared_ptr<NameList> changed{names ? std::make_shared<NameList>(**names) : std::make_shared<NameList>()};
+        changed->push_back(value);
+        reference.insert(key, changed);
+    }
+
+    // return project of a pair, nullptr if it does not exist
+    const Project<T>* getProject(const std::string& staffName, const std::string& projectName) const {
+        const ProjectSharedPtr<T>* project{projects.find(std::make_pair(staffName, projectName))};
+        return project ? project->get() : nullptr;
+    }
+
+    // return project of the pair of a reference entry
+    const Project<T>* getProject(const std::string& name, const std::string& entryName,
+                                 const bool& projectFirst) const {
+        return projectFirst ? this->getProject(entryName, name) : this->getProject(name, entryName);
+    }
+
+    // call function(project) for every existing project covered by query,
+    // in the order they are printed
+    template <typename Function> void forEachProject(const QueryKey& query, Function function) const {
+        if (query.scope == QueryScope::ALL) {
+            projects.forEach([&function](const ProjectDbKeyType&, const ProjectSharedPtr<T>& project) {
+                function(*project);
+            });
+            return;
+        }
+        if (query.scope == QueryScope::PAIR) {
+            const Project<T>* project{this->getProject(query.staffName, query.projectName)};
+            if (project) function(*project);
+            return;
+        }
+        bool projectFirst{query.scope == QueryScope::PROJECT};
+        const std::string& name = projectFirst ? query.projectName : query.staffName;
+        const std::shared_ptr<const NameList>* names{(projectFirst ? projectReference : staffReference).find(name)};
+        if (!names) return;
+        for (auto it = (*names)->begin(); it != (*names)->end(); ++it) {
+            const Project<T>* project{this->getProject(name, *it, projectFirst)};
+            if (project) function(*project);
+        }
+    }
+
+    // return measurements of a project, optionally only within time range
+    static std::list<Measurement<T>> getMeasurements(const Project<T>& project, const TimeRange& range) {
+        if (range.isRange) return project.getMeasurements(range.startTime, range.endTime);
+        return project.getMeasurements();
+    }
+
+    // return data of a name in a reference database, same as
+    // ProjectReferenceDb::show
+    std::string showReference(const std::string& name, const TimeRange& range, const bool& projectFirst) const {
+        const std::string keys{projectFirst ? "Project" : "Staff"};
+        const std::string values{projectFirst ? "Staff" : "Project"};
+        const std::shared_ptr<const NameList>* names{(projectFirst ? projectReference : staffReference).find(name)};
+        if (!names) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        std::ostringstream stringStream;
+        for (auto it = (*names)->begin(); it != (*names)->end(); ++it) {
+            const Project<T>* project{this->getProject(name, *it, projectFirst)};
+            if (!project) {
+                if (range.isRange) continue;
+                stringStream << FrozenDb<T>::showProject(keys, name, values, *it, std::list<Measurement<T>>{})
+                             << "[PROJECT-REF-DB] Data has expired!" << std::endl;
+                continue;
+            }
+            std::list<Measurement<T>> measurements{getMeasurements(*project, range)};
+            if (range.isRange && measurements.empty()) continue;
+            stringStream << FrozenDb<T>::showProject(keys, name, values, *it, measurements) << std::endl;
+        }
+        return stringStream.str();
+    }
+
+public:
+    // add projects given in staff/project order together with the (key,
+    // value) pairs of the staff and project reference databases in
+    // database order
+    void build(const std::vector<ProjectSharedPtr<T>>& userProjects,
+               const std::vector<std::pair<std::string, std::string>>& staffEntries,
+               const std::vector<std::pair<std::string, std::string>>& projectEntries) {
+        for (auto it = userProjects.begin(); it != userProjects.end(); ++it) {
+            projects.insert(std::make_pair((*it).get()->getStaffName(), (*it).get()->getProjectName()), *it);
+        }
+        for (auto it = staffEntries.begin(); it != staffEntries.end(); ++it) {
+            addReference(staffReference, it->first, it->second);
+        }
+        for (auto it = projectEntries.begin(); it != projectEntries.end(); ++it) {
+            addReference(projectReference, it->first, it->second);
+        }
+    }
+
+    // set project of a pair, a new pair is added to the reference databases
+    void setProject(const std::string& staffName, const std::string& projectName,
+                    const ProjectSharedPtr<T>& project) {
+        if (!this->getProject(staffName, projectName)) {
+            addReference(staffReference, staffName, projectName);
+            addReference(projectReference, projectName, staffName);
+        }
+        projects.insert(std::make_pair(staffName, projectName), project);
+    }
+
+    // remove project of a pair, references to it expire
+    void eraseProject(const std::string& staffName, const std::string& projectName) {
+        projects.erase(std::make_pair(staffName, projectName));
+    }
+
+    // return staff and project names of existing projects
+    std::vector<std::pair<std::string, std::string>> getPairs() const {
+        std::vector<std::pair<std::string, std::string>> pairs;
+        pairs.reserve(projects.getSize());
+        projects.forEach([&pairs](const ProjectDbKeyType& key, const ProjectSharedPtr<T>&) {
+            pairs.push_back(key);
+        });
+        return pairs;
+    }
+
+    // return data view of query, same as the show functions of the
+    // mutable databases
+    std::string show(const QueryKey& query) const {
+        std::ostringstream stringStream;
+        switch (query.scope) {
+        case QueryScope::ALL:
+            this->forEachProject(query, [&stringStream, &query](const Project<T>& project) {
+                std::list<Measurement<T>> measurements{getMeasurements(project, query.range)};
+                if (query.range.isRange && measurements.empty()) return;
+                stringStream << FrozenDb<T>::showProject("Staff", project.getStaffName(),
+                                                         "Project", project.getProjectName(), measurements);
+            });
+            return stringStream.str();
+        case QueryScope::STAFF:
+            return this->showReference(query.staffName, query.range, false);
+        case QueryScope::PROJECT:
+            return this->showReference(query.projectName, query.range, true);
+        default:
+            const Project<T>* project{this->getProject(query.staffName, query.projectName)};
+            if (!project) {
+                ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+                return "";
+            }
+            std::list<Measurement<T>> measurements{getMeasurements(*project, query.range)};
+            if (query.range.isRange && measurements.empty()) return "";
+            return FrozenDb<T>::showProject("Staff", query.staffName, "Project", query.projectName, measurements);
+        }
+    }
+
+    // return report of query, same as the report functions of the mutable
+    // databases
+    std::string getReport(const QueryKey& query) const {
+        if (query.scope == QueryScope::PAIR && !this->getProject(query.staffName, query.projectName)) {
+            ErrorMsg::print("\n[PROJECT-DB] Data does not exist!\n");
+            return "";
+        }
+        if ((query.scope == QueryScope::STAFF && !staffReference.find(query.staffName))
+            || (query.scope == QueryScope::PROJECT && !projectReference.find(query.projectName))) {
+            ErrorMsg::print("\n[PROJECT-REF-DB] No entry found!\n");
+            return "";
+        }
+        std::ostringstream stringStream;
+        this->forEachProject(query, [&stringStream, &query](const Project<T>& project) {
+            if (query.range.isRange) stringStream << project.getReport(query.range.startTime, query.range.endTime);
+            else stringStream << project.getReport();
+        });
+        return stringStream.str();
+    }
+};
+
+/* ------------------------------------------------------------------------
+* SNAPSHOT DATA MANAGER CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// DataManager that can be read by many threads while other threads insert
+// and delete. Writers take turns on a private DataManager whose projects
+// are copied before they change if a snapshot holds them, and publish an
+// immutable SnapshotDb of the result after every write. Readers pin an
+// epoch and read the snapshot published at that moment without taking
+// any lock, so every query through one ReadSnapshot sees the same data.
+// Replaced snapshots are freed by writers once no reader can see them.
+// A snapshot shares everything but the written projects with the one
+// before it, so a write costs O(log N) plus compacting the written
+// projects; insertExperiments also publishes once per batch. Experiments
+// handed to writers must not allocate from the arena of another
+// DataManager, since arenas are not thread-safe.
+template <typename T> class SnapshotDataManager {
+private:
+    // writers take turns on the data, the next snapshot and the retired
+    // snapshots; snapshots hold projects allocated from the arena of the
+    // data, so they are destroyed before it
+    std::mutex writerMutex;
+    DataManager<T> data;
+    SnapshotDb<T> next;
+    // snapshot read by new readers
+    std::atomic<SnapshotDb<T>*> current;
+    EpochManager epochs;
+    // replaced snapshots tagged with the epoch they were retired in
+    std::vector<std::pair<unsigned long long, SnapshotDb<T>*>> retired;
+    std::size_t noOfPublished, noOfReclaimed;
+
+    // bring the next snapshot up to date with a written project,
+    // writerMutex must be held
+    void update(const std::string& staff, const std::string& project) {
+        ProjectSharedPtr<T> shared{this->data.shareProject(staff, project)};
+        if (shared) this->next.setProject(staff, project, shared);
+        else this->next.eraseProject(staff, project);
+    }
+
+    // publish copy of the next snapshot, writerMutex must be held
+    void publish() {
+        SnapshotDb<T>* replaced{current.exchange(new SnapshotDb<T>(this->next))};
+        // readers that loaded the replaced snapshot pinned an epoch no
+        // greater than the tag
+        retired.push_back(std::make_pair(epochs.retire(), replaced));
+        ++noOfPublished;
+        this->reclaim();
+    }
+
+    // free retired snapshots no reader can see any more, writerMutex must be held
+    void reclaim() {
+        unsigned long long oldest{epochs.getOldestPinned()};
+        std::size_t kept{};
+        for (std::size_t i{}; i < retired.size(); ++i) {
+            if (retired[i].first < oldest) {
+                delete retired[i].second;
+                ++noOfReclaimed;
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+
+public:
+    // Consistent read view: pins the snapshot published when it is created
+    // until it goes out of scope. Keep it short-lived, since snapshots
+    // replaced meanwhile are kept alive for as long as it exists.
+    class ReadSnapshot {
+    private:
+        EpochManager& epochs;
+        std::size_t slot;
+        const SnapshotDb<T>* snapshot;
+
+    public:
+        // parametrised constructor - pins the current snapshot of manager
+        ReadSnapshot(SnapshotDataManager& manager)
+                    : epochs(manager.epochs), slot{manager.epochs.pin()}, snapshot{manager.current.load()} {}
+        // a pin belongs to one scope
+        ReadSnapshot(const ReadSnapshot&) = delete;
+        ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+        // destructor - unpins snapshot
+        ~ReadSnapshot() { epochs.unpin(slot); }
+
+        // access functions
+        const SnapshotDb<T>& operator*() const { return *snapshot; }
+        const SnapshotDb<T>* operator->() const { return snapshot; }
+
+        // return query output, same as the DataManager show and report functions
+        std::string runQuery(const QueryKey& query) const {
+            std::string output{query.view == QueryView::DATA ? snapshot->show(query) : snapshot->getReport(query)};
+            if (output.empty() && query.range.isRange) {
+                ErrorMsg::print("\n[DATA-MANAGER] No measurements found in specified time range\n");
+            }
+            return output;
+        }
+    };
+
+    // default constructor - publishes an empty snapshot
+    SnapshotDataManager() : current{nullptr}, noOfPublished{}, noOfReclaimed{} {
+        DebugMsg::print("[SNAPSHOT-DATA-MANAGER] Default constructor called\n");
+        std::lock_guard<std::mutex> lock(writerMutex);
+        this->data.setCopyOnWrite(true);
+        this->publish();
+    }
+
+    // parametrised constructor - publishes a snapshot of loaded data, whose
+    // projects are compacted in place and never changed afterwards
+    SnapshotDataManager(const DataManager<T>& userData)
+                       : data{userData}, current{nullptr}, noOfPublished{}, noOfReclaimed{} {
+        DebugMsg::print("[SNAPSHOT-DATA-MANAGER] Parametrised constructor called\n");
+        std::lock_guard<std::mutex> lock(writerMutex);
+        this->data.setCopyOnWrite(true);
+        this->data.compact();
+        this->next.build(this->data.getProjects(), this->data.getReferenceEntries(QueryScope::STAFF),
+                         this->data.getReferenceEntries(QueryScope::PROJECT));
+        this->publish();
+    }
+
+    // readers refer to the manager, so it does not move
+    SnapshotDataManager(const SnapshotDataManager&) = delete;
+    SnapshotDataManager& operator=(const SnapshotDataManager&) = delete;
+
+    // destructor - no reader may be left
+    ~SnapshotDataManager() {
+        DebugMsg::print("[SNAPSHOT-DATA-MANAGER] Default destructor called\n");
+        delete current.load();
+        for (auto it = retired.begin(); it != retired.end(); ++it) delete it->second;
+    }
+
+    // insert experiment and publish the result
+    void insertExperiment(Experiment<T>&& userExperiment) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        std::string staffName{userExperiment.getStaffName()}, projectName{userExperiment.getProjectName()};
+        this->data.insertExperiment(std::move(userExperiment));
+        this->update(staffName, projectName);
+        this->publish();
+    }
+
+    // insert experiments and publish the result once
+    void insertExperiments(std::vector<Experiment<T>>&& userExperiments) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        std::set<ProjectDbKeyType> keys;
+        for (auto it = userExperiments.begin(); it != userExperiments.end(); ++it) {
+            keys.insert(std::make_pair(it->getStaffName(), it->getProjectName()));
+        }
+        this->data.insertExperiments(std::move(userExperiments));
+        for (auto it = keys.begin(); it != keys.end(); ++it) this->update(it->first, it->second);
+        this->publish();
+    }
+
+    // delete project and publish the result
+    bool deleteEntry(const std::string& staff, const std::string& project) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!this->data.deleteEntry(staff, project)) return false;
+        this->update(staff, project);
+        this->publish();
+        return true;
+    }
+
+    // delete measurements and publish the result
+    bool deleteMeasurementRange(const std::string& staff, const std::string& project,
+                                const unsigned& startRange, const unsigned& endRange) {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!this->data.deleteMeasurementRange(staff, project, startRange, endRange)) return false;
+        this->update(staff, project);
+        this->publish();
+        return true;
+    }
+
+    // return query output of the current snapshot
+    std::string runQuery(const QueryKey& query) {
+        ReadSnapshot snapshot(*this);
+        return snapshot.runQuery(query);
+    }
+
+    // return snapshot statistics
+    std::string show() {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Snapshots"                     << std::endl
+            << "-----------------------------" << std::endl
+            << "Published: " << noOfPublished  << std::endl
+            << "Reclaimed: " << noOfReclaimed  << std::endl
+            << "Retired, still readable: " << retired.size() << std::endl
+            << "-----------------------------" << std::endl;
+        return stringStream.str();
+    }
+
+    // measure pair report throughput of 1 to maxReaders reader threads,
+    // each for the given number of seconds, while one writer thread keeps
+    // inserting and deleting a project
+    std::string benchmarkReaders(const unsigned& maxReaders, const double& seconds = 0.5) {
+        std::vector<std::pair<std::string, std::string>> pairs;
+        {
+            ReadSnapshot snapshot(*this);
+            pairs = snapshot->getPairs();
+        }
+        if (pairs.empty()) {
+            ErrorMsg::print("\n[SNAPSHOT-DATA-MANAGER] No projects to read\n");
+            return "";
+        }
+        std::ostringstream stringStream;
+        stringStream << std::endl
+            << "-----------------------------" << std::endl
+            << "Snapshot reads"                << std::endl
+            << "-----------------------------" << std::endl
+            << "Readers\tQueries/s\tSpeedup\tWrites/s" << std::endl;
+        double singleRate{};
+        for (unsigned noOfReaders{1}; noOfReaders <= maxReaders; ++noOfReaders) {
+            std::atomic<bool> stop{false};
+            std::atomic<std::size_t> noOfQueries{0};
+            std::size_t noOfWrites{};
+            std::thread writer([&]() {
+                std::list<Measurement<T>> measurements{Measurement<T>(0, T(1)), Measurement<T>(1, T(2))};
+                while (!stop.load()) {
+                    this->insertExperiment(Experiment<T>(HeaderLine("BENCH"), HeaderLine("WRITER"), measurements));
+                    this->deleteEntry("BENCH", "WRITER");
+                    noOfWrites += 2;
+                }
+            });
+            std::vector<std::thread> readers;
+            for (unsigned r{}; r < noOfReaders; ++r) {
+                readers.push_back(std::thread([&, r]() {
+                    // each reader walks the pairs in its own pseudo-random order
+                    unsigned long long next{r};
+                    std::size_t count{};
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        const std::pair<std::string, std::string>& pair = pairs[next % pairs.size()];
+                        next = next * 6364136223846793005ULL + 1442695040888963407ULL;
+                        ReadSnapshot snapshot(*this);
+                        snapshot->getReport(QueryKey{QueryView::REPORT, QueryScope::PAIR,
+                                                     pair.first, pair.second, TimeRange{}});
+                        ++count;
+                    }
+                    noOfQueries += count;
+                }));
+            }
+            auto start = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+            stop = true;
+            for (auto it = readers.begin(); it != readers.end(); ++it) it->join();
+            writer.join();
+            double elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+            double rate{noOfQueries.load() / elapsed};
+            if (noOfReaders == 1) singleRate = rate;
+            stringStream << noOfReaders << "\t" << std::fixed << std::setprecision(0) << rate << "\t\t"
+                         << std::setprecision(2) << (singleRate > 0 ? rate / singleRate : 0) << "\t"
+                         << std::setprecision(0) << noOfWrites / elapsed << std::endl;
+            stringStream.unsetf(std::ios::fixed);
+        }
+        stringStream << "-----------------------------" << std::endl;
+        return stringStream.str() + this->show();
+    }
+};
+
+#endif /* SNAPSHOT_DATA_MANAGER_HPP */
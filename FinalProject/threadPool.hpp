@@ -0,0 +1,190 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <iostream>           // std
+#include <vector>             // vector
+#include <deque>              // deque
+#include <memory>             // unique pointer
+#include <functional>         // function
+#include <thread>             // thread, hardware_concurrency()
+#include <mutex>              // mutex, lock_guard, unique_lock
+#include <condition_variable> // condition_variable
+#include <atomic>             // atomic
+#include <exception>          // exception_ptr
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* WORK-STEALING THREAD POOL
+* -----------------------------------------------------------------------*/
+
+// Runs a batch of independent tasks, identified by their index, over a fixed
+// set of worker threads. Every worker owns a double-ended queue which is
+// filled with a contiguous block of task indices; a worker takes tasks from
+// the front of its own queue and, once it runs dry, steals from the back of
+// another worker's queue. One very expensive task therefore only keeps one
+// worker busy while the others drain the rest of the batch.
+class WorkStealingPool {
+private:
+    // task queue owned by one worker
+    struct WorkQueue {
+        std::mutex queueMutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    // queue 0 belongs to the calling thread, the rest to the worker threads
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    // only one batch can run at a time
+    std::mutex batchMutex;
+    // protects the state below and is used for sleeping/waking up
+    std::mutex stateMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(std::size_t)>* currentTask;
+    std::size_t batchNo;
+    std::atomic<std::size_t> remainingTasks;
+    std::exception_ptr taskException;
+    bool stopping;
+
+    // true on threads which belong to any pool, so that nested batches run serially
+    static bool& insideWorker() {
+        static thread_local bool inside{false};
+        return inside;
+    }
+
+    // take next task from own queue
+    bool popTask(std::size_t queueNo, std::size_t& task) {
+        WorkQueue& queue = *queues[queueNo];
+        std::lock_guard<std::mutex> lock(queue.queueMutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    // take a task from the back of any other queue
+    bool stealTask(std::size_t queueNo, std::size_t& task) {
+        for (std::size_t i{1}; i < queues.size(); ++i) {
+            WorkQueue& victim = *queues[(queueNo + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.queueMutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // run tasks until every queue is empty
+    void drainQueues(std::size_t queueNo) {
+        std::size_t task{};
+        while (popTask(queueNo, task) || stealTask(queueNo, task)) {
+            try {
+                // the queue mutex orders this read after the batch was published
+                (*currentTask)(task);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                // only the first exception is passed on to the caller
+                if (!taskException) taskException = std::current_exception();
+            }
+            if (--remainingTasks == 0) {
+                // last task of the batch, wake up the caller
+                std::lock_guard<std::mutex> lock(stateMutex);
+                doneCondition.notify_all();
+            }
+        }
+    }
+
+    // worker thread main loop
+    void workerLoop(std::size_t queueNo) {
+        insideWorker() = true;
+        std::size_t lastBatchNo{};
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                wakeCondition.wait(lock, [&] { return stopping || batchNo != lastBatchNo; });
+                if (stopping) return;
+                lastBatchNo = batchNo;
+            }
+            drainQueues(queueNo);
+        }
+    }
+
+public:
+    // parametrised constructor - noOfThreads includes the calling thread
+    WorkStealingPool(unsigned noOfThreads)
+                    : currentTask{nullptr}, batchNo{}, remainingTasks{0}, stopping{false} {
+        DebugMsg::print("[THREAD-POOL] Parametrised constructor called\n");
+        if (noOfThreads == 0) noOfThreads = 1;
+        for (unsigned i{}; i < noOfThreads; ++i) {
+            queues.push_back(std::unique_ptr<WorkQueue>{ new WorkQueue });
+        }
+        for (unsigned i{1}; i < noOfThreads; ++i) {
+            workers.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+        }
+    }
+
+    // pool owns threads, hence it can be neither copied nor moved
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // destructor stops and joins worker threads
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // number of threads taking part in a batch, including the calling thread
+    std::size_t getNoOfThreads() const { return this->queues.size(); }
+
+    // pool shared by the whole program, one thread per hardware core
+    static WorkStealingPool& getSharedPool() {
+        static WorkStealingPool sharedPool{std::thread::hardware_concurrency()};
+        return sharedPool;
+    }
+
+    // call task(i) for every i in [0, noOfTasks) and return when all are done;
+    // the first exception thrown by a task is rethrown here
+    void parallelFor(std::size_t noOfTasks, const std::function<void(std::size_t)>& task) {
+        // nothing to share out, or called from inside a task: run serially
+        if (noOfTasks < 2 || workers.empty() || insideWorker()) {
+            for (std::size_t i{}; i < noOfTasks; ++i) task(i);
+            return;
+        }
+        std::lock_guard<std::mutex> batchLock(batchMutex);
+        currentTask = &task;
+        taskException = nullptr;
+        remainingTasks = noOfTasks;
+        // hand out contiguous blocks of tasks, one block per queue
+        std::size_t noOfQueues{queues.size()};
+        for (std::size_t q{}; q < noOfQueues; ++q) {
+            std::lock_guard<std::mutex> lock(queues[q]->queueMutex);
+            for (std::size_t i{q * noOfTasks / noOfQueues}; i < (q + 1) * noOfTasks / noOfQueues; ++i) {
+                queues[q]->tasks.push_back(i);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            ++batchNo;
+        }
+        wakeCondition.notify_all();
+        // calling thread works too
+        insideWorker() = true;
+        drainQueues(0);
+        insideWorker() = false;
+        // wait for tasks still running on other workers
+        std::unique_lock<std::mutex> lock(stateMutex);
+        doneCondition.wait(lock, [&] { return remainingTasks == 0; });
+        currentTask = nullptr;
+        if (taskException) std::rethrow_exception(taskException);
+    }
+};
+
+#endif /* THREAD_POOL_HPP */
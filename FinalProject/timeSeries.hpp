@@ -0,0 +1,679 @@
+#ifndef TIME_SERIES_HPP
+#define TIME_SERIES_HPP
+
+#include <iostream>  // std
+#include <vector>    // vector
+#include <list>      // list
+#include <algorithm> // lower_bound, upper_bound, stable_sort
+#include <utility>   // pair
+#include <limits>    // numeric_limits
+#include <complex>   // complex numbers
+#include <cmath>     // abs
+#include <cstdint>   // fixed width integers
+#include <memory>    // shared_ptr
+#include <array>     // array
+
+#include "msg.hpp"            // classes managing outputs
+#include "measurement.hpp"    // classes containing measurements
+#include "timestampIndex.hpp" // sorted timestamp index
+#include "aggregateIndex.hpp" // prefix sums for window statistics
+#include "blockCodec.hpp"     // encodings of time series blocks
+
+/* ------------------------------------------------------------------------
+* ZONE MAP KEYS OF MEASUREMENT VALUES
+* -----------------------------------------------------------------------*/
+
+// zone maps keep the minimum and maximum key of the values in a block:
+// the value itself for real types
+template <typename T> struct ZoneKey {
+    static double get(const T& value) { return static_cast<double>(value); }
+};
+
+// complex values have no order, so blocks are keyed by magnitude
+template <typename U> struct ZoneKey<std::complex<U>> {
+    static double get(const std::complex<U>& value) { return std::abs(value); }
+};
+
+/* ------------------------------------------------------------------------
+* TIME BLOCK CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// header summarising all measurements of a block
+template <typename T> struct BlockHeader {
+    unsigned minTimestamp;
+    unsigned maxTimestamp;
+    // zone map of value keys
+    double minValue;
+    double maxValue;
+    // count, sum and sum of squares
+    Aggregate<T> aggregate;
+};
+
+// storage used by blocks of one or more series
+struct StorageStats {
+    std::size_t noOfMeasurements;
+    std::size_t noOfBlocks;
+    std::size_t noOfEncodedBlocks;
+    // one timestamp and one value per measurement
+    std::size_t rawBytes;
+    // bytes held by raw and encoded columns
+    std::size_t columnBytes;
+    // bytes held by block headers and bookkeeping
+    std::size_t blockBytes;
+
+    // add statistics of another series
+    StorageStats& operator+=(const StorageStats& otherStats) {
+        noOfMeasurements += otherStats.noOfMeasurements;
+        noOfBlocks += otherStats.noOfBlocks;
+        noOfEncodedBlocks += otherStats.noOfEncodedBlocks;
+        rawBytes += otherStats.rawBytes;
+        columnBytes += otherStats.columnBytes;
+        blockBytes += otherStats.blockBytes;
+        return *this;
+    }
+};
+
+// Up to getCapacity() measurements in time order, stored column-wise, with
+// a header that lets queries skip or fully answer the block without
+// reading its measurements. Raw columns of up to getInlineCapacity()
+// measurements are kept inside the block and spill to arena columns when
+// the block grows beyond that, so the many tiny experiments need no column
+// memory at all. Columns are either raw or encoded with TimestampCodec and
+// ValueCodec; encoded blocks are decoded into caller buffers for reading
+// and back into raw columns before being changed.
+template <typename T> class TimeBlock {
+private:
+    using SumType = typename AggregateTraits<T>::SumType;
+    BlockHeader<T> header;
+    // raw columns of small blocks
+    static const std::size_t inlineCapacity = 16;
+    std::array<unsigned, inlineCapacity> inlineTimestamps;
+    std::array<T, inlineCapacity> inlineValues;
+    // raw columns of large blocks, empty while the block is inline or encoded
+    bool spilled;
+    ArenaVector<unsigned> timestamps;
+    ArenaVector<T> values;
+    // encoded columns, empty while the block is raw
+    bool encoded;
+    ArenaVector<std::uint64_t> encodedTimestamps;
+    ArenaVector<std::uint64_t> encodedValues;
+
+    // add one measurement to the header
+    void include(const unsigned& timestamp, const T& value) {
+        double key{ZoneKey<T>::get(value)};
+        if (timestamp < header.minTimestamp) header.minTimestamp = timestamp;
+        if (timestamp > header.maxTimestamp) header.maxTimestamp = timestamp;
+        if (key < header.minValue) header.minValue = key;
+        if (key > header.maxValue) header.maxValue = key;
+        header.aggregate.add(value);
+    }
+
+    // reset header to an empty block
+    void resetHeader() {
+        header.minTimestamp = std::numeric_limits<unsigned>::max();
+        header.maxTimestamp = 0;
+        header.minValue = std::numeric_limits<double>::infinity();
+        header.maxValue = -std::numeric_limits<double>::infinity();
+        header.aggregate = Aggregate<T>(header.aggregate.pivot);
+    }
+
+    // first element of the raw columns
+    unsigned* getRawTimestamps() { return spilled ? timestamps.data() : inlineTimestamps.data(); }
+    T* getRawValues() { return spilled ? values.data() : inlineValues.data(); }
+    const unsigned* getRawTimestamps() const { return spilled ? timestamps.data() : inlineTimestamps.data(); }
+    const T* getRawValues() const { return spilled ? values.data() : inlineValues.data(); }
+
+    // move inline columns to arena columns
+    void spill() {
+        timestamps.reserve(2 * getInlineCapacity());
+        values.reserve(2 * getInlineCapacity());
+        timestamps.assign(inlineTimestamps.begin(), inlineTimestamps.begin() + this->getSize());
+        values.assign(inlineValues.begin(), inlineValues.begin() + this->getSize());
+        spilled = true;
+    }
+
+public:
+    // maximum number of measurements in a block
+    static constexpr std::size_t getCapacity() { return 1024; }
+    // maximum number of measurements stored inside the block
+    static constexpr std::size_t getInlineCapacity() { return inlineCapacity; }
+    // bytes of the inline columns
+    static constexpr std::size_t getInlineBytes() { return getInlineCapacity() * (sizeof(unsigned) + sizeof(T)); }
+
+    // parametrised constructor - empty block summing relative to pivot,
+    // spilled columns are allocated from arena (from the heap if it is empty)
+    TimeBlock(const SumType& pivot, const std::shared_ptr<Arena>& arena = std::shared_ptr<Arena>())
+             : inlineTimestamps(), inlineValues(), spilled{false}, timestamps(ArenaAllocator<unsigned>(arena)), values(ArenaAllocator<T>(arena)),
+               encoded{false}, encodedTimestamps(ArenaAllocator<std::uint64_t>(arena)),
+               encodedValues(ArenaAllocator<std::uint64_t>(arena)) {
+        header.aggregate = Aggregate<T>(pivot);
+        this->resetHeader();
+    }
+
+    // access functions
+    const BlockHeader<T>& getHeader() const { return this->header; }
+    std::size_t getSize() const { return this->header.aggregate.count; }
+    bool isFull() const { return this->getSize() >= getCapacity(); }
+    bool isEncoded() const { return this->encoded; }
+
+    // timestamp column, decoded into buffer if the block is encoded
+    ColumnView<unsigned> getTimestamps(ArenaVector<unsigned>& buffer) const {
+        if (!encoded) return ColumnView<unsigned>(this->getRawTimestamps(), this->getSize());
+        TimestampCodec::decode(encodedTimestamps, this->getSize(), buffer);
+        return ColumnView<unsigned>(buffer);
+    }
+
+    // value column, decoded into buffer if the block is encoded
+    ColumnView<T> getValues(ArenaVector<T>& buffer) const {
+        if (!encoded) return ColumnView<T>(this->getRawValues(), this->getSize());
+        ValueCodec<T>::decode(encodedValues, this->getSize(), buffer);
+        return ColumnView<T>(buffer);
+    }
+
+    // replace raw columns by encoded ones; inline blocks are already as
+    // small as they get and stay raw
+    void encode() {
+        if (encoded || !spilled) return;
+        TimestampCodec::encode(ColumnView<unsigned>(timestamps), encodedTimestamps);
+        ValueCodec<T>::encode(ColumnView<T>(values), encodedValues);
+        encodedTimestamps.shrink_to_fit();
+        encodedValues.shrink_to_fit();
+        // release raw columns, keeping their arena
+        ArenaVector<unsigned>(timestamps.get_allocator()).swap(timestamps);
+        ArenaVector<T>(values.get_allocator()).swap(values);
+        spilled = false;
+        encoded = true;
+    }
+
+    // replace encoded columns by raw ones
+    void decode() {
+        if (!encoded) return;
+        TimestampCodec::decode(encodedTimestamps, this->getSize(), timestamps);
+        ValueCodec<T>::decode(encodedValues, this->getSize(), values);
+        ArenaVector<std::uint64_t>(encodedTimestamps.get_allocator()).swap(encodedTimestamps);
+        ArenaVector<std::uint64_t>(encodedValues.get_allocator()).swap(encodedValues);
+        spilled = true;
+        encoded = false;
+    }
+
+    // append measurement
+    void push_back(const unsigned& timestamp, const T& value) {
+        this->decode();
+        if (spilled) {
+            timestamps.push_back(timestamp);
+            values.push_back(value);
+        } else if (this->getSize() < getInlineCapacity()) {
+            inlineTimestamps[this->getSize()] = timestamp;
+            inlineValues[this->getSize()] = value;
+        } else {
+            this->spill();
+            timestamps.push_back(timestamp);
+            values.push_back(value);
+        }
+        this->include(timestamp, value);
+        // full blocks do not change any more until measurements are deleted
+        if (this->isFull() && BlockStorage::compressBlocks) this->encode();
+    }
+
+    // release unused capacity of spilled columns
+    void shrink_to_fit() {
+        timestamps.shrink_to_fit();
+        values.shrink_to_fit();
+    }
+
+    // true if every measurement is within [startTime, endTime]
+    bool isCoveredBy(const unsigned& startTime, const unsigned& endTime) const {
+        return header.minTimestamp >= startTime && header.maxTimestamp <= endTime;
+    }
+
+    // aggregate of measurements with timestamps in [startTime, endTime]
+    Aggregate<T> getAggregate(const unsigned& startTime, const unsigned& endTime) const {
+        if (this->isCoveredBy(startTime, endTime)) return header.aggregate;
+        Aggregate<T> aggregate(header.aggregate.pivot);
+        ArenaVector<unsigned> timestampBuffer;
+        ColumnView<unsigned> blockTimestamps{this->getTimestamps(timestampBuffer)};
+        std::size_t first = std::lower_bound(blockTimestamps.begin(), blockTimestamps.end(), startTime)
+                          - blockTimestamps.begin();
+        std::size_t last = std::upper_bound(blockTimestamps.begin(), blockTimestamps.end(), endTime)
+                         - blockTimestamps.begin();
+        // encoded values are summed by their codec
+        if (encoded) {
+            ValueCodec<T>::addRange(encodedValues, this->getSize(), first, last, aggregate);
+        } else {
+            const T* rawValues{this->getRawValues()};
+            for (std::size_t i{first}; i < last; ++i) aggregate.add(rawValues[i]);
+        }
+        return aggregate;
+    }
+
+    // aggregate of measurements with value keys in [lowValue, highValue]
+    Aggregate<T> getValueAggregate(const double& lowValue, const double& highValue) const {
+        Aggregate<T> aggregate(header.aggregate.pivot);
+        // zone map: block entirely outside or inside the value range
+        if (header.maxValue < lowValue || header.minValue > highValue) return aggregate;
+        if (header.minValue >= lowValue && header.maxValue <= highValue) return header.aggregate;
+        ArenaVector<T> valueBuffer;
+        ColumnView<T> blockValues{this->getValues(valueBuffer)};
+        for (std::size_t i{}; i < blockValues.size(); ++i) {
+            double key{ZoneKey<T>::get(blockValues[i])};
+            if (key >= lowValue && key <= highValue) aggregate.add(blockValues[i]);
+        }
+        return aggregate;
+    }
+
+    // erase measurements with timestamps in [startTime, endTime], returns
+    // number of erased measurements
+    std::size_t erase(const unsigned& startTime, const unsigned& endTime) {
+        this->decode();
+        std::size_t size{this->getSize()};
+        unsigned* rawTimestamps{this->getRawTimestamps()};
+        T* rawValues{this->getRawValues()};
+        std::size_t first = std::lower_bound(rawTimestamps, rawTimestamps + size, startTime) - rawTimestamps;
+        std::size_t last = std::upper_bound(rawTimestamps, rawTimestamps + size, endTime) - rawTimestamps;
+        if (first >= last) return 0;
+        if (spilled) {
+            timestamps.erase(timestamps.begin() + first, timestamps.begin() + last);
+            values.erase(values.begin() + first, values.begin() + last);
+        } else {
+            std::copy(rawTimestamps + last, rawTimestamps + size, rawTimestamps + first);
+            std::copy(rawValues + last, rawValues + size, rawValues + first);
+        }
+        // recompute header from the remaining measurements
+        size -= last - first;
+        rawTimestamps = this->getRawTimestamps();
+        rawValues = this->getRawValues();
+        this->resetHeader();
+        for (std::size_t i{}; i < size; ++i) this->include(rawTimestamps[i], rawValues[i]);
+        return last - first;
+    }
+
+    // bytes held by raw and encoded columns, inline columns included
+    std::size_t getColumnBytes() const {
+        return getInlineBytes()
+             + timestamps.capacity() * sizeof(unsigned) + values.capacity() * sizeof(T)
+             + (encodedTimestamps.capacity() + encodedValues.capacity()) * sizeof(std::uint64_t);
+    }
+
+    // storage used by the block, inline columns count as column storage
+    StorageStats getStorageStats() const {
+        return StorageStats{this->getSize(), 1, encoded ? 1u : 0u,
+                            this->getSize() * (sizeof(unsigned) + sizeof(T)), this->getColumnBytes(), 0};
+    }
+};
+
+/* ------------------------------------------------------------------------
+* TIME SERIES CLASS TEMPLATE
+* -----------------------------------------------------------------------*/
+
+// Measurements of one experiment or project in time-ordered blocks. Blocks
+// do not overlap in time, so a query over [startTime, endTime] reads at
+// most its two boundary blocks; blocks in between are answered from block
+// headers, or skipped or dropped whole by deletions. Block headers are
+// indexed by first and last timestamp and summed into prefix sums on first
+// use after a change. With BlockStorage::compressBlocks on, every block is
+// encoded after sorting, merging and deleting. Blocks and their columns
+// are allocated from the arena of the series, copies share it; buffers of
+// queries, which may run on several threads, come from the heap.
+template <typename T> class TimeSeries {
+private:
+    using SumType = typename AggregateTraits<T>::SumType;
+    // arena of blocks and columns, empty for the heap
+    std::shared_ptr<Arena> arena;
+    ArenaVector<TimeBlock<T>> blocks;
+    // pivot shared by the sums of all blocks
+    SumType pivot;
+    std::size_t size;
+    // false after an out-of-order push_back until sort() is called
+    bool sorted;
+    // column bytes of all blocks, kept up to date by every change so that
+    // the storage of a series is known without walking its blocks
+    std::size_t columnBytes;
+    // indices over block headers, built on first use after a change
+    mutable bool indexValid;
+    mutable TimestampIndex firstTimestamps;
+    mutable TimestampIndex lastTimestamps;
+    mutable AggregateIndex<T> blockAggregates;
+
+    // build indices over block headers
+    void buildIndex() const {
+        if (indexValid) return;
+        std::vector<unsigned> firsts;
+        std::vector<unsigned> lasts;
+        std::vector<Aggregate<T>> aggregates;
+        firsts.reserve(blocks.size());
+        lasts.reserve(blocks.size());
+        aggregates.reserve(blocks.size());
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            firsts.push_back(it->getHeader().minTimestamp);
+            lasts.push_back(it->getHeader().maxTimestamp);
+            aggregates.push_back(it->getHeader().aggregate);
+        }
+        firstTimestamps.build(firsts);
+        lastTimestamps.build(lasts);
+        blockAggregates.build(aggregates, pivot);
+        indexValid = true;
+    }
+
+    // find blocks [firstBlock, lastBlock) holding measurements in
+    // [startTime, endTime]; all but the first and last are covered whole
+    void findBlocks(const unsigned& startTime, const unsigned& endTime,
+                    std::size_t& firstBlock, std::size_t& lastBlock) const {
+        this->buildIndex();
+        firstBlock = lastTimestamps.lowerBound(startTime);
+        lastBlock = firstTimestamps.upperBound(endTime);
+        if (startTime > endTime || firstBlock > lastBlock) lastBlock = firstBlock;
+    }
+
+    // encode blocks after a bulk update if compression is on
+    void applyStorageOptions() {
+        if (!BlockStorage::compressBlocks) return;
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            std::size_t before{it->getColumnBytes()};
+            it->encode();
+            columnBytes = columnBytes - before + it->getColumnBytes();
+        }
+    }
+
+    // count column bytes of all blocks afresh
+    void recountColumnBytes() {
+        columnBytes = 0;
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) columnBytes += it->getColumnBytes();
+    }
+
+    // erase blocks [firstBlock, lastBlock) and their column bytes
+    void eraseBlocks(const std::size_t& firstBlock, const std::size_t& lastBlock) {
+        for (std::size_t b{firstBlock}; b < lastBlock; ++b) columnBytes -= blocks[b].getColumnBytes();
+        blocks.erase(blocks.begin() + firstBlock, blocks.begin() + lastBlock);
+    }
+
+public:
+    // parametrised constructor - empty series allocating from userArena
+    TimeSeries(const std::shared_ptr<Arena>& userArena = std::shared_ptr<Arena>())
+              : arena{userArena}, blocks(ArenaAllocator<TimeBlock<T>>(userArena)),
+                pivot{}, size{}, sorted{true}, columnBytes{}, indexValid{false} {}
+
+    // copy constructor - copied columns may hold less capacity
+    TimeSeries(const TimeSeries& otherSeries)
+              : arena{otherSeries.arena}, blocks(otherSeries.blocks), pivot{otherSeries.pivot},
+                size{otherSeries.size}, sorted{otherSeries.sorted}, columnBytes{},
+                indexValid{otherSeries.indexValid}, firstTimestamps(otherSeries.firstTimestamps),
+                lastTimestamps(otherSeries.lastTimestamps), blockAggregates(otherSeries.blockAggregates) {
+        this->recountColumnBytes();
+    }
+    TimeSeries(TimeSeries&&) = default;
+
+    // assignment operators
+    TimeSeries& operator=(const TimeSeries& otherSeries) {
+        if (this != &otherSeries) *this = TimeSeries(otherSeries);
+        return *this;
+    }
+    TimeSeries& operator=(TimeSeries&&) = default;
+
+    // access functions
+    std::size_t getSize() const { return this->size; }
+    bool empty() const { return this->size == 0; }
+    std::size_t getNoOfBlocks() const { return this->blocks.size(); }
+
+    // call function(timestamp, value) for every measurement in time order
+    template <typename Function> void forEach(Function function) const {
+        ArenaVector<unsigned> timestampBuffer;
+        ArenaVector<T> valueBuffer;
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            ColumnView<unsigned> blockTimestamps{it->getTimestamps(timestampBuffer)};
+            ColumnView<T> blockValues{it->getValues(valueBuffer)};
+            for (std::size_t i{}; i < blockTimestamps.size(); ++i) function(blockTimestamps[i], blockValues[i]);
+        }
+    }
+
+    // append measurement, call sort() afterwards if it is out of order
+    void push_back(const unsigned& timestamp, const T& value) {
+        // the first value sets the pivot while there are no blocks to rebase
+        if (this->size == 0) pivot = AggregateTraits<T>::getPivot(value);
+        if (!blocks.empty() && timestamp < blocks.back().getHeader().maxTimestamp) sorted = false;
+        if (blocks.empty() || blocks.back().isFull()) {
+            blocks.push_back(TimeBlock<T>(pivot, arena));
+            columnBytes += blocks.back().getColumnBytes();
+        }
+        std::size_t before{blocks.back().getColumnBytes()};
+        blocks.back().push_back(timestamp, value);
+        columnBytes = columnBytes - before + blocks.back().getColumnBytes();
+        ++this->size;
+        indexValid = false;
+    }
+    void push_back(const Measurement<T>& measurement) {
+        this->push_back(measurement.getTimestamp(), measurement.getDataPoint());
+    }
+
+    // remove all measurements
+    void clear() {
+        blocks.clear();
+        columnBytes = 0;
+        size = 0;
+        sorted = true;
+        indexValid = false;
+    }
+
+    // sort measurements by timestamp, stable for equal timestamps
+    void sort() {
+        if (!sorted) {
+            std::vector<std::pair<unsigned, T>> points;
+            points.reserve(size);
+            this->forEach([&points](const unsigned& timestamp, const T& value) {
+                points.push_back(std::make_pair(timestamp, value));
+            });
+            std::stable_sort(points.begin(), points.end(),
+                [](const std::pair<unsigned, T>& a, const std::pair<unsigned, T>& b) { return a.first < b.first; });
+            this->clear();
+            for (auto it = points.begin(); it != points.end(); ++it) this->push_back(it->first, it->second);
+        }
+        this->applyStorageOptions();
+    }
+
+    // merge sorted series, measurements of this series come first for equal
+    // timestamps; only blocks ending after the start of the other series
+    // are rewritten
+    void merge(const TimeSeries& otherSeries) {
+        if (otherSeries.empty()) return;
+        this->sort();
+        unsigned otherStart{otherSeries.blocks.front().getHeader().minTimestamp};
+        std::size_t keptBlocks{blocks.size()};
+        if (!blocks.empty() && blocks.back().getHeader().maxTimestamp > otherStart) {
+            this->buildIndex();
+            keptBlocks = lastTimestamps.upperBound(otherStart);
+        }
+        // take out the measurements of the rewritten blocks
+        ArenaVector<unsigned> tailTimestamps;
+        ArenaVector<T> tailValues;
+        ArenaVector<unsigned> timestampBuffer;
+        ArenaVector<T> valueBuffer;
+        for (std::size_t b{keptBlocks}; b < blocks.size(); ++b) {
+            ColumnView<unsigned> blockTimestamps{blocks[b].getTimestamps(timestampBuffer)};
+            ColumnView<T> blockValues{blocks[b].getValues(valueBuffer)};
+            tailTimestamps.insert(tailTimestamps.end(), blockTimestamps.begin(), blockTimestamps.end());
+            tailValues.insert(tailValues.end(), blockValues.begin(), blockValues.end());
+        }
+        this->eraseBlocks(keptBlocks, blocks.size());
+        size -= tailTimestamps.size();
+        indexValid = false;
+        // two-way merge of the tail with the other series
+        std::size_t tail{};
+        otherSeries.forEach([&](const unsigned& timestamp, const T& value) {
+            while (tail < tailTimestamps.size() && tailTimestamps[tail] <= timestamp) {
+                this->push_back(tailTimestamps[tail], tailValues[tail]);
+                ++tail;
+            }
+            this->push_back(timestamp, value);
+        });
+        for (; tail < tailTimestamps.size(); ++tail) this->push_back(tailTimestamps[tail], tailValues[tail]);
+        this->applyStorageOptions();
+    }
+
+    // return all measurements
+    std::list<Measurement<T>> getMeasurements() const {
+        std::list<Measurement<T>> measurements;
+        this->forEach([&measurements](const unsigned& timestamp, const T& value) {
+            measurements.push_back(Measurement<T>(timestamp, value));
+        });
+        return measurements;
+    }
+
+    // return measurements with timestamps in [startTime, endTime]
+    std::list<Measurement<T>> getMeasurements(const unsigned& startTime, const unsigned& endTime) const {
+        std::list<Measurement<T>> window;
+        std::size_t firstBlock, lastBlock;
+        this->findBlocks(startTime, endTime, firstBlock, lastBlock);
+        ArenaVector<unsigned> timestampBuffer;
+        ArenaVector<T> valueBuffer;
+        for (std::size_t b{firstBlock}; b < lastBlock; ++b) {
+            ColumnView<unsigned> blockTimestamps{blocks[b].getTimestamps(timestampBuffer)};
+            ColumnView<T> blockValues{blocks[b].getValues(valueBuffer)};
+            for (std::size_t i{}; i < blockTimestamps.size(); ++i) {
+                if (blockTimestamps[i] >= startTime && blockTimestamps[i] <= endTime) {
+                    window.push_back(Measurement<T>(blockTimestamps[i], blockValues[i]));
+                }
+            }
+        }
+        return window;
+    }
+
+    // return measurements with value keys in [lowValue, highValue]
+    std::list<Measurement<T>> getMeasurementsByValue(const double& lowValue, const double& highValue) const {
+        std::list<Measurement<T>> selection;
+        ArenaVector<unsigned> timestampBuffer;
+        ArenaVector<T> valueBuffer;
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            // skip blocks whose zone map is outside the value range
+            if (it->getHeader().maxValue < lowValue || it->getHeader().minValue > highValue) continue;
+            ColumnView<unsigned> blockTimestamps{it->getTimestamps(timestampBuffer)};
+            ColumnView<T> blockValues{it->getValues(valueBuffer)};
+            for (std::size_t i{}; i < blockValues.size(); ++i) {
+                double key{ZoneKey<T>::get(blockValues[i])};
+                if (key >= lowValue && key <= highValue) {
+                    selection.push_back(Measurement<T>(blockTimestamps[i], blockValues[i]));
+                }
+            }
+        }
+        return selection;
+    }
+
+    // aggregate of all measurements
+    Aggregate<T> getAggregate() const {
+        this->buildIndex();
+        return blockAggregates.getAggregate(0, blocks.size());
+    }
+
+    // aggregate of measurements with timestamps in [startTime, endTime]:
+    // boundary blocks are read, blocks in between come from prefix sums
+    Aggregate<T> getAggregate(const unsigned& startTime, const unsigned& endTime) const {
+        std::size_t firstBlock, lastBlock;
+        this->findBlocks(startTime, endTime, firstBlock, lastBlock);
+        Aggregate<T> aggregate(pivot);
+        if (firstBlock >= lastBlock) return aggregate;
+        aggregate += blocks[firstBlock].getAggregate(startTime, endTime);
+        if (lastBlock - firstBlock > 1) {
+            aggregate += blockAggregates.getAggregate(firstBlock + 1, lastBlock - 1);
+            aggregate += blocks[lastBlock - 1].getAggregate(startTime, endTime);
+        }
+        return aggregate;
+    }
+
+    // aggregate of measurements with value keys in [lowValue, highValue]
+    Aggregate<T> getValueAggregate(const double& lowValue, const double& highValue) const {
+        Aggregate<T> aggregate(pivot);
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            aggregate += it->getValueAggregate(lowValue, highValue);
+        }
+        return aggregate;
+    }
+
+    // erase measurements with timestamps in [startTime, endTime], returns
+    // number of erased measurements
+    std::size_t erase(const unsigned& startTime, const unsigned& endTime) {
+        std::size_t firstBlock, lastBlock;
+        this->findBlocks(startTime, endTime, firstBlock, lastBlock);
+        if (firstBlock >= lastBlock) return 0;
+        std::size_t erased{};
+        // boundary blocks partly in range lose some measurements, but keep
+        // at least one outside the range
+        auto eraseFromBlock = [&](TimeBlock<T>& block) {
+            std::size_t before{block.getColumnBytes()};
+            erased += block.erase(startTime, endTime);
+            columnBytes = columnBytes - before + block.getColumnBytes();
+        };
+        if (!blocks[lastBlock - 1].isCoveredBy(startTime, endTime)) eraseFromBlock(blocks[--lastBlock]);
+        if (firstBlock < lastBlock && !blocks[firstBlock].isCoveredBy(startTime, endTime)) {
+            eraseFromBlock(blocks[firstBlock++]);
+        }
+        // blocks covered by the range are dropped without being read
+        for (std::size_t b{firstBlock}; b < lastBlock; ++b) erased += blocks[b].getSize();
+        this->eraseBlocks(firstBlock, lastBlock);
+        size -= erased;
+        indexValid = false;
+        this->applyStorageOptions();
+        return erased;
+    }
+
+    // rewrite series into full blocks with tight columns and build its
+    // indices and prefix sums, so that reads find everything prepared
+    void compact() {
+        this->sort();
+        bool partial{false};
+        for (std::size_t b{}; b + 1 < blocks.size(); ++b) {
+            if (!blocks[b].isFull()) partial = true;
+        }
+        // deletions leave partial blocks behind, merges leave none
+        if (partial) {
+            TimeSeries compacted(arena);
+            this->forEach([&compacted](const unsigned& timestamp, const T& value) {
+                compacted.push_back(timestamp, value);
+            });
+            *this = std::move(compacted);
+        }
+        blocks.shrink_to_fit();
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) it->shrink_to_fit();
+        this->recountColumnBytes();
+        this->applyStorageOptions();
+        this->buildIndex();
+    }
+
+    // decode every encoded block, returns number of decoded measurements
+    std::size_t decodeBlocks() const {
+        ArenaVector<unsigned> timestampBuffer;
+        ArenaVector<T> valueBuffer;
+        std::size_t decoded{};
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+            if (!it->isEncoded()) continue;
+            it->getTimestamps(timestampBuffer);
+            decoded += it->getValues(valueBuffer).size();
+        }
+        return decoded;
+    }
+
+    // storage used by the blocks
+    StorageStats getStorageStats() const {
+        StorageStats stats{0, 0, 0, 0, 0,
+                           blocks.capacity() * (sizeof(TimeBlock<T>) - TimeBlock<T>::getInlineBytes())};
+        for (auto it = blocks.begin(); it != blocks.end(); ++it) stats += it->getStorageStats();
+        return stats;
+    }
+
+    // heap memory held by the blocks, i.e. the measurements, in bytes,
+    // from the running column total rather than a walk over the blocks
+    std::size_t getStorageBytes() const {
+        return columnBytes + blocks.capacity() * (sizeof(TimeBlock<T>) - TimeBlock<T>::getInlineBytes());
+    }
+
+    // heap memory held by the block indices in bytes; they are built by
+    // the first query after a change
+    std::size_t getIndexBytes() const {
+        return firstTimestamps.getMemoryUsage() + lastTimestamps.getMemoryUsage()
+             + blockAggregates.getMemoryUsage();
+    }
+
+    // approximate heap memory held by blocks and indices in bytes
+    std::size_t getMemoryUsage() const {
+        return this->getStorageBytes() + this->getIndexBytes();
+    }
+};
+
+#endif /* TIME_SERIES_HPP */
@@ -0,0 +1,84 @@
+#ifndef TIMESTAMP_INDEX_HPP
+#define TIMESTAMP_INDEX_HPP
+
+#include <iostream> // std
+#include <vector>   // vector
+
+#include "msg.hpp"  // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* TIMESTAMP INDEX CLASS
+* -----------------------------------------------------------------------*/
+
+// Sorted index over a non-decreasing list of timestamps, e.g. the first or
+// last timestamps of the blocks of a time series. Timestamps are kept in
+// Eytzinger (breadth-first binary tree) order, so a search touches the
+// array from the front and the first few levels of the tree share a
+// handful of cache lines. Searches return ranks in the original order.
+class TimestampIndex {
+private:
+    // timestamps in Eytzinger order, element 0 unused
+    std::vector<unsigned> eytzinger;
+    // rank in the original order of every Eytzinger element
+    std::vector<std::size_t> eytzingerRank;
+
+    // fill Eytzinger array with an in-order walk of the implicit tree
+    std::size_t fillEytzinger(const std::vector<unsigned>& sortedTimestamps,
+                              std::size_t rank, std::size_t node) {
+        if (node < eytzinger.size()) {
+            rank = fillEytzinger(sortedTimestamps, rank, 2 * node);
+            eytzinger[node] = sortedTimestamps[rank];
+            eytzingerRank[node] = rank++;
+            rank = fillEytzinger(sortedTimestamps, rank, 2 * node + 1);
+        }
+        return rank;
+    }
+
+    // rank of first timestamp for which less(timestamp, key) is false
+    template <typename Less> std::size_t search(const unsigned& key, Less less) const {
+        std::size_t node{1};
+        std::size_t size{eytzinger.size()};
+        if (size == 0) return 0;
+        while (node < size) {
+            node = 2 * node + (less(eytzinger[node], key) ? 1 : 0);
+        }
+        // undo the right turns taken after the last left turn
+        while (node & 1) node >>= 1;
+        node >>= 1;
+        // no left turn at all: every timestamp is before the key
+        if (node == 0) return size - 1;
+        return eytzingerRank[node];
+    }
+
+public:
+    // default constructor - empty index, allocates nothing until built
+    TimestampIndex() {}
+
+    // build index over non-decreasing timestamps
+    void build(const std::vector<unsigned>& sortedTimestamps) {
+        eytzinger.assign(sortedTimestamps.size() + 1, 0);
+        eytzingerRank.assign(sortedTimestamps.size() + 1, 0);
+        fillEytzinger(sortedTimestamps, 0, 1);
+    }
+
+    // access function
+    std::size_t getSize() const { return this->eytzinger.empty() ? 0 : this->eytzinger.size() - 1; }
+
+    // rank of first timestamp >= startTime
+    std::size_t lowerBound(const unsigned& startTime) const {
+        return search(startTime, [](const unsigned& a, const unsigned& b) { return a < b; });
+    }
+
+    // rank of first timestamp > endTime
+    std::size_t upperBound(const unsigned& endTime) const {
+        return search(endTime, [](const unsigned& a, const unsigned& b) { return a <= b; });
+    }
+
+    // approximate heap memory held by the index in bytes
+    std::size_t getMemoryUsage() const {
+        return eytzinger.capacity() * sizeof(unsigned)
+             + eytzingerRank.capacity() * sizeof(std::size_t);
+    }
+};
+
+#endif /* TIMESTAMP_INDEX_HPP */
@@ -0,0 +1,123 @@
+#include <sstream> // stringstream
+#include <iomanip> // setprecision
+
+#include "trace.hpp" // hot path tracing
+#include "msg.hpp"   // classes managing outputs
+
+/* ------------------------------------------------------------------------
+* DEFINE TRACE BUFFER CLASS
+* -----------------------------------------------------------------------*/
+
+const std::size_t TraceBuffer::capacity{65536};
+
+// parametrised constructor
+TraceBuffer::TraceBuffer(const unsigned& userThreadNo)
+    : threadNo{userThreadNo}, events(capacity), noOfRecorded{0} {
+    DebugMsg::print("[TRACE-BUFFER] Parametrised constructor called\n");
+}
+
+// return kept spans, oldest first
+std::vector<TraceEvent> TraceBuffer::getEvents() const {
+    std::uint64_t noOfEvents{noOfRecorded.load(std::memory_order_acquire)};
+    if (noOfEvents <= capacity) {
+        return std::vector<TraceEvent>(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(noOfEvents));
+    }
+    std::size_t oldest{static_cast<std::size_t>(noOfEvents % capacity)};
+    std::vector<TraceEvent> ordered(events.begin() + static_cast<std::ptrdiff_t>(oldest), events.end());
+    ordered.insert(ordered.end(), events.begin(), events.begin() + static_cast<std::ptrdiff_t>(oldest));
+    return ordered;
+}
+
+// return number of spans overwritten
+std::uint64_t TraceBuffer::getNoOfDropped() const {
+    std::uint64_t noOfEvents{noOfRecorded.load(std::memory_order_acquire)};
+    return noOfEvents > capacity ? noOfEvents - capacity : 0;
+}
+
+/* ------------------------------------------------------------------------
+* DEFINE TRACE CLASS
+* -----------------------------------------------------------------------*/
+
+std::atomic<bool> Trace::enabled{false};
+std::atomic<unsigned> Trace::generation{0};
+std::chrono::steady_clock::time_point Trace::origin{std::chrono::steady_clock::now()};
+std::mutex Trace::buffersMutex;
+std::vector<std::shared_ptr<TraceBuffer>> Trace::buffers;
+
+// return buffer of the calling thread
+TraceBuffer& Trace::getThreadBuffer() {
+    static thread_local std::shared_ptr<TraceBuffer> threadBuffer;
+    static thread_local unsigned threadGeneration{};
+    // the buffer of an earlier trace is replaced, so the mutex is only
+    // taken once per thread and trace
+    unsigned currentGeneration{generation.load(std::memory_order_acquire)};
+    if (!threadBuffer || threadGeneration != currentGeneration) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        threadBuffer = std::make_shared<TraceBuffer>(static_cast<unsigned>(buffers.size()));
+        buffers.push_back(threadBuffer);
+        threadGeneration = currentGeneration;
+    }
+    return *threadBuffer;
+}
+
+// start tracing
+void Trace::start() {
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.clear();
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    origin = std::chrono::steady_clock::now();
+    enabled.store(true, std::memory_order_release);
+}
+
+// stop tracing
+void Trace::stop() {
+    enabled.store(false, std::memory_order_release);
+}
+
+// return nanoseconds since tracing was started
+std::uint64_t Trace::getNow() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+}
+
+// record span of the calling thread
+void Trace::record(const char* name, const char* category, const std::uint64_t& start,
+                   const std::uint64_t& end) {
+    getThreadBuffer().record(TraceEvent{name, category, start, end - start});
+}
+
+// return spans of all threads as trace-event JSON
+std::string Trace::toJson() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    std::ostringstream stringStream;
+    std::uint64_t noOfDropped{};
+    stringStream << "{\"traceEvents\": [" << std::endl << std::fixed << std::setprecision(3);
+    bool first{true};
+    for (auto buffer = buffers.begin(); buffer != buffers.end(); ++buffer) {
+        unsigned threadNo{(*buffer)->getThreadNo()};
+        noOfDropped += (*buffer)->getNoOfDropped();
+        stringStream << (first ? "" : ",\n")
+                     << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << threadNo
+                     << ", \"args\": {\"name\": \"thread " << threadNo << "\"}}";
+        first = false;
+        std::vector<TraceEvent> events{(*buffer)->getEvents()};
+        for (auto it = events.begin(); it != events.end(); ++it) {
+            // complete events, times in microseconds
+            stringStream << ",\n{\"name\": \"" << it->name << "\", \"cat\": \"" << it->category
+                         << "\", \"ph\": \"X\", \"ts\": " << it->start / 1000.0
+                         << ", \"dur\": " << it->duration / 1000.0
+                         << ", \"pid\": 1, \"tid\": " << threadNo << "}";
+        }
+    }
+    stringStream << std::endl << "]," << std::endl
+                 << "\"displayTimeUnit\": \"ms\"," << std::endl
+                 << "\"otherData\": {\"droppedEvents\": " << noOfDropped << "}}" << std::endl;
+    return stringStream.str();
+}
+
+// write trace-event JSON to file
+bool Trace::write(const std::string& fileName) {
+    return FileMsg::print(toJson(), fileName);
+}
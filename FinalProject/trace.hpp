@@ -0,0 +1,111 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string>  // string
+#include <vector>  // vector
+#include <memory>  // shared_ptr
+#include <atomic>  // atomic
+#include <mutex>   // mutex
+#include <chrono>  // steady_clock
+#include <cstdint> // fixed width integers
+
+/* ------------------------------------------------------------------------
+* HOT PATH TRACING
+* -----------------------------------------------------------------------*/
+
+// one finished span, times in nanoseconds since the trace was started
+struct TraceEvent {
+    // string literals
+    const char* name;
+    const char* category;
+    std::uint64_t start;
+    std::uint64_t duration;
+};
+
+// Ring buffer of the spans of one thread, which alone records into it; the
+// oldest spans are overwritten once it is full. Read after the traced work
+// is done.
+class TraceBuffer {
+private:
+    unsigned threadNo;
+    std::vector<TraceEvent> events;
+    std::atomic<std::uint64_t> noOfRecorded;
+
+public:
+    // spans kept per thread
+    static const std::size_t capacity;
+
+    // parametrised constructor - buffer of the threadNo-th traced thread
+    explicit TraceBuffer(const unsigned& userThreadNo);
+
+    // append span, called by the owning thread only
+    void record(const TraceEvent& event) {
+        std::uint64_t position{noOfRecorded.load(std::memory_order_relaxed)};
+        events[position % capacity] = event;
+        noOfRecorded.store(position + 1, std::memory_order_release);
+    }
+
+    // return kept spans, oldest first
+    std::vector<TraceEvent> getEvents() const;
+    // return number of spans overwritten
+    std::uint64_t getNoOfDropped() const;
+    unsigned getThreadNo() const { return this->threadNo; }
+};
+
+// Collects the spans of all threads while tracing is on and writes them as
+// Chrome trace-event JSON, which chrome://tracing and Perfetto open, e.g.
+//   datahero --type double --input sim_double --report all --trace load.json
+// Spans are only timed while tracing is on, so they cost a relaxed atomic
+// load otherwise.
+class Trace {
+private:
+    static std::atomic<bool> enabled;
+    // number of traces started
+    static std::atomic<unsigned> generation;
+    static std::chrono::steady_clock::time_point origin;
+    // buffers of all threads that recorded a span, kept after they exit
+    static std::mutex buffersMutex;
+    static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+
+    // return buffer of the calling thread, created on first use
+    static TraceBuffer& getThreadBuffer();
+
+public:
+    // start tracing, dropping spans of an earlier trace
+    static void start();
+    // stop tracing
+    static void stop();
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    // return nanoseconds since tracing was started
+    static std::uint64_t getNow();
+    // record span of the calling thread
+    static void record(const char* name, const char* category, const std::uint64_t& start,
+                       const std::uint64_t& end);
+    // return spans of all threads as trace-event JSON
+    static std::string toJson();
+    // write trace-event JSON to file, return false if it could not be written
+    static bool write(const std::string& fileName);
+};
+
+// span timing the scope it is declared in while tracing is on; name and
+// category are string literals, e.g. "Experiment::readFromFile" and "read"
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    std::uint64_t start;
+    bool active;
+
+public:
+    TraceSpan(const char* userName, const char* userCategory)
+             : name{userName}, category{userCategory}, start{}, active{Trace::isEnabled()} {
+        if (active) start = Trace::getNow();
+    }
+    ~TraceSpan() {
+        if (active) Trace::record(name, category, start, Trace::getNow());
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#endif /* TRACE_HPP */